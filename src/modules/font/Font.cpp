@@ -54,6 +54,18 @@ Rasterizer *Font::newTrueTypeRasterizer(int size, float dpiscale, TrueTypeRaster
 	return newTrueTypeRasterizer(data.get(), size, dpiscale, hinting);
 }
 
+Rasterizer *Font::newDistanceFieldRasterizer(int size, int spread)
+{
+	StrongRef<DefaultFontData> data(new DefaultFontData, Acquire::NORETAIN);
+	return newDistanceFieldRasterizer(data.get(), size, spread);
+}
+
+Rasterizer *Font::newDistanceFieldRasterizer(int size, int spread, float dpiscale)
+{
+	StrongRef<DefaultFontData> data(new DefaultFontData, Acquire::NORETAIN);
+	return newDistanceFieldRasterizer(data.get(), size, spread, dpiscale);
+}
+
 Rasterizer *Font::newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale)
 {
 	return new BMFontRasterizer(fontdef, images, dpiscale);
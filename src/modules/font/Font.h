@@ -52,6 +52,11 @@ public:
 	virtual Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, TrueTypeRasterizer::Hinting hinting) = 0;
 	virtual Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, float dpiscale, TrueTypeRasterizer::Hinting hinting) = 0;
 
+	virtual Rasterizer *newDistanceFieldRasterizer(int size, int spread);
+	virtual Rasterizer *newDistanceFieldRasterizer(int size, int spread, float dpiscale);
+	virtual Rasterizer *newDistanceFieldRasterizer(love::Data *data, int size, int spread) = 0;
+	virtual Rasterizer *newDistanceFieldRasterizer(love::Data *data, int size, int spread, float dpiscale) = 0;
+
 	virtual Rasterizer *newBMFontRasterizer(love::filesystem::FileData *fontdef, const std::vector<image::ImageData *> &images, float dpiscale);
 
 	virtual Rasterizer *newImageRasterizer(love::image::ImageData *data, const std::string &glyphs, int extraspacing, float dpiscale);
@@ -102,6 +102,11 @@ float Rasterizer::getKerning(uint32 /*leftglyph*/, uint32 /*rightglyph*/) const
 	return 0.0f;
 }
 
+int Rasterizer::getDistanceFieldSpread() const
+{
+	return 0;
+}
+
 float Rasterizer::getDPIScale() const
 {
 	return dpiScale;
@@ -120,6 +120,12 @@ public:
 
 	virtual DataType getDataType() const = 0;
 
+	/**
+	 * Gets the distance in pixels covered by the signed distance field in
+	 * each glyph's alpha channel, or 0 if glyphs contain regular coverage.
+	 **/
+	virtual int getDistanceFieldSpread() const;
+
 	float getDPIScale() const;
 
 protected:
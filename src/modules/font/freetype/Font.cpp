@@ -71,6 +71,26 @@ Rasterizer *Font::newTrueTypeRasterizer(love::Data *data, int size, float dpisca
 	return new TrueTypeRasterizer(library, data, size, dpiscale, hinting);
 }
 
+Rasterizer *Font::newDistanceFieldRasterizer(love::Data *data, int size, int spread)
+{
+	float dpiscale = 1.0f;
+	auto window = Module::getInstance<window::Window>(Module::M_WINDOW);
+	if (window != nullptr)
+		dpiscale = window->getDPIScale();
+
+	return newDistanceFieldRasterizer(data, size, spread, dpiscale);
+}
+
+Rasterizer *Font::newDistanceFieldRasterizer(love::Data *data, int size, int spread, float dpiscale)
+{
+	if (spread <= 0)
+		throw love::Exception("Invalid distance field spread: %d", spread);
+
+	// Hinting distorts outlines to fit the pixel grid at one size, which
+	// doesn't make sense for glyphs that are meant to be drawn at any scale.
+	return new TrueTypeRasterizer(library, data, size, dpiscale, TrueTypeRasterizer::HINTING_NONE, spread);
+}
+
 const char *Font::getName() const
 {
 	return "love.font.freetype";
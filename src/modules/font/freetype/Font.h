@@ -48,6 +48,9 @@ public:
 	Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, TrueTypeRasterizer::Hinting hinting) override;
 	Rasterizer *newTrueTypeRasterizer(love::Data *data, int size, float dpiscale, TrueTypeRasterizer::Hinting hinting) override;
 
+	Rasterizer *newDistanceFieldRasterizer(love::Data *data, int size, int spread) override;
+	Rasterizer *newDistanceFieldRasterizer(love::Data *data, int size, int spread, float dpiscale) override;
+
 	// Implement Module
 	const char *getName() const override;
 
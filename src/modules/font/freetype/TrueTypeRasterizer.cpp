@@ -25,6 +25,11 @@
 // C
 #include <math.h>
 
+// C++
+#include <vector>
+#include <limits>
+#include <algorithm>
+
 namespace love
 {
 namespace font
@@ -32,9 +37,81 @@ namespace font
 namespace freetype
 {
 
-TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting)
+// One-dimensional squared Euclidean distance transform (Felzenszwalb and
+// Huttenlocher), applied in place to every stride'th element of f.
+static void distanceTransform1D(float *f, int n, int stride, std::vector<float> &d, std::vector<int> &v, std::vector<float> &z)
+{
+	const float inf = std::numeric_limits<float>::infinity();
+
+	int k = 0;
+	v[0] = 0;
+	z[0] = -inf;
+	z[1] = inf;
+
+	for (int q = 1; q < n; q++)
+	{
+		float fq = f[q * stride];
+		if (fq == inf)
+			continue;
+
+		while (true)
+		{
+			int p = v[k];
+			float s = ((fq + q * q) - (f[p * stride] + p * p)) / (2.0f * (q - p));
+
+			if (f[p * stride] == inf || s <= z[k])
+			{
+				if (k == 0)
+				{
+					v[0] = q;
+					break;
+				}
+				k--;
+				continue;
+			}
+
+			k++;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = inf;
+			break;
+		}
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < q)
+			k++;
+
+		int p = v[k];
+		d[q] = f[p * stride] == inf ? inf : (q - p) * (q - p) + f[p * stride];
+	}
+
+	for (int q = 0; q < n; q++)
+		f[q * stride] = d[q];
+}
+
+// Replaces every element of grid with the squared distance to the nearest
+// element that's 0.
+static void distanceTransform2D(std::vector<float> &grid, int w, int h)
+{
+	int n = std::max(w, h);
+	std::vector<float> d(n);
+	std::vector<int> v(n);
+	std::vector<float> z(n + 1);
+
+	for (int x = 0; x < w; x++)
+		distanceTransform1D(&grid[x], h, w, d, v, z);
+
+	for (int y = 0; y < h; y++)
+		distanceTransform1D(&grid[y * w], w, 1, d, v, z);
+}
+
+TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting, int distancefieldspread)
 	: data(data)
 	, hinting(hinting)
+	, distanceFieldSpread(std::max(distancefieldspread, 0))
 {
 	this->dpiScale = dpiscale;
 	size = floorf(size * dpiscale + 0.5f);
@@ -77,6 +154,8 @@ int TrueTypeRasterizer::getLineHeight() const
 
 GlyphData *TrueTypeRasterizer::getGlyphData(uint32 glyph) const
 {
+	love::thread::Lock lock(mutex);
+
 	love::font::GlyphMetrics glyphMetrics = {};
 	FT_Glyph ftglyph;
 
@@ -113,6 +192,29 @@ GlyphData *TrueTypeRasterizer::getGlyphData(uint32 glyph) const
 	glyphMetrics.width = bitmap.width;
 	glyphMetrics.advance = (int) (ftglyph->advance.x >> 16);
 
+	if (distanceFieldSpread > 0 && bitmap.width > 0 && bitmap.rows > 0)
+	{
+		std::vector<uint8> coverage(bitmap.width * bitmap.rows);
+		const uint8 *pixels = bitmap.buffer;
+
+		for (int y = 0; y < (int) bitmap.rows; y++)
+		{
+			for (int x = 0; x < (int) bitmap.width; x++)
+			{
+				uint8 v = pixels[x];
+				if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+					v = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
+
+				coverage[y * bitmap.width + x] = v;
+			}
+
+			pixels += bitmap.pitch;
+		}
+
+		FT_Done_Glyph(ftglyph);
+		return newDistanceFieldGlyphData(glyph, glyphMetrics, coverage);
+	}
+
 	GlyphData *glyphData = new GlyphData(glyph, glyphMetrics, PIXELFORMAT_LA8);
 
 	const uint8 *pixels = bitmap.buffer;
@@ -160,6 +262,79 @@ GlyphData *TrueTypeRasterizer::getGlyphData(uint32 glyph) const
 	return glyphData;
 }
 
+GlyphData *TrueTypeRasterizer::newDistanceFieldGlyphData(uint32 glyph, const GlyphMetrics &metrics, const std::vector<uint8> &coverage) const
+{
+	int spread = distanceFieldSpread;
+
+	// The field extends past the outline, so the glyph image grows too.
+	GlyphMetrics gm = metrics;
+	gm.width = metrics.width + spread * 2;
+	gm.height = metrics.height + spread * 2;
+	gm.bearingX = metrics.bearingX - spread;
+	gm.bearingY = metrics.bearingY + spread;
+
+	int w = gm.width;
+	int h = gm.height;
+
+	auto getcoverage = [&](int x, int y) -> int
+	{
+		x -= spread;
+		y -= spread;
+		if (x < 0 || y < 0 || x >= metrics.width || y >= metrics.height)
+			return 0;
+		return coverage[y * metrics.width + x];
+	};
+
+	const float inf = std::numeric_limits<float>::infinity();
+
+	// Squared distances from outside pixels to the nearest inside pixel, and
+	// vice versa.
+	std::vector<float> outside(w * h);
+	std::vector<float> inside(w * h);
+
+	for (int y = 0; y < h; y++)
+	{
+		for (int x = 0; x < w; x++)
+		{
+			bool in = getcoverage(x, y) >= 128;
+			outside[y * w + x] = in ? 0.0f : inf;
+			inside[y * w + x] = in ? inf : 0.0f;
+		}
+	}
+
+	distanceTransform2D(outside, w, h);
+	distanceTransform2D(inside, w, h);
+
+	GlyphData *glyphData = new GlyphData(glyph, gm, PIXELFORMAT_LA8);
+	uint8 *dest = (uint8 *) glyphData->getData();
+
+	for (int y = 0; y < h; y++)
+	{
+		for (int x = 0; x < w; x++)
+		{
+			int c = getcoverage(x, y);
+			float dist = 0.0f;
+
+			// Anti-aliased edge pixels give a sub-pixel distance estimate.
+			if (c > 0 && c < 255)
+				dist = 0.5f - c / 255.0f;
+			else if (c >= 128)
+				dist = -(sqrtf(inside[y * w + x]) - 0.5f);
+			else
+				dist = sqrtf(outside[y * w + x]) - 0.5f;
+
+			// The outline is at 0.5, and alpha increases towards the inside.
+			float v = 0.5f - dist / (2.0f * spread);
+			v = std::min(std::max(v, 0.0f), 1.0f);
+
+			dest[2 * (y * w + x) + 0] = 255;
+			dest[2 * (y * w + x) + 1] = (uint8) (v * 255.0f + 0.5f);
+		}
+	}
+
+	return glyphData;
+}
+
 int TrueTypeRasterizer::getGlyphCount() const
 {
 	return (int) face->num_glyphs;
@@ -167,11 +342,14 @@ int TrueTypeRasterizer::getGlyphCount() const
 
 bool TrueTypeRasterizer::hasGlyph(uint32 glyph) const
 {
+	love::thread::Lock lock(mutex);
 	return FT_Get_Char_Index(face, glyph) != 0;
 }
 
 float TrueTypeRasterizer::getKerning(uint32 leftglyph, uint32 rightglyph) const
 {
+	love::thread::Lock lock(mutex);
+
 	FT_Vector kerning = {};
 	FT_Get_Kerning(face,
 	               FT_Get_Char_Index(face, leftglyph),
@@ -186,6 +364,11 @@ Rasterizer::DataType TrueTypeRasterizer::getDataType() const
 	return DATA_TRUETYPE;
 }
 
+int TrueTypeRasterizer::getDistanceFieldSpread() const
+{
+	return distanceFieldSpread;
+}
+
 bool TrueTypeRasterizer::accepts(FT_Library library, love::Data *data)
 {
 	const FT_Byte *fbase = (const FT_Byte *) data->getData();
@@ -24,6 +24,7 @@
 // LOVE
 #include "filesystem/FileData.h"
 #include "font/TrueTypeRasterizer.h"
+#include "thread/threads.h"
 
 // FreeType2
 #include <ft2build.h>
@@ -44,7 +45,11 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 {
 public:
 
-	TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting);
+	/**
+	 * @param distancefieldspread If greater than 0, glyphs are signed distance
+	 *        fields covering this many pixels on either side of the outline.
+	 **/
+	TrueTypeRasterizer(FT_Library library, love::Data *data, int size, float dpiscale, Hinting hinting, int distancefieldspread = 0);
 	virtual ~TrueTypeRasterizer();
 
 	// Implement Rasterizer
@@ -54,6 +59,7 @@ public:
 	bool hasGlyph(uint32 glyph) const override;
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
+	int getDistanceFieldSpread() const override;
 
 	static bool accepts(FT_Library library, love::Data *data);
 
@@ -61,14 +67,23 @@ private:
 
 	static FT_UInt hintingToLoadOption(Hinting hinting);
 
+	GlyphData *newDistanceFieldGlyphData(uint32 glyph, const GlyphMetrics &metrics, const std::vector<uint8> &coverage) const;
+
 	// TrueType face
 	FT_Face face;
 
+	// FreeType faces can only be used by one thread at a time, and the same
+	// Rasterizer can be used by several Fonts (as a fallback) and by their
+	// background glyph loaders.
+	love::thread::MutexRef mutex;
+
 	// Font data
 	StrongRef<love::Data> data;
 
 	Hinting hinting;
 
+	int distanceFieldSpread;
+
 }; // TrueTypeRasterizer
 
 } // freetype
@@ -126,6 +126,61 @@ int w_newTrueTypeRasterizer(lua_State *L)
 	return 1;
 }
 
+int w_newDistanceFieldRasterizer(lua_State *L)
+{
+	Rasterizer *t = nullptr;
+
+	if (lua_type(L, 1) == LUA_TNUMBER || lua_isnone(L, 1))
+	{
+		// First argument is a number: use the default TrueType font.
+		int size = (int) luaL_optinteger(L, 1, 12);
+		int spread = (int) luaL_optinteger(L, 2, 4);
+
+		if (lua_isnoneornil(L, 3))
+			luax_catchexcept(L, [&](){ t = instance()->newDistanceFieldRasterizer(size, spread); });
+		else
+		{
+			float dpiscale = (float) luaL_checknumber(L, 3);
+			luax_catchexcept(L, [&](){ t = instance()->newDistanceFieldRasterizer(size, spread, dpiscale); });
+		}
+	}
+	else
+	{
+		love::Data *d = nullptr;
+
+		if (luax_istype(L, 1, love::Data::type))
+		{
+			d = data::luax_checkdata(L, 1);
+			d->retain();
+		}
+		else
+			d = filesystem::luax_getfiledata(L, 1);
+
+		int size = (int) luaL_optinteger(L, 2, 12);
+		int spread = (int) luaL_optinteger(L, 3, 4);
+
+		if (lua_isnoneornil(L, 4))
+		{
+			luax_catchexcept(L,
+				[&]() { t = instance()->newDistanceFieldRasterizer(d, size, spread); },
+				[&](bool) { d->release(); }
+			);
+		}
+		else
+		{
+			float dpiscale = (float) luaL_checknumber(L, 4);
+			luax_catchexcept(L,
+				[&]() { t = instance()->newDistanceFieldRasterizer(d, size, spread, dpiscale); },
+				[&](bool) { d->release(); }
+			);
+		}
+	}
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 static void convimagedata(lua_State *L, int idx)
 {
 	if (lua_type(L, 1) == LUA_TSTRING || luax_istype(L, idx, love::filesystem::File::type) || luax_istype(L, idx, love::filesystem::FileData::type))
@@ -217,6 +272,7 @@ static const luaL_Reg functions[] =
 {
 	{ "newRasterizer",  w_newRasterizer },
 	{ "newTrueTypeRasterizer", w_newTrueTypeRasterizer },
+	{ "newDistanceFieldRasterizer", w_newDistanceFieldRasterizer },
 	{ "newBMFontRasterizer", w_newBMFontRasterizer },
 	{ "newImageRasterizer", w_newImageRasterizer },
 	{ "newGlyphData",  w_newGlyphData },
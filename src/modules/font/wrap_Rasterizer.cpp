@@ -124,6 +124,13 @@ int w_Rasterizer_hasGlyphs(lua_State *L)
 	return 1;
 }
 
+int w_Rasterizer_getDistanceFieldSpread(lua_State *L)
+{
+	Rasterizer *t = luax_checkrasterizer(L, 1);
+	lua_pushinteger(L, t->getDistanceFieldSpread());
+	return 1;
+}
+
 const luaL_Reg w_Rasterizer_functions[] =
 {
 	{ "getHeight", w_Rasterizer_getHeight },
@@ -134,6 +141,7 @@ const luaL_Reg w_Rasterizer_functions[] =
 	{ "getGlyphData", w_Rasterizer_getGlyphData },
 	{ "getGlyphCount", w_Rasterizer_getGlyphCount },
 	{ "hasGlyphs", w_Rasterizer_hasGlyphs },
+	{ "getDistanceFieldSpread", w_Rasterizer_getDistanceFieldSpread },
 	{ 0, 0 }
 };
 
@@ -22,6 +22,7 @@
 #include "font/GlyphData.h"
 
 #include "libraries/utf8/utf8.h"
+#include "libraries/xxHash/xxhash.h"
 
 #include "common/math.h"
 #include "common/Matrix.h"
@@ -44,6 +45,8 @@ static inline uint16 normToUint16(double n)
 
 love::Type Font::type("Font", &Object::type);
 int Font::fontCount = 0;
+int64 Font::layoutCacheHits = 0;
+int64 Font::layoutCacheMisses = 0;
 
 const vertex::CommonFormat Font::vertexFormat = vertex::CommonFormat::XYf_STus_RGBAub;
 
@@ -56,10 +59,22 @@ Font::Font(love::font::Rasterizer *r, const Texture::Filter &f)
 	, filter(f)
 	, dpiScale(r->getDPIScale())
 	, useSpacesAsTab(false)
+	, glyphLoader(std::make_shared<GlyphLoader>())
+	, asyncLoading(false)
+	, loadingGlyph()
+	, usedLoadingGlyph(false)
 	, textureCacheID(0)
+	, glyphUseStamp(0)
 {
 	filter.mipmap = Texture::FILTER_NONE;
 
+	// Distance fields are meant to be interpolated.
+	if (isDistanceField())
+		filter.min = filter.mag = Texture::FILTER_LINEAR;
+
+	loadingGlyph.page = -1;
+	loadingGlyph.shelf = -1;
+
 	// Try to find the best texture size match for the font size. default to the
 	// largest texture size if no rough match is found.
 	while (true)
@@ -83,12 +98,20 @@ Font::Font(love::font::Rasterizer *r, const Texture::Filter &f)
 	if (!r->hasGlyph(9)) // No tab character in the Rasterizer.
 		useSpacesAsTab = true;
 
+	glyphLoader->rasterizers = rasterizers;
+	glyphLoader->useSpacesAsTab = useSpacesAsTab;
+
 	loadVolatile();
 	++fontCount;
 }
 
 Font::~Font()
 {
+	{
+		love::thread::Lock lock(glyphLoader->queueMutex);
+		glyphLoader->cancelled = true;
+	}
+
 	--fontCount;
 }
 
@@ -123,78 +146,260 @@ bool Font::loadVolatile()
 {
 	textureCacheID++;
 	glyphs.clear();
-	images.clear();
-	createTexture();
+	pages.clear();
+	createTexture({textureWidth, textureHeight});
 	return true;
 }
 
-void Font::createTexture()
+void Font::createTexture(const TextureSize &size)
 {
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	gfx->flushStreamDraws();
 
-	Image *image = nullptr;
-	TextureSize size = {textureWidth, textureHeight};
-	TextureSize nextsize = getNextTextureSize();
-	bool recreatetexture = false;
+	Image::Settings settings;
+	Image *image = gfx->newImage(TEXTURE_2D, pixelFormat, size.width, size.height, 1, settings);
+	image->setFilter(filter);
+
+	TexturePage page;
+	page.image.set(image, Acquire::NORETAIN);
+	page.width = size.width;
+	page.height = size.height;
+	page.nextShelfY = TEXTURE_PADDING;
+	page.version = 1;
+
+	// Initialize the texture with transparent black.
+	clearTexture(image, {0, 0, size.width, size.height});
+
+	pages.push_back(page);
+
+	textureWidth  = size.width;
+	textureHeight = size.height;
+}
+
+void Font::clearTexture(Image *image, const Rect &rect)
+{
+	size_t bpp = getPixelFormatSize(pixelFormat);
+	std::vector<uint8> emptydata(rect.w * rect.h * bpp, 0);
 
-	// If we have an existing texture already, we'll try replacing it with a
-	// larger-sized one rather than creating a second one. Having a single
-	// texture reduces texture switches and draw calls when rendering.
-	if ((nextsize.width > size.width || nextsize.height > size.height) && !images.empty())
+	image->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
+}
+
+int Font::addShelf(int pageindex, int height)
+{
+	TexturePage &page = pages[pageindex];
+
+	Shelf shelf;
+	shelf.y = page.nextShelfY;
+	shelf.height = height;
+	shelf.x = TEXTURE_PADDING;
+	shelf.lastUsed = glyphUseStamp;
+
+	page.nextShelfY += height;
+	page.shelves.push_back(shelf);
+
+	return (int) page.shelves.size() - 1;
+}
+
+void Font::evictShelf(int pageindex, int shelfindex)
+{
+	TexturePage &page = pages[pageindex];
+	Shelf &shelf = page.shelves[shelfindex];
+
+	for (uint32 g : shelf.glyphs)
+		glyphs.erase(g);
+
+	shelf.glyphs.clear();
+	shelf.x = TEXTURE_PADDING;
+
+	// Old glyph pixels would otherwise show up in the padding of new ones.
+	clearTexture(page.image, {0, shelf.y, page.width, shelf.height});
+
+	page.version++;
+}
+
+void Font::evictPage(int pageindex)
+{
+	TexturePage &page = pages[pageindex];
+
+	for (const Shelf &shelf : page.shelves)
 	{
-		recreatetexture = true;
-		size = nextsize;
-		images.pop_back();
+		for (uint32 g : shelf.glyphs)
+			glyphs.erase(g);
 	}
 
-	Image::Settings settings;
-	image = gfx->newImage(TEXTURE_2D, pixelFormat, size.width, size.height, 1, settings);
-	image->setFilter(filter);
+	page.shelves.clear();
+	page.nextShelfY = TEXTURE_PADDING;
+
+	clearTexture(page.image, {0, 0, page.width, page.height});
+
+	page.version++;
+}
+
+void Font::allocateGlyphSpace(int w, int h, int &pageindex, int &shelfindex)
+{
+	// Rounding shelf heights up lets glyphs of similar sizes share shelves.
+	int shelfheight = ((h + TEXTURE_PADDING + 3) / 4) * 4;
+	int maxheight = shelfheight + shelfheight / 2;
+
+	auto fitspage = [&](const TexturePage &page) -> bool
+	{
+		return w + TEXTURE_PADDING * 2 <= page.width && shelfheight + TEXTURE_PADDING <= page.height;
+	};
+
+	// The shortest existing shelf with room for the glyph, ignoring ones
+	// which would waste too much space when allowwaste is false.
+	auto findshelf = [&](bool allowwaste) -> bool
+	{
+		int bestheight = std::numeric_limits<int>::max();
+
+		for (int p = 0; p < (int) pages.size(); p++)
+		{
+			const TexturePage &page = pages[p];
+
+			for (int i = 0; i < (int) page.shelves.size(); i++)
+			{
+				const Shelf &shelf = page.shelves[i];
+
+				if (shelf.height < shelfheight || shelf.height >= bestheight)
+					continue;
 
+				if (!allowwaste && shelf.height > maxheight)
+					continue;
+
+				if (shelf.x + w + TEXTURE_PADDING <= page.width)
+				{
+					pageindex = p;
+					shelfindex = i;
+					bestheight = shelf.height;
+				}
+			}
+		}
+
+		return bestheight != std::numeric_limits<int>::max();
+	};
+
+	if (findshelf(false))
+		return;
+
+	// Start a new shelf in the first page with room left.
+	for (int p = 0; p < (int) pages.size(); p++)
 	{
-		// Initialize the texture with transparent black.
-		size_t bpp = getPixelFormatSize(pixelFormat);
-		std::vector<uint8> emptydata(size.width * size.height * bpp, 0);
+		const TexturePage &page = pages[p];
 
-		Rect rect = {0, 0, size.width, size.height};
-		image->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
+		if (fitspage(page) && page.nextShelfY + shelfheight <= page.height)
+		{
+			pageindex = p;
+			shelfindex = addShelf(p, shelfheight);
+			return;
+		}
 	}
 
-	images.emplace_back(image, Acquire::NORETAIN);
+	if (findshelf(true))
+		return;
 
-	textureWidth  = size.width;
-	textureHeight = size.height;
+	if ((int) pages.size() >= MAX_TEXTURE_PAGES)
+	{
+		// Evict the least recently used shelf the glyph fits in. Shelves used
+		// by the text currently being laid out are left alone.
+		uint64 oldest = glyphUseStamp;
+
+		for (int p = 0; p < (int) pages.size(); p++)
+		{
+			const TexturePage &page = pages[p];
+
+			if (!fitspage(page))
+				continue;
+
+			for (int i = 0; i < (int) page.shelves.size(); i++)
+			{
+				const Shelf &shelf = page.shelves[i];
+
+				if (shelf.lastUsed < oldest && shelf.height >= shelfheight)
+				{
+					pageindex = p;
+					shelfindex = i;
+					oldest = shelf.lastUsed;
+				}
+			}
+		}
+
+		if (oldest != glyphUseStamp)
+		{
+			evictShelf(pageindex, shelfindex);
+			return;
+		}
+
+		// No shelf is tall enough, so empty the least recently used page.
+		for (int p = 0; p < (int) pages.size(); p++)
+		{
+			const TexturePage &page = pages[p];
+
+			if (!fitspage(page))
+				continue;
+
+			uint64 lastused = 0;
+			for (const Shelf &shelf : page.shelves)
+				lastused = std::max(lastused, shelf.lastUsed);
+
+			if (lastused < oldest)
+			{
+				pageindex = p;
+				oldest = lastused;
+			}
+		}
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+		if (oldest != glyphUseStamp)
+		{
+			evictPage(pageindex);
+			shelfindex = addShelf(pageindex, shelfheight);
+			return;
+		}
 
-	// Re-add the old glyphs if we re-created the existing texture object.
-	if (recreatetexture)
+		// Everything is in use by the current text, so we have to go over the
+		// page limit.
+	}
+
+	TextureSize size = {textureWidth, textureHeight};
+	if (!pages.empty())
+		size = getNextTextureSize();
+
+	while (w + TEXTURE_PADDING * 2 > size.width || shelfheight + TEXTURE_PADDING > size.height)
 	{
-		textureCacheID++;
+		textureWidth = size.width;
+		textureHeight = size.height;
 
-		std::vector<uint32> glyphstoadd;
+		TextureSize nextsize = getNextTextureSize();
 
-		for (const auto &glyphpair : glyphs)
-			glyphstoadd.push_back(glyphpair.first);
+		if (nextsize.width <= size.width && nextsize.height <= size.height)
+		{
+			textureWidth = pages.empty() ? size.width : pages.back().width;
+			textureHeight = pages.empty() ? size.height : pages.back().height;
+			throw love::Exception("Font glyph is too large to fit in a texture.");
+		}
 
-		glyphs.clear();
-		
-		for (uint32 g : glyphstoadd)
-			addGlyph(g);
+		size = nextsize;
 	}
+
+	createTexture(size);
+
+	pageindex = (int) pages.size() - 1;
+	shelfindex = addShelf(pageindex, shelfheight);
 }
 
 void Font::unloadVolatile()
 {
 	glyphs.clear();
-	images.clear();
+	pages.clear();
 }
 
-love::font::GlyphData *Font::getRasterizerGlyphData(uint32 glyph)
+love::font::GlyphData *Font::loadGlyphData(GlyphLoader &loader, uint32 glyph)
 {
+	love::thread::Lock lock(loader.rasterizerMutex);
+
+	const auto &rasterizers = loader.rasterizers;
+
 	// Use spaces for the tab 'glyph'.
-	if (glyph == 9 && useSpacesAsTab)
+	if (glyph == 9 && loader.useSpacesAsTab)
 	{
 		love::font::GlyphData *spacegd = rasterizers[0]->getGlyphData(32);
 		PixelFormat fmt = spacegd->getFormat();
@@ -218,52 +423,86 @@ love::font::GlyphData *Font::getRasterizerGlyphData(uint32 glyph)
 	return rasterizers[0]->getGlyphData(glyph);
 }
 
-const Font::Glyph &Font::addGlyph(uint32 glyph)
+void Font::loadQueuedGlyphs(GlyphLoader &loader)
 {
-	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyph), Acquire::NORETAIN);
-
-	int w = gd->getWidth();
-	int h = gd->getHeight();
-
-	if (w + TEXTURE_PADDING * 2 < textureWidth && h + TEXTURE_PADDING * 2 < textureHeight)
+	while (true)
 	{
-		if (textureX + w + TEXTURE_PADDING > textureWidth)
+		uint32 glyph = 0;
+
 		{
-			// Out of space - new row!
-			textureX = TEXTURE_PADDING;
-			textureY += rowHeight;
-			rowHeight = TEXTURE_PADDING;
+			love::thread::Lock lock(loader.queueMutex);
+
+			if (loader.cancelled || loader.queued.empty())
+			{
+				loader.running = false;
+				return;
+			}
+
+			glyph = loader.queued.front();
+			loader.queued.pop_front();
 		}
 
-		if (textureY + h + TEXTURE_PADDING > textureHeight)
-		{
-			// Totally out of space - new texture!
-			createTexture();
+		love::font::GlyphData *gd = nullptr;
 
-			// Makes sure the above code for checking if the glyph can fit at
-			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyph);
+		try
+		{
+			gd = loadGlyphData(loader, glyph);
+		}
+		catch (love::Exception &)
+		{
+			// addLoadedGlyphs loads the glyph again on the main thread, which
+			// reports the error.
+			love::thread::Lock lock(loader.queueMutex);
+			loader.failed.push_back(glyph);
+			continue;
 		}
+
+		love::thread::Lock lock(loader.queueMutex);
+		loader.loaded.emplace_back(gd, Acquire::NORETAIN);
 	}
+}
+
+love::font::GlyphData *Font::getRasterizerGlyphData(uint32 glyph)
+{
+	return loadGlyphData(*glyphLoader, glyph);
+}
+
+const Font::Glyph &Font::addGlyph(uint32 glyph)
+{
+	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyph), Acquire::NORETAIN);
+	return addGlyph(glyph, gd);
+}
+
+const Font::Glyph &Font::addGlyph(uint32 glyph, love::font::GlyphData *gd)
+{
+	int w = gd->getWidth();
+	int h = gd->getHeight();
 
 	Glyph g;
 
 	g.texture = 0;
 	g.spacing = floorf(gd->getAdvance() / dpiScale + 0.5f);
+	g.page = -1;
+	g.shelf = -1;
 
 	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
 
 	// Don't waste space for empty glyphs.
 	if (w > 0 && h > 0)
 	{
-		Image *image = images.back();
+		allocateGlyphSpace(w, h, g.page, g.shelf);
+
+		TexturePage &page = pages[g.page];
+		Shelf &shelf = page.shelves[g.shelf];
+
+		Image *image = page.image;
 		g.texture = image;
 
-		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
+		Rect rect = {shelf.x, shelf.y, gd->getWidth(), gd->getHeight()};
 		image->replacePixels(gd->getData(), gd->getSize(), 0, 0, rect, false);
 
-		double tX     = (double) textureX,     tY      = (double) textureY;
-		double tWidth = (double) textureWidth, tHeight = (double) textureHeight;
+		double tX     = (double) shelf.x,    tY      = (double) shelf.y;
+		double tWidth = (double) page.width, tHeight = (double) page.height;
 
 		Color c(255, 255, 255, 255);
 
@@ -291,8 +530,9 @@ const Font::Glyph &Font::addGlyph(uint32 glyph)
 			g.vertices[i].y -= gd->getBearingY() / dpiScale;
 		}
 
-		textureX += w + TEXTURE_PADDING;
-		rowHeight = std::max(rowHeight, h + TEXTURE_PADDING);
+		shelf.x += w + TEXTURE_PADDING;
+		shelf.lastUsed = glyphUseStamp;
+		shelf.glyphs.push_back(glyph);
 	}
 
 	glyphs[glyph] = g;
@@ -304,11 +544,131 @@ const Font::Glyph &Font::findGlyph(uint32 glyph)
 	const auto it = glyphs.find(glyph);
 
 	if (it != glyphs.end())
-		return it->second;
+	{
+		const Glyph &g = it->second;
+		if (g.page >= 0)
+			pages[g.page].shelves[g.shelf].lastUsed = glyphUseStamp;
+		return g;
+	}
+
+	if (asyncLoading)
+	{
+		prewarm(Codepoints(1, glyph));
+
+		if (pendingGlyphs.find(glyph) != pendingGlyphs.end())
+		{
+			usedLoadingGlyph = true;
+			return loadingGlyph;
+		}
+	}
 
 	return addGlyph(glyph);
 }
 
+void Font::prewarm(const Codepoints &codepoints)
+{
+	std::vector<uint32> newglyphs;
+
+	for (uint32 g : codepoints)
+	{
+		// Newlines and carriage returns are never drawn.
+		if (g == '\n' || g == '\r')
+			continue;
+
+		if (glyphs.find(g) == glyphs.end() && pendingGlyphs.insert(g).second)
+			newglyphs.push_back(g);
+	}
+
+	if (newglyphs.empty())
+		return;
+
+	bool start = false;
+
+	{
+		love::thread::Lock lock(glyphLoader->queueMutex);
+
+		glyphLoader->queued.insert(glyphLoader->queued.end(), newglyphs.begin(), newglyphs.end());
+
+		if (!glyphLoader->running)
+		{
+			glyphLoader->running = true;
+			start = true;
+		}
+	}
+
+	if (start)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		std::shared_ptr<GlyphLoader> loader = glyphLoader;
+
+		gfx->getWorkerPool()->submit([loader]()
+		{
+			loadQueuedGlyphs(*loader);
+		});
+	}
+}
+
+void Font::setAsyncLoading(bool enable)
+{
+	// Unloaded glyphs take up as much space as a space character.
+	if (enable && !asyncLoading)
+		loadingGlyph.spacing = findGlyph(' ').spacing;
+
+	asyncLoading = enable;
+}
+
+bool Font::isAsyncLoading() const
+{
+	return asyncLoading;
+}
+
+void Font::addLoadedGlyphs()
+{
+	if (pendingGlyphs.empty())
+		return;
+
+	std::vector<StrongRef<love::font::GlyphData>> loaded;
+	std::vector<uint32> failed;
+
+	{
+		love::thread::Lock lock(glyphLoader->queueMutex);
+		loaded.swap(glyphLoader->loaded);
+		failed.swap(glyphLoader->failed);
+	}
+
+	if (loaded.empty() && failed.empty())
+		return;
+
+	// All new glyphs are uploaded together, before anything is laid out.
+	for (const StrongRef<love::font::GlyphData> &gd : loaded)
+	{
+		uint32 g = gd->getGlyph();
+		pendingGlyphs.erase(g);
+
+		if (glyphs.find(g) == glyphs.end())
+			addGlyph(g, gd);
+	}
+
+	for (uint32 g : failed)
+		pendingGlyphs.erase(g);
+
+	// Text which was laid out with placeholders needs to be laid out again.
+	if (usedLoadingGlyph)
+	{
+		textureCacheID++;
+		usedLoadingGlyph = !pendingGlyphs.empty();
+	}
+
+	// Glyphs which failed in the background are loaded again here, so the
+	// error is reported to the caller instead of the glyph being queued again
+	// every time it's used.
+	for (uint32 g : failed)
+	{
+		if (glyphs.find(g) == glyphs.end())
+			addGlyph(g);
+	}
+}
+
 float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
 {
 	uint64 packedglyphs = ((uint64) leftglyph << 32) | (uint64) rightglyph;
@@ -388,6 +748,16 @@ float Font::getHeight() const
 }
 
 std::vector<Font::DrawCommand> Font::generateVertices(const ColoredCodepoints &codepoints, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, TextInfo *info)
+{
+	// Upload any glyphs which finished loading in the background.
+	addLoadedGlyphs();
+
+	glyphUseStamp++;
+
+	return layoutGlyphs(codepoints, constantcolor, vertices, extra_spacing, offset, info);
+}
+
+std::vector<Font::DrawCommand> Font::layoutGlyphs(const ColoredCodepoints &codepoints, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, TextInfo *info)
 {
 	// Spacing counter and newline handling.
 	float dx = offset.x;
@@ -535,6 +905,10 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const ColoredCode
 {
 	wrap = std::max(wrap, 0.0f);
 
+	addLoadedGlyphs();
+
+	glyphUseStamp++;
+
 	uint32 cacheid = textureCacheID;
 
 	std::vector<DrawCommand> drawcommands;
@@ -580,7 +954,7 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const ColoredCode
 				break;
 		}
 
-		std::vector<DrawCommand> newcommands = generateVertices(line, constantcolor, vertices, extraspacing, offset);
+		std::vector<DrawCommand> newcommands = layoutGlyphs(line, constantcolor, vertices, extraspacing, offset, nullptr);
 
 		if (!newcommands.empty())
 		{
@@ -635,6 +1009,7 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 		streamcmd.indexMode = vertex::TriangleIndexMode::QUADS;
 		streamcmd.vertexCount = cmd.vertexcount;
 		streamcmd.texture = cmd.texture;
+		streamcmd.standardShaderType = getStandardShaderType();
 
 		Graphics::StreamVertexData data = gfx->requestStreamDraw(streamcmd);
 		GlyphVertex *vertexdata = (GlyphVertex *) data.stream[0];
@@ -644,26 +1019,138 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 	}
 }
 
-void Font::print(graphics::Graphics *gfx, const std::vector<ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
+bool Font::isLayoutValid(const LayoutCacheEntry &entry, const std::vector<ColoredString> &text, float wrap, AlignMode align, const Colorf &constantcolor) const
 {
-	ColoredCodepoints codepoints;
-	getCodepointsFromString(text, codepoints);
+	if (entry.textureCacheID != textureCacheID)
+		return false;
+
+	// Glyphs used by the layout may have been evicted from their texture.
+	for (const auto &version : entry.textureVersions)
+	{
+		if (getTextureVersion(version.first) != version.second)
+			return false;
+	}
+
+	// Different text can have the same hash.
+	if (entry.wrap != wrap || entry.align != align || entry.color != constantcolor)
+		return false;
+
+	if (entry.text.size() != text.size())
+		return false;
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVertices(codepoints, constantcolor, vertices);
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		if (entry.text[i].color != text[i].color || entry.text[i].str != text[i].str)
+			return false;
+	}
 
-	printv(gfx, m, drawcommands, vertices);
+	return true;
 }
 
-void Font::printf(graphics::Graphics *gfx, const std::vector<ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
+const Font::LayoutCacheEntry &Font::getLayout(const std::vector<ColoredString> &text, float wrap, AlignMode align, const Colorf &constantcolor)
 {
+	// Glyphs which finished loading may replace placeholders in cached text.
+	addLoadedGlyphs();
+
+	uint64 hash = XXH64(&wrap, sizeof(wrap), 0);
+	hash = XXH64(&align, sizeof(align), hash);
+	hash = XXH64(&constantcolor, sizeof(Colorf), hash);
+
+	for (const ColoredString &cstr : text)
+	{
+		hash = XXH64(&cstr.color, sizeof(Colorf), hash);
+		hash = XXH64(cstr.str.data(), cstr.str.size(), hash);
+	}
+
+	auto it = layoutCacheMap.find(hash);
+
+	if (it != layoutCacheMap.end())
+	{
+		if (isLayoutValid(*it->second, text, wrap, align, constantcolor))
+		{
+			layoutCacheHits++;
+			layoutCache.splice(layoutCache.begin(), layoutCache, it->second);
+
+			// The layout is only valid if none of its pages had glyphs
+			// evicted, so its shelf indices still refer to the same shelves.
+			glyphUseStamp++;
+			for (const auto &shelf : layoutCache.front().shelves)
+				pages[shelf.first].shelves[shelf.second].lastUsed = glyphUseStamp;
+
+			return layoutCache.front();
+		}
+
+		layoutCache.erase(it->second);
+		layoutCacheMap.erase(it);
+	}
+
+	layoutCacheMisses++;
+
 	ColoredCodepoints codepoints;
 	getCodepointsFromString(text, codepoints);
 
-	std::vector<GlyphVertex> vertices;
-	std::vector<DrawCommand> drawcommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, vertices);
+	LayoutCacheEntry entry;
+	entry.hash = hash;
+	entry.text = text;
+	entry.wrap = wrap;
+	entry.align = align;
+	entry.color = constantcolor;
+
+	if (align == ALIGN_MAX_ENUM)
+		entry.drawCommands = generateVertices(codepoints, constantcolor, entry.vertices);
+	else
+		entry.drawCommands = generateVerticesFormatted(codepoints, constantcolor, wrap, align, entry.vertices);
 
-	printv(gfx, m, drawcommands, vertices);
+	entry.textureCacheID = textureCacheID;
+
+	for (const DrawCommand &cmd : entry.drawCommands)
+	{
+		auto vit = std::find_if(entry.textureVersions.begin(), entry.textureVersions.end(),
+			[&](const std::pair<const Texture *, uint32> &v) { return v.first == cmd.texture; });
+
+		if (vit == entry.textureVersions.end())
+			entry.textureVersions.emplace_back(cmd.texture, getTextureVersion(cmd.texture));
+	}
+
+	for (uint32 cp : codepoints.cps)
+	{
+		auto git = glyphs.find(cp);
+		if (git == glyphs.end() || git->second.page < 0)
+			continue;
+
+		std::pair<int, int> shelf(git->second.page, git->second.shelf);
+		if (std::find(entry.shelves.begin(), entry.shelves.end(), shelf) == entry.shelves.end())
+			entry.shelves.push_back(shelf);
+	}
+
+	if ((int) layoutCache.size() >= MAX_LAYOUT_CACHE_ENTRIES)
+	{
+		layoutCacheMap.erase(layoutCache.back().hash);
+		layoutCache.pop_back();
+	}
+
+	layoutCache.push_front(std::move(entry));
+	layoutCacheMap[hash] = layoutCache.begin();
+
+	return layoutCache.front();
+}
+
+void Font::clearLayoutCache()
+{
+	layoutCache.clear();
+	layoutCacheMap.clear();
+}
+
+void Font::print(graphics::Graphics *gfx, const std::vector<ColoredString> &text, const Matrix4 &m, const Colorf &constantcolor)
+{
+	const LayoutCacheEntry &layout = getLayout(text, -1.0f, ALIGN_MAX_ENUM, constantcolor);
+	printv(gfx, m, layout.drawCommands, layout.vertices);
+}
+
+void Font::printf(graphics::Graphics *gfx, const std::vector<ColoredString> &text, float wrap, AlignMode align, const Matrix4 &m, const Colorf &constantcolor)
+{
+	const LayoutCacheEntry &layout = getLayout(text, wrap, align, constantcolor);
+	printv(gfx, m, layout.drawCommands, layout.vertices);
 }
 
 int Font::getWidth(const std::string &str)
@@ -901,6 +1388,7 @@ void Font::getWrap(const std::vector<ColoredString> &text, float wraplimit, std:
 void Font::setLineHeight(float height)
 {
 	lineHeight = height;
+	clearLayoutCache();
 }
 
 float Font::getLineHeight() const
@@ -910,8 +1398,8 @@ float Font::getLineHeight() const
 
 void Font::setFilter(const Texture::Filter &f)
 {
-	for (const auto &image : images)
-		image->setFilter(f);
+	for (const TexturePage &page : pages)
+		page.image->setFilter(f);
 
 	filter = f;
 }
@@ -985,6 +1473,9 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 	{
 		if (f->rasterizers[0]->getDataType() != this->rasterizers[0]->getDataType())
 			throw love::Exception("Font fallbacks must be of the same font type.");
+
+		if (f->rasterizers[0]->getDistanceFieldSpread() != this->rasterizers[0]->getDistanceFieldSpread())
+			throw love::Exception("Font fallbacks must use the same distance field spread.");
 	}
 
 	rasterizers.resize(1);
@@ -992,6 +1483,11 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 	// NOTE: this won't invalidate already-rasterized glyphs.
 	for (const Font *f : fallbacks)
 		rasterizers.push_back(f->rasterizers[0]);
+
+	clearLayoutCache();
+
+	love::thread::Lock lock(glyphLoader->rasterizerMutex);
+	glyphLoader->rasterizers = rasterizers;
 }
 
 float Font::getDPIScale() const
@@ -1004,6 +1500,30 @@ uint32 Font::getTextureCacheID() const
 	return textureCacheID;
 }
 
+bool Font::isDistanceField() const
+{
+	return rasterizers[0]->getDistanceFieldSpread() > 0;
+}
+
+Shader::StandardShader Font::getStandardShaderType() const
+{
+	if (isDistanceField() && Shader::standardShaders[Shader::STANDARD_DISTANCE_FIELD] != nullptr)
+		return Shader::STANDARD_DISTANCE_FIELD;
+
+	return Shader::STANDARD_DEFAULT;
+}
+
+uint32 Font::getTextureVersion(const Texture *texture) const
+{
+	for (const TexturePage &page : pages)
+	{
+		if (page.image.get() == texture)
+			return page.version;
+	}
+
+	return 0;
+}
+
 bool Font::getConstant(const char *in, AlignMode &out)
 {
 	return alignModes.find(in, out);
@@ -22,8 +22,12 @@
 
 // STD
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
+#include <deque>
+#include <list>
+#include <memory>
 #include <stddef.h>
 
 // LOVE
@@ -33,7 +37,10 @@
 #include "common/Vector.h"
 
 #include "font/Rasterizer.h"
+#include "font/GlyphData.h"
+#include "thread/threads.h"
 #include "Image.h"
+#include "Shader.h"
 #include "vertex.h"
 #include "Volatile.h"
 
@@ -171,10 +178,48 @@ public:
 
 	void setFallbacks(const std::vector<Font *> &fallbacks);
 
+	/**
+	 * Starts rasterizing glyphs on a background thread, so they don't have to
+	 * be rasterized when they're first drawn.
+	 **/
+	void prewarm(const Codepoints &codepoints);
+
+	/**
+	 * Sets whether text is drawn without waiting for glyphs which aren't
+	 * loaded yet. Missing glyphs are then rasterized in the background and
+	 * drawn as blank space until they're ready.
+	 **/
+	void setAsyncLoading(bool enable);
+	bool isAsyncLoading() const;
+
+	/**
+	 * Adds glyphs rasterized in the background to the texture atlas. Called
+	 * whenever text is laid out or drawn.
+	 **/
+	void addLoadedGlyphs();
+
 	float getDPIScale() const;
 
 	uint32 getTextureCacheID() const;
 
+	/**
+	 * Gets whether the glyph textures contain signed distance fields, which
+	 * can be drawn at any scale.
+	 **/
+	bool isDistanceField() const;
+
+	/**
+	 * Gets the standard shader text is drawn with when no custom shader is
+	 * active.
+	 **/
+	Shader::StandardShader getStandardShaderType() const;
+
+	/**
+	 * Gets a number which changes whenever glyphs are evicted from the given
+	 * texture page, or 0 if the texture isn't one of this Font's pages.
+	 **/
+	uint32 getTextureVersion(const Texture *texture) const;
+
 	// Implements Volatile.
 	bool loadVolatile() override;
 	void unloadVolatile() override;
@@ -185,6 +230,10 @@ public:
 
 	static int fontCount;
 
+	// Number of print/printf calls which did and didn't reuse a cached layout.
+	static int64 layoutCacheHits;
+	static int64 layoutCacheMisses;
+
 private:
 
 	struct Glyph
@@ -192,6 +241,31 @@ private:
 		Texture *texture;
 		int spacing;
 		GlyphVertex vertices[4];
+		int page;
+		int shelf;
+	};
+
+	// A row of glyphs in a texture page. Glyphs are evicted a whole shelf at
+	// a time, and an emptied shelf can be refilled with any glyphs that fit.
+	struct Shelf
+	{
+		int y;
+		int height;
+		int x;
+		uint64 lastUsed;
+		std::vector<uint32> glyphs;
+	};
+
+	struct TexturePage
+	{
+		StrongRef<Image> image;
+		int width;
+		int height;
+		int nextShelfY;
+		std::vector<Shelf> shelves;
+
+		// Incremented when glyphs are evicted from the page.
+		uint32 version;
 	};
 
 	struct TextureSize
@@ -200,13 +274,68 @@ private:
 		int height;
 	};
 
-	void createTexture();
+	// State shared with the background task which rasterizes glyphs for
+	// prewarm(), so the task can safely outlive the Font.
+	struct GlyphLoader
+	{
+		// Guards the list, which setFallbacks replaces. The Rasterizers
+		// themselves lock their own font faces.
+		love::thread::MutexRef rasterizerMutex;
+		std::vector<StrongRef<love::font::Rasterizer>> rasterizers;
+		bool useSpacesAsTab = false;
+
+		love::thread::MutexRef queueMutex;
+		std::deque<uint32> queued;
+		std::vector<StrongRef<love::font::GlyphData>> loaded;
+		std::vector<uint32> failed;
+		bool running = false;
+		bool cancelled = false;
+	};
+
+	// Vertices generated by print or printf, kept so text which is drawn
+	// every frame doesn't have to be laid out every frame.
+	struct LayoutCacheEntry
+	{
+		uint64 hash;
+
+		std::vector<ColoredString> text;
+		float wrap;
+		AlignMode align;
+		Colorf color;
+
+		uint32 textureCacheID;
+		std::vector<std::pair<const Texture *, uint32>> textureVersions;
+
+		// Texture page and shelf indices of the glyphs used by the layout, so
+		// drawing cached text keeps them from looking unused.
+		std::vector<std::pair<int, int>> shelves;
+
+		std::vector<DrawCommand> drawCommands;
+		std::vector<GlyphVertex> vertices;
+	};
+
+	static love::font::GlyphData *loadGlyphData(GlyphLoader &loader, uint32 glyph);
+	static void loadQueuedGlyphs(GlyphLoader &loader);
+
+	void createTexture(const TextureSize &size);
+	void allocateGlyphSpace(int w, int h, int &page, int &shelf);
+	int addShelf(int page, int height);
+	void evictShelf(int page, int shelf);
+	void evictPage(int page);
+	void clearTexture(Image *image, const Rect &rect);
 
 	TextureSize getNextTextureSize() const;
 	love::font::GlyphData *getRasterizerGlyphData(uint32 glyph);
 	const Glyph &addGlyph(uint32 glyph);
+	const Glyph &addGlyph(uint32 glyph, love::font::GlyphData *gd);
 	const Glyph &findGlyph(uint32 glyph);
 	float getKerning(uint32 leftglyph, uint32 rightglyph);
+	std::vector<DrawCommand> layoutGlyphs(const ColoredCodepoints &codepoints, const Colorf &constantColor, std::vector<GlyphVertex> &vertices,
+	                                      float extra_spacing, Vector2 offset, TextInfo *info);
+	const LayoutCacheEntry &getLayout(const std::vector<ColoredString> &text, float wrap, AlignMode align, const Colorf &constantcolor);
+	bool isLayoutValid(const LayoutCacheEntry &entry, const std::vector<ColoredString> &text, float wrap, AlignMode align, const Colorf &constantcolor) const;
+	void clearLayoutCache();
+
 	void printv(Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices);
 
 	std::vector<StrongRef<love::font::Rasterizer>> rasterizers;
@@ -217,7 +346,10 @@ private:
 	int textureWidth;
 	int textureHeight;
 
-	std::vector<StrongRef<love::graphics::Image>> images;
+	// Glyphs are packed into shelves in one or more texture pages. Once there
+	// are MAX_TEXTURE_PAGES pages, the least recently used shelves are evicted
+	// to make room for new glyphs.
+	std::vector<TexturePage> pages;
 
 	// maps glyphs to glyph texture information
 	std::unordered_map<uint32, Glyph> glyphs;
@@ -231,14 +363,31 @@ private:
 
 	float dpiScale;
 
-	int textureX, textureY;
-	int rowHeight;
-
 	bool useSpacesAsTab;
 
+	std::shared_ptr<GlyphLoader> glyphLoader;
+
+	// Glyphs queued for or finished by the background task, which haven't
+	// been added to the texture atlas yet.
+	std::unordered_set<uint32> pendingGlyphs;
+
+	bool asyncLoading;
+
+	// Drawn in place of glyphs which are still loading.
+	Glyph loadingGlyph;
+	bool usedLoadingGlyph;
+
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
 
+	// Most recently used entries are at the front.
+	std::list<LayoutCacheEntry> layoutCache;
+	std::unordered_map<uint64, std::list<LayoutCacheEntry>::iterator> layoutCacheMap;
+
+	// Incremented whenever text is laid out. Shelves used by the current
+	// layout are never evicted.
+	uint64 glyphUseStamp;
+
 	// 1 pixel of transparent padding between glyphs (so quads won't pick up
 	// other glyphs), plus one pixel of transparent padding that the quads will
 	// use, for edge antialiasing.
@@ -247,6 +396,10 @@ private:
 	// This will be used if the Rasterizer doesn't have a tab character itself.
 	static const int SPACES_PER_TAB = 4;
 
+	static const int MAX_TEXTURE_PAGES = 8;
+
+	static const int MAX_LAYOUT_CACHE_ENTRIES = 512;
+
 	static StringMap<AlignMode, ALIGN_MAX_ENUM>::Entry alignModeEntries[];
 	static StringMap<AlignMode, ALIGN_MAX_ENUM> alignModes;
 	
@@ -0,0 +1,649 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "GPUParticleSimulation.h"
+#include "ParticleSystem.h"
+#include "Graphics.h"
+#include "Buffer.h"
+
+// C++
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace love
+{
+namespace graphics
+{
+
+namespace
+{
+
+// Float spawn times keep sub-millisecond precision below this.
+const double MAX_TIME = 1024.0;
+
+const char *glslHeader = "#version 330 core\n";
+const char *esslHeader = "#version 300 es\nprecision highp float;\nprecision highp int;\nprecision highp sampler2D;\n";
+
+const char *simulateVertexCode = R"(
+in vec4 VertexPosition;
+
+void main()
+{
+	gl_Position = vec4(VertexPosition.xy * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+// Integrates one particle per pixel, the same way as ParticleSystem does on
+// the CPU. Particles spawned in this step are initialized instead.
+const char *simulatePixelCode = R"(
+uniform sampler2D State;
+uniform sampler2D SpawnParams;
+uniform sampler2D MotionParams;
+uniform sampler2D AccelParams;
+uniform sampler2D ShapeParams;
+uniform sampler2D SpinParams;
+uniform float Step;
+uniform float DeltaTime;
+
+out vec4 FragColor;
+
+void main()
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+
+	vec4 state = texelFetch(State, texel, 0);
+	vec4 motion = texelFetch(MotionParams, texel, 0);
+	vec4 spin = texelFetch(SpinParams, texel, 0);
+
+	if (spin.z == Step)
+	{
+		state = vec4(texelFetch(SpawnParams, texel, 0).zw, motion.xy);
+		if (spin.w == 0.0)
+		{
+			FragColor = state;
+			return;
+		}
+	}
+	else if (spin.z > Step)
+	{
+		FragColor = state;
+		return;
+	}
+
+	vec4 accel = texelFetch(AccelParams, texel, 0);
+	float damping = texelFetch(ShapeParams, texel, 0).x;
+
+	vec2 radial = state.xy - motion.zw;
+	float len = length(radial);
+	radial = len > 0.0 ? radial / len : vec2(0.0);
+
+	vec2 a = radial * accel.z + vec2(-radial.y, radial.x) * accel.w + accel.xy;
+
+	vec2 velocity = (state.zw + a * DeltaTime) / (1.0 + damping * DeltaTime);
+	vec2 position = state.xy + velocity * DeltaTime;
+
+	FragColor = vec4(position, velocity);
+}
+)";
+
+// Draws one instance per particle slot. Dead and unused slots are moved off
+// screen, and everything which only depends on a particle's age is computed
+// here rather than stored.
+const char *drawVertexCode = R"(
+#define MAX_CURVE 8
+#define MAX_QUADS 32
+
+in vec4 VertexPosition;
+in vec4 ConstantColor;
+
+uniform mat4 ClipSpaceFromLocal;
+
+uniform sampler2D State;
+uniform sampler2D SpawnParams;
+uniform sampler2D MotionParams;
+uniform sampler2D ShapeParams;
+uniform sampler2D SpinParams;
+uniform float Step;
+uniform float Time;
+uniform int StateWidth;
+
+uniform float Sizes[MAX_CURVE];
+uniform int SizeCount;
+uniform vec4 Colors[MAX_CURVE];
+uniform int ColorCount;
+uniform vec4 QuadTexRects[MAX_QUADS];
+uniform vec2 QuadSizes[MAX_QUADS];
+uniform int QuadCount;
+uniform vec2 Offset;
+uniform int RelativeRotation;
+
+out vec2 VaryingTexCoord;
+out vec4 VaryingColor;
+
+void main()
+{
+	ivec2 texel = ivec2(gl_InstanceID % StateWidth, gl_InstanceID / StateWidth);
+
+	vec4 spawn = texelFetch(SpawnParams, texel, 0);
+	vec4 spin = texelFetch(SpinParams, texel, 0);
+
+	float age = Time - spawn.x;
+	float lifetime = spawn.y;
+
+	if (lifetime <= 0.0 || age >= lifetime)
+	{
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		VaryingTexCoord = vec2(0.0);
+		VaryingColor = vec4(0.0);
+		return;
+	}
+
+	vec4 state = texelFetch(State, texel, 0);
+	if (spin.z > Step)
+		state = vec4(spawn.zw, texelFetch(MotionParams, texel, 0).xy);
+
+	vec4 shape = texelFetch(ShapeParams, texel, 0);
+	float t = clamp(age / lifetime, 0.0, 1.0);
+
+	float s = (shape.y + t * shape.z) * float(SizeCount - 1);
+	int j = clamp(int(s), 0, SizeCount - 1);
+	int k = min(j + 1, SizeCount - 1);
+	float size = mix(Sizes[j], Sizes[k], s - float(j));
+
+	s = t * float(ColorCount - 1);
+	j = clamp(int(s), 0, ColorCount - 1);
+	k = min(j + 1, ColorCount - 1);
+	vec4 color = mix(Colors[j], Colors[k], s - float(j));
+
+	int quad = clamp(int(t * float(QuadCount)), 0, QuadCount - 1);
+
+	float angle = shape.w + spin.x * age + (spin.y - spin.x) * age * age / (2.0 * lifetime);
+	if (RelativeRotation != 0)
+		angle += atan(state.w, state.z);
+
+	vec2 local = (VertexPosition.xy * QuadSizes[quad] - Offset) * size;
+	float c = cos(angle);
+	float sn = sin(angle);
+	vec2 position = vec2(c * local.x - sn * local.y, sn * local.x + c * local.y) + state.xy;
+
+	vec4 texrect = QuadTexRects[quad];
+	VaryingTexCoord = texrect.xy + VertexPosition.xy * texrect.zw;
+	VaryingColor = color * ConstantColor;
+
+	gl_Position = ClipSpaceFromLocal * vec4(position, 0.0, 1.0);
+}
+)";
+
+const char *drawPixelCode = R"(
+uniform sampler2D MainTex;
+
+in vec2 VaryingTexCoord;
+in vec4 VaryingColor;
+
+out vec4 FragColor;
+
+void main()
+{
+	FragColor = texture(MainTex, VaryingTexCoord) * VaryingColor;
+}
+)";
+
+const int MAX_CURVE_VALUES = 8;
+
+} // anonymous namespace
+
+GPUParticleSimulation::GPUParticleSimulation(Graphics *gfx, uint32 capacity)
+	: capacity(capacity)
+	, width(0)
+	, height(0)
+	, currentState(0)
+	, quadBuffer(nullptr)
+	, time(0.0)
+	, stepIndex(0.0f)
+	, nextSlot(0)
+	, usedSlots(0)
+	, liveCount(0)
+{
+	if (!isSupported(gfx))
+		throw love::Exception("GPU particle simulation is not supported on this system.");
+
+	int maxsize = (int) gfx->getCapabilities().limits[Graphics::LIMIT_TEXTURE_SIZE];
+
+	width = (int) std::min<uint32>(capacity, 1024);
+	height = (int) ((capacity + width - 1) / width);
+
+	if (height > maxsize)
+		throw love::Exception("ParticleSystem buffer size is too large for GPU simulation on this system.");
+
+	Canvas::Settings settings;
+	settings.width = width;
+	settings.height = height;
+	settings.format = PIXELFORMAT_RGBA32F;
+
+	for (int i = 0; i < 2; i++)
+		stateCanvases[i].set(gfx->newCanvas(settings), Acquire::NORETAIN);
+
+	size_t texels = (size_t) width * height;
+
+	for (int i = 0; i < PARAMS_MAX_ENUM; i++)
+	{
+		params[i].set(gfx->newImage(TEXTURE_2D, PIXELFORMAT_RGBA32F, width, height, 1, Image::Settings()), Acquire::NORETAIN);
+
+		// Unused slots must never look alive.
+		paramsStaging[i].resize(texels * 4, 0.0f);
+		params[i]->replacePixels(paramsStaging[i].data(), texels * 4 * sizeof(float), 0, 0, {0, 0, width, height}, false);
+	}
+
+	bool gles = gfx->getShaderLanguageTarget() == Shader::LANGUAGE_ESSL3;
+	std::string header = gles ? esslHeader : glslHeader;
+
+	simulateShader.set(gfx->newShader(header + simulateVertexCode, header + simulatePixelCode), Acquire::NORETAIN);
+	drawShader.set(gfx->newShader(header + drawVertexCode, header + drawPixelCode), Acquire::NORETAIN);
+
+	// Corners in triangle strip order, matching Quad.
+	const Vector2 corners[] = {{0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}};
+	quadBuffer = gfx->newBuffer(sizeof(corners), corners, BUFFER_VERTEX, vertex::USAGE_STATIC, 0);
+
+	slotDeathTimes.resize(capacity, 0.0f);
+	slotGenerations.resize(capacity, 0);
+}
+
+GPUParticleSimulation::~GPUParticleSimulation()
+{
+	delete quadBuffer;
+}
+
+bool GPUParticleSimulation::isSupported(Graphics *gfx)
+{
+	Shader::Language target = gfx->getShaderLanguageTarget();
+	if (target != Shader::LANGUAGE_GLSL3 && target != Shader::LANGUAGE_ESSL3)
+		return false;
+
+	if (!gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING])
+		return false;
+
+	return gfx->isCanvasFormatSupported(PIXELFORMAT_RGBA32F) && gfx->isImageFormatSupported(PIXELFORMAT_RGBA32F);
+}
+
+void GPUParticleSimulation::reset()
+{
+	// Lifetimes of zero mark slots as unused, so only the spawn parameters
+	// need to be cleared.
+	std::vector<float> &spawnparams = paramsStaging[PARAMS_SPAWN];
+	std::fill(spawnparams.begin(), spawnparams.end(), 0.0f);
+	params[PARAMS_SPAWN]->replacePixels(spawnparams.data(), spawnparams.size() * sizeof(float), 0, 0, {0, 0, width, height}, false);
+
+	nextSlot = 0;
+	usedSlots = 0;
+	liveCount = 0;
+
+	std::fill(slotDeathTimes.begin(), slotDeathTimes.end(), 0.0f);
+	deaths = decltype(deaths)();
+}
+
+void GPUParticleSimulation::step(float dt, const float *const *particles, uint32 count)
+{
+	time += dt;
+
+	if (stepIndex >= (float) MAX_STEP_INDEX || time >= MAX_TIME)
+		rebase();
+
+	stepIndex += 1.0f;
+
+	while (!deaths.empty() && deaths.top().time <= (float) time)
+	{
+		const Death &d = deaths.top();
+		if (d.generation == slotGenerations[d.slot])
+			liveCount--;
+		deaths.pop();
+	}
+
+	spawn(particles, count, stepIndex, false);
+
+	if (usedSlots == 0)
+		return;
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	gfx->flushStreamDraws();
+	gfx->push(Graphics::STACK_ALL);
+
+	try
+	{
+		int target = 1 - currentState;
+
+		Graphics::RenderTargets rts;
+		rts.colors.emplace_back(stateCanvases[target].get());
+		gfx->setCanvas(rts);
+
+		gfx->setBlendMode(Graphics::BLEND_REPLACE, Graphics::BLENDALPHA_PREMULTIPLIED);
+		gfx->setScissor();
+		gfx->setColorMask(Graphics::ColorMask());
+		gfx->setWireframe(false);
+		gfx->setStencilTest();
+		gfx->setDepthMode();
+
+		Shader *shader = simulateShader.get();
+		gfx->setShader(shader);
+
+		sendTexture(shader, "State", stateCanvases[currentState].get());
+		sendTexture(shader, "SpawnParams", params[PARAMS_SPAWN].get());
+		sendTexture(shader, "MotionParams", params[PARAMS_MOTION].get());
+		sendTexture(shader, "AccelParams", params[PARAMS_ACCEL].get());
+		sendTexture(shader, "ShapeParams", params[PARAMS_SHAPE].get());
+		sendTexture(shader, "SpinParams", params[PARAMS_SPIN].get());
+		sendFloats(shader, "Step", &stepIndex, 1);
+		sendFloats(shader, "DeltaTime", &dt, 1);
+
+		vertex::Attributes attributes;
+		vertex::Buffers buffers;
+
+		attributes.set(ATTRIB_POS, vertex::DATA_FLOAT, 2, 0, (uint16) sizeof(Vector2), 0);
+		buffers.set(0, quadBuffer, 0);
+
+		Graphics::DrawCommand cmd(&attributes, &buffers);
+		cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+		cmd.vertexCount = 4;
+
+		gfx->draw(cmd);
+
+		currentState = target;
+	}
+	catch (love::Exception &)
+	{
+		gfx->pop();
+		throw;
+	}
+
+	gfx->pop();
+}
+
+void GPUParticleSimulation::rebase()
+{
+	// Make spawn steps relative to the current step. Particles waiting to be
+	// spawned in the next step end up at 1, and everything else at 0 or -1,
+	// so the shaders' comparisons give the same results as before.
+	std::vector<float> &spinparams = paramsStaging[PARAMS_SPIN];
+	for (size_t i = 2; i < spinparams.size(); i += 4)
+		spinparams[i] = std::max(spinparams[i] - stepIndex, -1.0f);
+
+	// Spawn and death times are made relative to the current time, which
+	// keeps particle ages the same.
+	float basetime = (float) time;
+
+	std::vector<float> &spawnparams = paramsStaging[PARAMS_SPAWN];
+	for (size_t i = 0; i < spawnparams.size(); i += 4)
+		spawnparams[i] -= basetime;
+
+	for (float &deathtime : slotDeathTimes)
+		deathtime -= basetime;
+
+	std::vector<Death> pending;
+	pending.reserve(deaths.size());
+
+	for (; !deaths.empty(); deaths.pop())
+	{
+		pending.push_back(deaths.top());
+		pending.back().time -= basetime;
+	}
+
+	deaths = decltype(deaths)(std::greater<Death>(), std::move(pending));
+
+	params[PARAMS_SPAWN]->replacePixels(spawnparams.data(), spawnparams.size() * sizeof(float), 0, 0, {0, 0, width, height}, false);
+	params[PARAMS_SPIN]->replacePixels(spinparams.data(), spinparams.size() * sizeof(float), 0, 0, {0, 0, width, height}, false);
+
+	time -= basetime;
+	stepIndex = 0.0f;
+}
+
+void GPUParticleSimulation::spawn(const float *const *particles, uint32 count)
+{
+	// These particles are integrated in the next step, like the CPU path
+	// does for particles added outside of update().
+	spawn(particles, count, stepIndex + 1.0f, true);
+}
+
+void GPUParticleSimulation::spawn(const float *const *particles, uint32 count, float spawnstep, bool integratefirst)
+{
+	typedef ParticleSystem P;
+
+	if (count == 0)
+		return;
+
+	// Only the newest particles survive if there are more than fit.
+	uint32 skip = count > capacity ? count - capacity : 0;
+
+	uint32 firstslot = nextSlot;
+	float spawntime = (float) time;
+
+	for (uint32 i = skip; i < count; i++)
+	{
+		uint32 slot = nextSlot;
+		nextSlot = (nextSlot + 1) % capacity;
+
+		if (slotDeathTimes[slot] > spawntime)
+			liveCount--;
+
+		float lifetime = particles[P::PARTICLE_LIFETIME][i];
+
+		slotGenerations[slot]++;
+		slotDeathTimes[slot] = spawntime + lifetime;
+
+		if (lifetime > 0.0f)
+		{
+			liveCount++;
+			deaths.push({spawntime + lifetime, slot, slotGenerations[slot]});
+		}
+
+		float *p = &paramsStaging[PARAMS_SPAWN][slot * 4];
+		p[0] = spawntime;
+		p[1] = lifetime;
+		p[2] = particles[P::PARTICLE_POSITION_X][i];
+		p[3] = particles[P::PARTICLE_POSITION_Y][i];
+
+		p = &paramsStaging[PARAMS_MOTION][slot * 4];
+		p[0] = particles[P::PARTICLE_VELOCITY_X][i];
+		p[1] = particles[P::PARTICLE_VELOCITY_Y][i];
+		p[2] = particles[P::PARTICLE_ORIGIN_X][i];
+		p[3] = particles[P::PARTICLE_ORIGIN_Y][i];
+
+		p = &paramsStaging[PARAMS_ACCEL][slot * 4];
+		p[0] = particles[P::PARTICLE_LINEAR_ACCELERATION_X][i];
+		p[1] = particles[P::PARTICLE_LINEAR_ACCELERATION_Y][i];
+		p[2] = particles[P::PARTICLE_RADIAL_ACCELERATION][i];
+		p[3] = particles[P::PARTICLE_TANGENTIAL_ACCELERATION][i];
+
+		p = &paramsStaging[PARAMS_SHAPE][slot * 4];
+		p[0] = particles[P::PARTICLE_LINEAR_DAMPING][i];
+		p[1] = particles[P::PARTICLE_SIZE_OFFSET][i];
+		p[2] = particles[P::PARTICLE_SIZE_INTERVAL_SIZE][i];
+		p[3] = particles[P::PARTICLE_ROTATION][i];
+
+		p = &paramsStaging[PARAMS_SPIN][slot * 4];
+		p[0] = particles[P::PARTICLE_SPIN_START][i];
+		p[1] = particles[P::PARTICLE_SPIN_END][i];
+		p[2] = spawnstep;
+		p[3] = integratefirst ? 1.0f : 0.0f;
+	}
+
+	uint32 spawned = count - skip;
+	usedSlots = std::min(usedSlots + spawned, capacity);
+
+	// The slots wrap around at most once.
+	uint32 firstcount = std::min(spawned, capacity - firstslot);
+	uploadSlots(firstslot, firstcount);
+
+	if (spawned > firstcount)
+		uploadSlots(0, spawned - firstcount);
+}
+
+void GPUParticleSimulation::uploadSlots(uint32 firstslot, uint32 count)
+{
+	// Whole rows are uploaded, since the staging data mirrors the Images.
+	int firstrow = (int) (firstslot / width);
+	int lastrow = (int) ((firstslot + count - 1) / width);
+	int rows = lastrow - firstrow + 1;
+
+	size_t offset = (size_t) firstrow * width * 4;
+	size_t size = (size_t) rows * width * 4 * sizeof(float);
+
+	for (int i = 0; i < PARAMS_MAX_ENUM; i++)
+		params[i]->replacePixels(&paramsStaging[i][offset], size, 0, 0, {0, firstrow, width, rows}, false);
+}
+
+uint32 GPUParticleSimulation::getCount() const
+{
+	return liveCount;
+}
+
+void GPUParticleSimulation::draw(Graphics *gfx, const Matrix4 &m, Texture *texture, const std::vector<float> &sizes, const std::vector<Colorf> &colors, const std::vector<StrongRef<Quad>> &quads, const Vector2 &offset, bool relativerotation)
+{
+	if (usedSlots == 0 || liveCount == 0)
+		return;
+
+	gfx->flushStreamDraws();
+
+	Shader *prevshader = Shader::current;
+	Shader *shader = drawShader.get();
+
+	shader->attach();
+
+	try
+	{
+		float values[MAX_QUADS * 4];
+
+		int sizecount = std::min((int) sizes.size(), MAX_CURVE_VALUES);
+		sendFloats(shader, "Sizes", sizes.data(), sizecount);
+		sendInt(shader, "SizeCount", sizecount);
+
+		int colorcount = std::min((int) colors.size(), MAX_CURVE_VALUES);
+		for (int i = 0; i < colorcount; i++)
+		{
+			Colorf c = colors[i];
+			gammaCorrectColor(c);
+			values[i * 4 + 0] = c.r;
+			values[i * 4 + 1] = c.g;
+			values[i * 4 + 2] = c.b;
+			values[i * 4 + 3] = c.a;
+		}
+		sendFloats(shader, "Colors", values, colorcount * 4);
+		sendInt(shader, "ColorCount", colorcount);
+
+		int quadcount = std::max(std::min((int) quads.size(), MAX_QUADS), 1);
+		float quadsizes[MAX_QUADS * 2];
+
+		for (int i = 0; i < quadcount; i++)
+		{
+			Quad *q = quads.empty() ? texture->getQuad() : quads[i].get();
+			const Vector2 *positions = q->getVertexPositions();
+			const Vector2 *texcoords = q->getVertexTexCoords();
+
+			values[i * 4 + 0] = texcoords[0].x;
+			values[i * 4 + 1] = texcoords[0].y;
+			values[i * 4 + 2] = texcoords[3].x - texcoords[0].x;
+			values[i * 4 + 3] = texcoords[3].y - texcoords[0].y;
+
+			quadsizes[i * 2 + 0] = positions[3].x;
+			quadsizes[i * 2 + 1] = positions[3].y;
+		}
+
+		sendFloats(shader, "QuadTexRects", values, quadcount * 4);
+		sendFloats(shader, "QuadSizes", quadsizes, quadcount * 2);
+		sendInt(shader, "QuadCount", quadcount);
+
+		float offsetvalues[] = {offset.x, offset.y};
+		sendFloats(shader, "Offset", offsetvalues, 2);
+		sendInt(shader, "RelativeRotation", relativerotation ? 1 : 0);
+
+		sendTexture(shader, "State", stateCanvases[currentState].get());
+		sendTexture(shader, "SpawnParams", params[PARAMS_SPAWN].get());
+		sendTexture(shader, "MotionParams", params[PARAMS_MOTION].get());
+		sendTexture(shader, "ShapeParams", params[PARAMS_SHAPE].get());
+		sendTexture(shader, "SpinParams", params[PARAMS_SPIN].get());
+
+		float curtime = (float) time;
+		sendFloats(shader, "Step", &stepIndex, 1);
+		sendFloats(shader, "Time", &curtime, 1);
+		sendInt(shader, "StateWidth", width);
+
+		vertex::Attributes attributes;
+		vertex::Buffers buffers;
+
+		attributes.set(ATTRIB_POS, vertex::DATA_FLOAT, 2, 0, (uint16) sizeof(Vector2), 0);
+		buffers.set(0, quadBuffer, 0);
+
+		Graphics::TempTransform transform(gfx, m);
+
+		Graphics::DrawCommand cmd(&attributes, &buffers);
+		cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+		cmd.vertexCount = 4;
+		cmd.instanceCount = (int) usedSlots;
+		cmd.texture = texture;
+
+		gfx->draw(cmd);
+	}
+	catch (love::Exception &)
+	{
+		if (prevshader != nullptr)
+			prevshader->attach();
+		throw;
+	}
+
+	if (prevshader != nullptr)
+		prevshader->attach();
+}
+
+void GPUParticleSimulation::sendFloats(Shader *shader, const char *name, const float *values, int count)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr || info->baseType != Shader::UNIFORM_FLOAT)
+		return;
+
+	int elements = std::min(count / info->components, info->count);
+	if (elements <= 0)
+		return;
+
+	memcpy(info->floats, values, sizeof(float) * info->components * elements);
+	shader->updateUniform(info, elements);
+}
+
+void GPUParticleSimulation::sendInt(Shader *shader, const char *name, int value)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr || info->baseType != Shader::UNIFORM_INT)
+		return;
+
+	info->ints[0] = value;
+	shader->updateUniform(info, 1);
+}
+
+void GPUParticleSimulation::sendTexture(Shader *shader, const char *name, Texture *texture)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr || info->baseType != Shader::UNIFORM_SAMPLER)
+		return;
+
+	shader->sendTextures(info, &texture, 1);
+}
+
+} // graphics
+} // love
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "common/Color.h"
+#include "common/Vector.h"
+#include "common/Matrix.h"
+#include "Canvas.h"
+#include "Image.h"
+#include "Shader.h"
+#include "Quad.h"
+
+// C++
+#include <vector>
+#include <queue>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+class Buffer;
+
+/**
+ * Steps ParticleSystem particles on the GPU. Particle positions and
+ * velocities live in a pair of float Canvases which a shader updates each
+ * step, and everything else about a particle is decided when it's spawned
+ * and stored in float Images. Particles are drawn with one instance each,
+ * and their size, color, quad and rotation are evaluated from their age in
+ * the vertex shader.
+ *
+ * Particles are stored in a ring of slots, so when the ring is full the
+ * oldest particle is replaced by the next one spawned.
+ **/
+class GPUParticleSimulation
+{
+public:
+
+	// Maximum number of Quads a ParticleSystem can use in this mode.
+	static const int MAX_QUADS = 32;
+
+	GPUParticleSimulation(Graphics *gfx, uint32 capacity);
+	~GPUParticleSimulation();
+
+	static bool isSupported(Graphics *gfx);
+
+	/**
+	 * Removes all particles.
+	 **/
+	void reset();
+
+	/**
+	 * Advances the simulation by dt. Particles in the given attribute arrays
+	 * (laid out as in ParticleSystem) are spawned first, and aren't moved
+	 * until the next step, like on the CPU.
+	 **/
+	void step(float dt, const float *const *particles, uint32 count);
+
+	/**
+	 * Spawns particles outside of a step. They're moved by the next step.
+	 **/
+	void spawn(const float *const *particles, uint32 count);
+
+	uint32 getCount() const;
+
+	void draw(Graphics *gfx, const Matrix4 &m, Texture *texture, const std::vector<float> &sizes, const std::vector<Colorf> &colors, const std::vector<StrongRef<Quad>> &quads, const Vector2 &offset, bool relativerotation);
+
+private:
+
+	enum ParamsImage
+	{
+		PARAMS_SPAWN,   // spawn time, lifetime, start position
+		PARAMS_MOTION,  // start velocity, origin
+		PARAMS_ACCEL,   // linear, radial and tangential acceleration
+		PARAMS_SHAPE,   // damping, size offset, size interval, rotation
+		PARAMS_SPIN,    // spin start, spin end, spawn step, integrate flag
+		PARAMS_MAX_ENUM
+	};
+
+	struct Death
+	{
+		float time;
+		uint32 slot;
+		uint32 generation;
+
+		bool operator > (const Death &other) const { return time > other.time; }
+	};
+
+	void spawn(const float *const *particles, uint32 count, float spawnstep, bool integratefirst);
+	void uploadSlots(uint32 firstslot, uint32 count);
+	void rebase();
+
+	static void sendFloats(Shader *shader, const char *name, const float *values, int count);
+	static void sendInt(Shader *shader, const char *name, int value);
+	static void sendTexture(Shader *shader, const char *name, Texture *texture);
+
+	uint32 capacity;
+	int width;
+	int height;
+
+	StrongRef<Canvas> stateCanvases[2];
+	int currentState;
+
+	StrongRef<Image> params[PARAMS_MAX_ENUM];
+	std::vector<float> paramsStaging[PARAMS_MAX_ENUM];
+
+	StrongRef<Shader> simulateShader;
+	StrongRef<Shader> drawShader;
+
+	// Corners of the unit square, used for both passes.
+	Buffer *quadBuffer;
+
+	// Spawn times and steps are stored as floats, and the shaders compare
+	// steps exactly and subtract times to get particle ages. Both are rebased
+	// to 0 long before they lose precision.
+	double time;
+	float stepIndex;
+	static const int MAX_STEP_INDEX = 1 << 20;
+
+	uint32 nextSlot;
+	uint32 usedSlots;
+
+	// Used to keep track of the number of live particles without reading
+	// anything back from the GPU.
+	std::vector<float> slotDeathTimes;
+	std::vector<uint32> slotGenerations;
+	std::priority_queue<Death, std::vector<Death>, std::greater<Death>> deaths;
+	uint32 liveCount;
+
+}; // GPUParticleSimulation
+
+} // graphics
+} // love
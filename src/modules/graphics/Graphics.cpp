@@ -31,10 +31,13 @@
 #include "Font.h"
 #include "Video.h"
 #include "Text.h"
+#include "Path.h"
 #include "common/deprecation.h"
+#include "timer/Timer.h"
 
 // C++
 #include <algorithm>
+#include <limits>
 #include <stdlib.h>
 
 namespace love
@@ -43,6 +46,7 @@ namespace graphics
 {
 
 static bool gammaCorrect = false;
+static bool shaderCacheEnabled = false;
 static bool debugMode = false;
 static bool debugModeQueried = false;
 
@@ -56,6 +60,16 @@ bool isGammaCorrect()
 	return gammaCorrect;
 }
 
+void setShaderCacheEnabled(bool enable)
+{
+	shaderCacheEnabled = enable;
+}
+
+bool isShaderCacheEnabled()
+{
+	return shaderCacheEnabled;
+}
+
 void gammaCorrectColor(Colorf &c)
 {
 	if (isGammaCorrect())
@@ -115,6 +129,12 @@ Graphics::Graphics()
 	, active(true)
 	, writingToStencil(false)
 	, streamBufferState()
+	, batchMode(BATCH_IMMEDIATE)
+	, deferredStreamState()
+	, profileState()
+	, workerPool(nullptr)
+	, autoBatching(false)
+	, textureArrayAtlas(nullptr)
 	, projectionMatrix()
 	, canvasSwitchCount(0)
 	, drawCalls(0)
@@ -122,6 +142,11 @@ Graphics::Graphics()
 	, quadIndexBuffer(nullptr)
 	, capabilities()
 	, cachedShaderStages()
+	, asyncImageLoads()
+	, asyncImageMutex()
+	, asyncImageBudget(128 * 1024 * 1024)
+	, asyncImageMemory(0)
+	, asyncImagesDecoding(0)
 {
 	transformStack.reserve(16);
 	transformStack.push_back(Matrix4());
@@ -140,6 +165,20 @@ Graphics::~Graphics()
 {
 	delete quadIndexBuffer;
 
+	// Screenshots may still be encoding and writing to files, and images may
+	// still be decoding, in the background.
+	if (workerPool != nullptr)
+		workerPool->waitForTasks();
+	delete workerPool;
+
+	for (AsyncImageLoad *load : asyncImageLoads)
+	{
+		load->info.callback(&load->info, nullptr, nullptr, nullptr);
+		delete load;
+	}
+	asyncImageLoads.clear();
+	delete textureArrayAtlas;
+
 	// Clean up standard shaders before the active shader. If we do it after,
 	// the active shader may try to activate a standard shader when deactivating
 	// itself, which will cause problems since it calls Graphics methods in the
@@ -204,9 +243,9 @@ Video *Graphics::newVideo(love::video::VideoStream *stream, float dpiscale)
 	return new Video(this, stream, dpiscale);
 }
 
-love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, vertex::Usage usage)
+love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, vertex::Usage usage, bool instanced)
 {
-	return new SpriteBatch(this, texture, size, usage);
+	return new SpriteBatch(this, texture, size, usage, instanced);
 }
 
 love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size)
@@ -260,6 +299,31 @@ Shader *Graphics::newShader(const std::string &vertex, const std::string &pixel)
 	return newShaderInternal(vertexstage.get(), pixelstage.get());
 }
 
+Shader *Graphics::newShader(const std::string &vertex, const std::string &pixel, const std::string &instancedvertex)
+{
+	Shader *shader = newShader(vertex, pixel);
+
+	// Shaders without vertex code use the standard instanced vertex code.
+	if (vertex.empty())
+	{
+		int languageindex = (int) getShaderLanguageTarget();
+		int gammaindex = isGammaCorrect() ? 1 : 0;
+
+		if (capabilities.features[FEATURE_INSTANCING])
+			shader->setInstancedVertexSource(defaultShaderCode[Shader::STANDARD_INSTANCED][languageindex][gammaindex].source[ShaderStage::STAGE_VERTEX]);
+	}
+	else
+		shader->setInstancedVertexSource(instancedvertex);
+
+	return shader;
+}
+
+Shader *Graphics::newInstancedShaderVariant(const std::string &vertex, ShaderStage *pixel)
+{
+	StrongRef<ShaderStage> vertexstage(newShaderStage(ShaderStage::STAGE_VERTEX, vertex), Acquire::NORETAIN);
+	return newShaderInternal(vertexstage.get(), pixel);
+}
+
 Mesh *Graphics::newMesh(const std::vector<Vertex> &vertices, PrimitiveType drawmode, vertex::Usage usage)
 {
 	return newMesh(Mesh::getDefaultVertexFormat(), &vertices[0], vertices.size() * sizeof(Vertex), drawmode, usage);
@@ -285,6 +349,11 @@ love::graphics::Text *Graphics::newText(graphics::Font *font, const std::vector<
 	return new Text(font, text);
 }
 
+love::graphics::Path *Graphics::newPath(DrawMode mode)
+{
+	return new Path(mode);
+}
+
 void Graphics::cleanupCachedShaderStage(ShaderStage::StageType type, const std::string &hashkey)
 {
 	cachedShaderStages[type].erase(hashkey);
@@ -346,6 +415,11 @@ double Graphics::getScreenDPIScale() const
 	return (double) getPixelHeight() / (double) getHeight();
 }
 
+double Graphics::getCurrentPixelScale() const
+{
+	return pixelScaleStack.back();
+}
+
 bool Graphics::isCreated() const
 {
 	return created;
@@ -973,12 +1047,239 @@ bool Graphics::isWireframe() const
 	return states.back().wireframe;
 }
 
+void Graphics::setBatchMode(BatchMode mode)
+{
+	if (mode != batchMode)
+		flushStreamDraws();
+
+	batchMode = mode;
+}
+
+Graphics::BatchMode Graphics::getBatchMode() const
+{
+	return batchMode;
+}
+
+void Graphics::setAutoBatching(bool enable)
+{
+	if (!enable && textureArrayAtlas != nullptr)
+	{
+		flushStreamDraws();
+		delete textureArrayAtlas;
+		textureArrayAtlas = nullptr;
+	}
+
+	autoBatching = enable;
+}
+
+bool Graphics::isAutoBatching() const
+{
+	return autoBatching;
+}
+
+TextureArrayAtlas *Graphics::getTextureArrayAtlas()
+{
+	if (textureArrayAtlas == nullptr)
+		textureArrayAtlas = new TextureArrayAtlas(this);
+
+	return textureArrayAtlas;
+}
+
 void Graphics::captureScreenshot(const ScreenshotInfo &info)
 {
 	pendingScreenshotCallbacks.push_back(info);
 }
 
 Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &cmd)
+{
+	// Video draws set textures on the active shader after requesting their
+	// vertices, so they can't be reordered.
+	if (batchMode == BATCH_DEFERRED && cmd.standardShaderType != Shader::STANDARD_VIDEO)
+		return requestDeferredStreamDraw(cmd);
+
+	if (!deferredStreamState.draws.empty() && !deferredStreamState.submitting)
+		submitDeferredStreamDraws();
+
+	return requestImmediateStreamDraw(cmd);
+}
+
+Graphics::StreamVertexData Graphics::requestDeferredStreamDraw(const StreamDrawCommand &cmd)
+{
+	DeferredStreamState &state = deferredStreamState;
+
+	DeferredStreamDraw draw;
+	draw.command = cmd;
+	draw.texture.set(cmd.texture);
+
+	StreamVertexData d;
+
+	for (int i = 0; i < 2; i++)
+	{
+		size_t size = vertex::getFormatStride(cmd.formats[i]) * cmd.vertexCount;
+		size_t offset = state.data[i].size();
+
+		draw.dataOffsets[i] = offset;
+
+		// The returned pointers only need to stay valid until the next request.
+		state.data[i].resize(offset + size);
+		d.stream[i] = size > 0 ? &state.data[i][offset] : nullptr;
+	}
+
+	state.draws.push_back(draw);
+
+	return d;
+}
+
+static void computeDeferredDrawBounds(const Graphics::StreamDrawCommand &cmd, const uint8 *data, float bounds[4])
+{
+	using namespace vertex;
+
+	bounds[0] = bounds[1] = -std::numeric_limits<float>::max();
+	bounds[2] = bounds[3] = std::numeric_limits<float>::max();
+
+	// Points have a screen-space size and 3D positions may be reordered by the
+	// projection, so we can't prove that they don't overlap anything.
+	if (cmd.primitiveMode == PRIMITIVE_POINTS || getFormatPositionComponents(cmd.formats[0]) != 2 || cmd.vertexCount <= 0)
+		return;
+
+	size_t stride = getFormatStride(cmd.formats[0]);
+
+	float minx = std::numeric_limits<float>::max();
+	float miny = std::numeric_limits<float>::max();
+	float maxx = -std::numeric_limits<float>::max();
+	float maxy = -std::numeric_limits<float>::max();
+
+	for (int i = 0; i < cmd.vertexCount; i++)
+	{
+		// Every 2D stream format starts with its x and y components.
+		const float *pos = (const float *) (data + stride * i);
+		minx = std::min(minx, pos[0]);
+		miny = std::min(miny, pos[1]);
+		maxx = std::max(maxx, pos[0]);
+		maxy = std::max(maxy, pos[1]);
+	}
+
+	bounds[0] = minx;
+	bounds[1] = miny;
+	bounds[2] = maxx;
+	bounds[3] = maxy;
+}
+
+static inline bool deferredBoundsOverlap(const float a[4], const float b[4])
+{
+	// Shapes that only share an edge don't rasterize any common pixels.
+	return a[0] < b[2] && b[0] < a[2] && a[1] < b[3] && b[1] < a[3];
+}
+
+static inline bool deferredDrawsMatch(const Graphics::StreamDrawCommand &a, const Graphics::StreamDrawCommand &b)
+{
+	return a.primitiveMode == b.primitiveMode
+		&& a.formats[0] == b.formats[0] && a.formats[1] == b.formats[1]
+		&& (a.indexMode != vertex::TriangleIndexMode::NONE) == (b.indexMode != vertex::TriangleIndexMode::NONE)
+		&& a.texture == b.texture
+		&& a.standardShaderType == b.standardShaderType;
+}
+
+void Graphics::submitDeferredStreamDraws()
+{
+	DeferredStreamState &state = deferredStreamState;
+
+	if (state.draws.empty() || state.submitting)
+		return;
+
+	// Limits the cost of finding a compatible run for each draw.
+	const int MAX_RUN_SEARCH = 64;
+
+	struct Run
+	{
+		int first;
+		int last;
+		float bounds[4];
+	};
+
+	std::vector<Run> runs;
+	std::vector<int> next(state.draws.size(), -1);
+
+	for (int i = 0; i < (int) state.draws.size(); i++)
+	{
+		DeferredStreamDraw &draw = state.draws[i];
+		computeDeferredDrawBounds(draw.command, state.data[0].data() + draw.dataOffsets[0], draw.bounds);
+
+		// Walk back through the runs recorded so far. The draw can be moved
+		// into an earlier run with the same state, as long as it doesn't
+		// overlap anything drawn in the runs it would be moved in front of.
+		int target = -1;
+		int searchend = std::max((int) runs.size() - MAX_RUN_SEARCH, 0);
+
+		for (int r = (int) runs.size() - 1; r >= searchend; r--)
+		{
+			Run &run = runs[r];
+
+			if (deferredDrawsMatch(state.draws[run.first].command, draw.command))
+			{
+				target = r;
+				break;
+			}
+
+			if (deferredBoundsOverlap(run.bounds, draw.bounds))
+				break;
+		}
+
+		if (target >= 0)
+		{
+			Run &run = runs[target];
+			next[run.last] = i;
+			run.last = i;
+			run.bounds[0] = std::min(run.bounds[0], draw.bounds[0]);
+			run.bounds[1] = std::min(run.bounds[1], draw.bounds[1]);
+			run.bounds[2] = std::max(run.bounds[2], draw.bounds[2]);
+			run.bounds[3] = std::max(run.bounds[3], draw.bounds[3]);
+		}
+		else
+		{
+			Run run = {i, i, {draw.bounds[0], draw.bounds[1], draw.bounds[2], draw.bounds[3]}};
+			runs.push_back(run);
+		}
+	}
+
+	auto reset = [&]()
+	{
+		state.submitting = false;
+		state.draws.clear();
+		state.data[0].clear();
+		state.data[1].clear();
+	};
+
+	state.submitting = true;
+
+	try
+	{
+		for (const Run &run : runs)
+		{
+			for (int i = run.first; i >= 0; i = next[i])
+			{
+				const DeferredStreamDraw &draw = state.draws[i];
+				StreamVertexData d = requestImmediateStreamDraw(draw.command);
+
+				for (int j = 0; j < 2; j++)
+				{
+					size_t size = vertex::getFormatStride(draw.command.formats[j]) * draw.command.vertexCount;
+					if (size > 0)
+						memcpy(d.stream[j], &state.data[j][draw.dataOffsets[j]], size);
+				}
+			}
+		}
+	}
+	catch (love::Exception &)
+	{
+		reset();
+		throw;
+	}
+
+	reset();
+}
+
+Graphics::StreamVertexData Graphics::requestImmediateStreamDraw(const StreamDrawCommand &cmd)
 {
 	using namespace vertex;
 
@@ -987,23 +1288,40 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 	bool shouldflush = false;
 	bool shouldresize = false;
 
-	if (cmd.primitiveMode != state.primitiveMode
+	BatchBreakReason breakreason = BATCHBREAK_BUFFER;
+
+	if (cmd.texture != state.texture)
+		breakreason = BATCHBREAK_TEXTURE;
+	else if (cmd.standardShaderType != state.standardShaderType)
+		breakreason = BATCHBREAK_SHADER;
+	else if (cmd.primitiveMode != state.primitiveMode
 		|| cmd.formats[0] != state.formats[0] || cmd.formats[1] != state.formats[1]
-		|| ((cmd.indexMode != TriangleIndexMode::NONE) != (state.indexCount > 0))
-		|| cmd.texture != state.texture
-		|| cmd.standardShaderType != state.standardShaderType)
+		|| ((cmd.indexMode != TriangleIndexMode::NONE) != (state.indexCount > 0)))
 	{
-		shouldflush = true;
+		breakreason = BATCHBREAK_FORMAT;
 	}
 
+	if (breakreason != BATCHBREAK_BUFFER)
+		shouldflush = true;
+
 	int totalvertices = state.vertexCount + cmd.vertexCount;
+	size_t indexsize = getIndexDataSize(state.indexType);
 
-	// We only support uint16 index buffers for now.
+	// uint16 indices can't address more than 65536 vertices. Batches which
+	// grow past that switch to uint32 indices when they're supported.
 	if (totalvertices > LOVE_UINT16_MAX && cmd.indexMode != TriangleIndexMode::NONE)
-		shouldflush = true;
+	{
+		if (isUInt32IndexSupported())
+			indexsize = sizeof(uint32);
+		else
+			shouldflush = true;
+	}
 
 	int reqIndexCount = getIndexCount(cmd.indexMode, cmd.vertexCount);
-	size_t reqIndexSize = reqIndexCount * sizeof(uint16);
+
+	// Batches made only of quads are drawn with the persistent quad index
+	// buffer, so their indices don't need to be generated and uploaded.
+	bool quadindices = isQuadIndexBatch(cmd, shouldflush);
 
 	size_t newdatasizes[2] = {0, 0};
 	size_t buffersizes[3] = {0, 0, 0};
@@ -1028,9 +1346,9 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 		newdatasizes[i] = stride * cmd.vertexCount;
 	}
 
-	if (cmd.indexMode != TriangleIndexMode::NONE)
+	if (cmd.indexMode != TriangleIndexMode::NONE && !quadindices)
 	{
-		size_t datasize = (state.indexCount + reqIndexCount) * sizeof(uint16);
+		size_t datasize = (state.indexCount + reqIndexCount) * indexsize;
 
 		if (state.indexBufferMap.data != nullptr && datasize > state.indexBufferMap.size)
 			shouldflush = true;
@@ -1044,6 +1362,7 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 
 	if (shouldflush || shouldresize)
 	{
+		profileState.flushReason = breakreason;
 		flushStreamDraws();
 
 		state.primitiveMode = cmd.primitiveMode;
@@ -1064,26 +1383,63 @@ Graphics::StreamVertexData Graphics::requestStreamDraw(const StreamDrawCommand &
 		for (int i = 0; i < 2; i++)
 		{
 			if (state.vb[i]->getSize() < buffersizes[i])
-			{
-				delete state.vb[i];
-				state.vb[i] = newStreamBuffer(BUFFER_VERTEX, buffersizes[i]);
-			}
+				state.vb[i]->resize(buffersizes[i]);
 		}
 
 		if (state.indexBuffer->getSize() < buffersizes[2])
-		{
-			delete state.indexBuffer;
-			state.indexBuffer = newStreamBuffer(BUFFER_INDEX, buffersizes[2]);
-		}
+			state.indexBuffer->resize(buffersizes[2]);
 	}
 
-	if (cmd.indexMode != TriangleIndexMode::NONE)
+	// The batch may have been flushed, which can change the above result.
+	if (cmd.indexMode != TriangleIndexMode::NONE && isQuadIndexBatch(cmd, false))
+	{
+		state.quadIndices = true;
+	}
+	else if (cmd.indexMode != TriangleIndexMode::NONE)
 	{
-		if (state.indexBufferMap.data == nullptr)
+		if (state.indexType == INDEX_UINT16 && state.vertexCount + cmd.vertexCount > LOVE_UINT16_MAX)
+		{
+			// Widen the indices already written for this batch, in place. The
+			// size checks above guarantee the mapped range is big enough.
+			if (state.indexBufferMap.data != nullptr && state.indexCount > 0)
+			{
+				uint8 *start = state.indexBufferMap.data - state.indexCount * sizeof(uint16);
+				const uint16 *src = (const uint16 *) start;
+				uint32 *dst = (uint32 *) start;
+
+				for (int i = state.indexCount - 1; i >= 0; i--)
+					dst[i] = src[i];
+
+				state.indexBufferMap.data = start + state.indexCount * sizeof(uint32);
+			}
+
+			state.indexType = INDEX_UINT32;
+		}
+
+		size_t reqIndexSize = reqIndexCount * getIndexDataSize(state.indexType);
+
+		if (state.quadIndices)
+		{
+			// The batch can't keep using the quad index buffer, so the indices
+			// for the quads drawn so far have to be written out now.
+			size_t quadIndexSize = state.indexCount * getIndexDataSize(state.indexType);
+			state.indexBufferMap = state.indexBuffer->map(quadIndexSize + reqIndexSize);
+
+			if (state.indexType == INDEX_UINT32)
+				fillIndices(TriangleIndexMode::QUADS, (uint32) 0, (uint32) state.vertexCount, (uint32 *) state.indexBufferMap.data);
+			else
+				fillIndices(TriangleIndexMode::QUADS, (uint16) 0, (uint16) state.vertexCount, (uint16 *) state.indexBufferMap.data);
+
+			state.indexBufferMap.data += quadIndexSize;
+			state.quadIndices = false;
+		}
+		else if (state.indexBufferMap.data == nullptr)
 			state.indexBufferMap = state.indexBuffer->map(reqIndexSize);
 
-		uint16 *indices = (uint16 *) state.indexBufferMap.data;
-		fillIndices(cmd.indexMode, state.vertexCount, cmd.vertexCount, indices);
+		if (state.indexType == INDEX_UINT32)
+			fillIndices(cmd.indexMode, (uint32) state.vertexCount, (uint32) cmd.vertexCount, (uint32 *) state.indexBufferMap.data);
+		else
+			fillIndices(cmd.indexMode, (uint16) state.vertexCount, (uint16) cmd.vertexCount, (uint16 *) state.indexBufferMap.data);
 
 		state.indexBufferMap.data += reqIndexSize;
 	}
@@ -1116,11 +1472,19 @@ void Graphics::flushStreamDraws()
 {
 	using namespace vertex;
 
+	if (!deferredStreamState.draws.empty() && !deferredStreamState.submitting)
+		submitDeferredStreamDraws();
+
 	auto &sbstate = streamBufferState;
 
+	BatchBreakReason breakreason = profileState.flushReason;
+	profileState.flushReason = BATCHBREAK_STATE;
+
 	if (sbstate.vertexCount == 0 && sbstate.indexCount == 0)
 		return;
 
+	profileState.current.profile.batchBreaks[breakreason]++;
+
 	Attributes attributes;
 	Buffers buffers;
 
@@ -1149,14 +1513,18 @@ void Graphics::flushStreamDraws()
 
 	pushIdentityTransform();
 
-	if (sbstate.indexCount > 0)
+	if (sbstate.quadIndices)
+	{
+		drawQuads(0, sbstate.vertexCount / 4, attributes, buffers, sbstate.texture);
+	}
+	else if (sbstate.indexCount > 0)
 	{
-		usedsizes[2] = sizeof(uint16) * sbstate.indexCount;
+		usedsizes[2] = getIndexDataSize(sbstate.indexType) * sbstate.indexCount;
 
 		DrawIndexedCommand cmd(&attributes, &buffers, sbstate.indexBuffer);
 		cmd.primitiveType = sbstate.primitiveMode;
 		cmd.indexCount = sbstate.indexCount;
-		cmd.indexType = INDEX_UINT16;
+		cmd.indexType = sbstate.indexType;
 		cmd.indexBufferOffset = sbstate.indexBuffer->unmap(usedsizes[2]);
 		cmd.texture = sbstate.texture;
 		draw(cmd);
@@ -1189,6 +1557,23 @@ void Graphics::flushStreamDraws()
 
 	streamBufferState.vertexCount = 0;
 	streamBufferState.indexCount = 0;
+	streamBufferState.indexType = INDEX_UINT16;
+	streamBufferState.quadIndices = false;
+}
+
+bool Graphics::isQuadIndexBatch(const StreamDrawCommand &cmd, bool newbatch) const
+{
+	const StreamBufferState &state = streamBufferState;
+
+	if (cmd.indexMode != vertex::TriangleIndexMode::QUADS || quadIndexBuffer == nullptr)
+		return false;
+
+	if (newbatch || state.vertexCount == 0)
+		return cmd.vertexCount <= LOVE_UINT16_MAX;
+
+	// Past the range of the quad index buffer, a single draw with streamed
+	// uint32 indices is preferred over splitting the batch.
+	return state.quadIndices && state.vertexCount + cmd.vertexCount <= LOVE_UINT16_MAX;
 }
 
 void Graphics::flushStreamDrawsGlobal()
@@ -1314,13 +1699,37 @@ int Graphics::calculateEllipsePoints(float rx, float ry) const
 	return std::max(points, 8);
 }
 
+const Vector2 *Graphics::getUnitCircle(int points)
+{
+	auto it = unitCircles.find(points);
+	if (it != unitCircles.end())
+		return it->second.data();
+
+	// Don't let lots of different segment counts grow the cache forever.
+	if (unitCircles.size() >= MAX_UNIT_CIRCLES)
+		unitCircles.clear();
+
+	std::vector<Vector2> &circle = unitCircles[points];
+	circle.resize(points + 1);
+
+	for (int i = 0; i < points; i++)
+	{
+		double phi = (LOVE_M_PI * 2.0) * i / points;
+		circle[i] = Vector2((float) cos(phi), (float) sin(phi));
+	}
+
+	circle[points] = circle[0];
+
+	return circle.data();
+}
+
 void Graphics::polyline(const Vector2 *vertices, size_t count)
 {
 	float halfwidth = getLineWidth() * 0.5f;
 	LineJoin linejoin = getLineJoin();
 	LineStyle linestyle = getLineStyle();
 
-	float pixelsize = 1.0f / std::max((float) pixelScaleStack.back(), 0.000001f);
+	float pixelsize = 1.0f / std::max((float) getCurrentPixelScale(), 0.000001f);
 
 	if (linejoin == LINE_JOIN_NONE)
 	{
@@ -1365,41 +1774,39 @@ void Graphics::rectangle(DrawMode mode, float x, float y, float w, float h, floa
 
 	points = std::max(points / 4, 1);
 
-	const float half_pi = static_cast<float>(LOVE_M_PI / 2);
-	float angle_shift = half_pi / ((float) points + 1.0f);
+	// Each corner is a quarter of a circle with points + 1 segments.
+	int segments = points + 1;
+	const Vector2 *unit = getUnitCircle(segments * 4);
 
 	int num_coords = (points + 2) * 4;
 	Vector2 *coords = getScratchBuffer<Vector2>(num_coords + 1);
-	float phi = .0f;
 
-	for (int i = 0; i <= points + 2; ++i, phi += angle_shift)
+	for (int i = 0; i <= segments; ++i)
 	{
-		coords[i].x = x + rx * (1 - cosf(phi));
-		coords[i].y = y + ry * (1 - sinf(phi));
+		const Vector2 &c = unit[i];
+		coords[i].x = x + rx * (1 - c.x);
+		coords[i].y = y + ry * (1 - c.y);
 	}
 
-	phi = half_pi;
-
-	for (int i = points + 2; i <= 2 * (points + 2); ++i, phi += angle_shift)
+	for (int i = 0; i <= segments; ++i)
 	{
-		coords[i].x = x + w - rx * (1 + cosf(phi));
-		coords[i].y = y +     ry * (1 - sinf(phi));
+		const Vector2 &c = unit[segments + i];
+		coords[(points + 2) + i].x = x + w - rx * (1 + c.x);
+		coords[(points + 2) + i].y = y +     ry * (1 - c.y);
 	}
 
-	phi = 2 * half_pi;
-
-	for (int i = 2 * (points + 2); i <= 3 * (points + 2); ++i, phi += angle_shift)
+	for (int i = 0; i <= segments; ++i)
 	{
-		coords[i].x = x + w - rx * (1 + cosf(phi));
-		coords[i].y = y + h - ry * (1 + sinf(phi));
+		const Vector2 &c = unit[2 * segments + i];
+		coords[2 * (points + 2) + i].x = x + w - rx * (1 + c.x);
+		coords[2 * (points + 2) + i].y = y + h - ry * (1 + c.y);
 	}
 
-	phi = 3 * half_pi;
-
-	for (int i = 3 * (points + 2); i <= 4 * (points + 2); ++i, phi += angle_shift)
+	for (int i = 0; i <= segments; ++i)
 	{
-		coords[i].x = x +     rx * (1 - cosf(phi));
-		coords[i].y = y + h - ry * (1 + sinf(phi));
+		const Vector2 &c = unit[3 * segments + i];
+		coords[3 * (points + 2) + i].x = x +     rx * (1 - c.x);
+		coords[3 * (points + 2) + i].y = y + h - ry * (1 + c.y);
 	}
 
 	coords[num_coords] = coords[0];
@@ -1424,10 +1831,7 @@ void Graphics::circle(DrawMode mode, float x, float y, float radius)
 
 void Graphics::ellipse(DrawMode mode, float x, float y, float a, float b, int points)
 {
-	float two_pi = (float) (LOVE_M_PI * 2);
 	if (points <= 0) points = 1;
-	float angle_shift = (two_pi / points);
-	float phi = .0f;
 
 	// 1 extra point at the end for a closed loop, and 1 extra point at the
 	// start in filled mode for the vertex in the center of the ellipse.
@@ -1443,14 +1847,14 @@ void Graphics::ellipse(DrawMode mode, float x, float y, float a, float b, int po
 		coords++;
 	}
 
-	for (int i = 0; i < points; ++i, phi += angle_shift)
+	const Vector2 *unit = getUnitCircle(points);
+
+	for (int i = 0; i <= points; ++i)
 	{
-		coords[i].x = x + a * cosf(phi);
-		coords[i].y = y + b * sinf(phi);
+		coords[i].x = x + a * unit[i].x;
+		coords[i].y = y + b * unit[i].y;
 	}
 
-	coords[points] = coords[0];
-
 	// Last argument to polygon(): don't skip the last vertex in fill mode.
 	polygon(mode, polygoncoords, points + extrapoints, false);
 }
@@ -1489,17 +1893,27 @@ void Graphics::arc(DrawMode drawmode, ArcMode arcmode, float x, float y, float r
 	if (drawmode == DRAW_FILL && arcmode == ARC_OPEN)
 		arcmode = ARC_CLOSED;
 
-	float phi = angle1;
-
 	Vector2 *coords = nullptr;
 	int num_coords = 0;
 
+	// Rotate each point by the angle between points, rather than calling
+	// cos and sin for every one of them.
+	double cos_shift = cos(angle_shift);
+	double sin_shift = sin(angle_shift);
+
 	const auto createPoints = [&](Vector2 *coordinates)
 	{
-		for (int i = 0; i <= points; ++i, phi += angle_shift)
+		double c = cos(angle1);
+		double s = sin(angle1);
+
+		for (int i = 0; i <= points; ++i)
 		{
-			coordinates[i].x = x + radius * cosf(phi);
-			coordinates[i].y = y + radius * sinf(phi);
+			coordinates[i].x = x + radius * (float) c;
+			coordinates[i].y = y + radius * (float) s;
+
+			double next_c = c * cos_shift - s * sin_shift;
+			s = s * cos_shift + c * sin_shift;
+			c = next_c;
 		}
 	};
 
@@ -1590,7 +2004,7 @@ Graphics::Stats Graphics::getStats() const
 	getAPIStats(stats.shaderSwitches);
 
 	stats.drawCalls = drawCalls;
-	if (streamBufferState.vertexCount > 0)
+	if (streamBufferState.vertexCount > 0 || !deferredStreamState.draws.empty())
 		stats.drawCalls++;
 
 	stats.canvasSwitches = canvasSwitchCount;
@@ -1599,10 +2013,370 @@ Graphics::Stats Graphics::getStats() const
 	stats.images = Image::imageCount;
 	stats.fonts = Font::fontCount;
 	stats.textureMemory = Texture::totalGraphicsMemory;
-	
+
+	stats.streamBufferStalls = 0;
+	for (const StreamBuffer *buffer : streamBufferState.vb)
+		stats.streamBufferStalls += buffer != nullptr ? buffer->getStallCount() : 0;
+	if (streamBufferState.indexBuffer != nullptr)
+		stats.streamBufferStalls += streamBufferState.indexBuffer->getStallCount();
+
+	stats.textLayoutCacheHits = Font::layoutCacheHits;
+	stats.textLayoutCacheMisses = Font::layoutCacheMisses;
+
+	stats.shaderCacheHits = Shader::programCacheHits;
+	stats.shaderCacheMisses = Shader::programCacheMisses;
+
 	return stats;
 }
 
+void Graphics::beginScope(const std::string &name)
+{
+	ProfileFrame &frame = profileState.current;
+
+	flushStreamDraws();
+
+	ProfileScope scope;
+	scope.name = name;
+	scope.depth = (int) profileState.openScopes.size();
+	scope.drawCalls = drawCalls;
+	scope.cpuTime = love::timer::Timer::getTime();
+
+	profileState.openScopes.push_back((int) frame.profile.scopes.size());
+	frame.profile.scopes.push_back(scope);
+
+	frame.queries.push_back(queryGPUTimestamp());
+	frame.queries.push_back(0);
+}
+
+void Graphics::endScope()
+{
+	if (profileState.openScopes.empty())
+		throw love::Exception("endScope called without a matching beginScope.");
+
+	ProfileFrame &frame = profileState.current;
+
+	flushStreamDraws();
+
+	int index = profileState.openScopes.back();
+	profileState.openScopes.pop_back();
+
+	ProfileScope &scope = frame.profile.scopes[index];
+	scope.drawCalls = drawCalls - scope.drawCalls;
+	scope.cpuTime = love::timer::Timer::getTime() - scope.cpuTime;
+
+	if (frame.queries[index * 2] != 0)
+		frame.queries[index * 2 + 1] = queryGPUTimestamp();
+}
+
+const Graphics::Profile &Graphics::getProfile() const
+{
+	return profileState.completed;
+}
+
+love::thread::WorkerPool *Graphics::getWorkerPool()
+{
+	if (workerPool == nullptr)
+		workerPool = new love::thread::WorkerPool();
+
+	return workerPool;
+}
+
+void Graphics::newImageAsync(love::filesystem::File *file, const Image::Settings &settings, const AsyncImageInfo &info)
+{
+	AsyncImageLoad *load = new AsyncImageLoad();
+	load->file.set(file);
+	load->settings = settings;
+	load->info = info;
+
+	addAsyncImageLoad(load);
+}
+
+void Graphics::newImageAsync(love::Data *filedata, const Image::Settings &settings, const AsyncImageInfo &info)
+{
+	AsyncImageLoad *load = new AsyncImageLoad();
+	load->fileData.set(filedata);
+	load->settings = settings;
+	load->info = info;
+
+	addAsyncImageLoad(load);
+}
+
+void Graphics::addAsyncImageLoad(AsyncImageLoad *load)
+{
+	if (Module::getInstance<love::image::Image>(M_IMAGE) == nullptr)
+	{
+		delete load;
+		throw love::Exception("Cannot load images without the love.image module.");
+	}
+
+	asyncImageLoads.push_back(load);
+	startAsyncImageLoads();
+}
+
+void Graphics::setAsyncImageBudget(size_t bytes)
+{
+	asyncImageBudget = bytes;
+}
+
+size_t Graphics::getAsyncImageBudget() const
+{
+	return asyncImageBudget;
+}
+
+int Graphics::getAsyncImageCount() const
+{
+	return (int) asyncImageLoads.size();
+}
+
+void Graphics::startAsyncImageLoads()
+{
+	if (asyncImageLoads.empty())
+		return;
+
+	auto pool = getWorkerPool();
+	auto imagemodule = Module::getInstance<love::image::Image>(M_IMAGE);
+
+	// Decoding more images at once than there are workers would only hold on
+	// to more memory.
+	int maxdecoding = std::max(pool->getWorkerCount(), 1);
+
+	std::vector<AsyncImageLoad *> started;
+
+	{
+		thread::Lock lock(asyncImageMutex);
+
+		for (AsyncImageLoad *load : asyncImageLoads)
+		{
+			if (asyncImagesDecoding >= maxdecoding)
+				break;
+
+			// Always let one load through, so images bigger than the budget
+			// can still be loaded.
+			if (asyncImageMemory >= asyncImageBudget && asyncImagesDecoding > 0)
+				break;
+
+			if (load->started)
+				continue;
+
+			load->started = true;
+			asyncImagesDecoding++;
+			started.push_back(load);
+		}
+	}
+
+	// Tasks run immediately when there are no worker threads, so they can't be
+	// submitted while the lock is held.
+	for (AsyncImageLoad *load : started)
+	{
+		pool->submit([this, load, imagemodule]()
+		{
+			decodeAsyncImage(load, imagemodule);
+		});
+	}
+}
+
+void Graphics::decodeAsyncImage(AsyncImageLoad *load, love::image::Image *imagemodule)
+{
+	StrongRef<love::image::ImageData> imagedata;
+	StrongRef<love::image::CompressedImageData> compresseddata;
+	std::string error;
+
+	StrongRef<love::Data> filedata = load->fileData;
+	size_t filesize = 0;
+
+	try
+	{
+		if (filedata.get() == nullptr)
+			filedata.set(load->file->read(), Acquire::NORETAIN);
+
+		filesize = filedata->getSize();
+
+		{
+			thread::Lock lock(asyncImageMutex);
+			asyncImageMemory += filesize;
+		}
+
+		if (imagemodule->isCompressed(filedata))
+			compresseddata.set(imagemodule->newCompressedData(filedata), Acquire::NORETAIN);
+		else
+			imagedata.set(imagemodule->newImageData(filedata), Acquire::NORETAIN);
+	}
+	catch (love::Exception &e)
+	{
+		error = e.what();
+	}
+
+	// The file data isn't needed once the image is decoded.
+	filedata.set(nullptr);
+
+	thread::Lock lock(asyncImageMutex);
+
+	asyncImageMemory -= filesize;
+
+	if (imagedata.get())
+		load->memory = imagedata->getSize();
+	else if (compresseddata.get())
+		load->memory = compresseddata->getSize();
+
+	asyncImageMemory += load->memory;
+
+	load->imageData = imagedata;
+	load->compressedData = compresseddata;
+	load->error = error;
+	load->finished = true;
+}
+
+void Graphics::processAsyncImages(void *callbackdata)
+{
+	auto it = asyncImageLoads.begin();
+
+	while (it != asyncImageLoads.end())
+	{
+		AsyncImageLoad *load = *it;
+
+		{
+			thread::Lock lock(asyncImageMutex);
+			if (!load->finished)
+			{
+				++it;
+				continue;
+			}
+		}
+
+		// Remove it before calling the callback, which may add new loads or
+		// throw.
+		it = asyncImageLoads.erase(it);
+		asyncImagesDecoding--;
+
+		StrongRef<Image> image;
+		std::string error = load->error;
+
+		if (error.empty())
+		{
+			Image::Slices slices(TEXTURE_2D);
+
+			if (load->imageData.get())
+				slices.set(0, 0, load->imageData);
+			else
+				slices.add(load->compressedData, 0, 0, false, load->settings.mipmaps);
+
+			try
+			{
+				image.set(newImage(slices, load->settings), Acquire::NORETAIN);
+			}
+			catch (love::Exception &e)
+			{
+				error = e.what();
+			}
+		}
+
+		{
+			thread::Lock lock(asyncImageMutex);
+			asyncImageMemory -= load->memory;
+		}
+
+		AsyncImageInfo info = load->info;
+		delete load;
+
+		if (image.get())
+			info.callback(&info, image, nullptr, callbackdata);
+		else
+			info.callback(&info, nullptr, error.c_str(), callbackdata);
+	}
+
+	startAsyncImageLoads();
+}
+
+bool Graphics::resolveProfileFrame(ProfileFrame &frame, bool wait)
+{
+	for (size_t i = 0; i < frame.profile.scopes.size() && !frame.disjoint; i++)
+	{
+		uint32 begin = frame.queries[i * 2 + 0];
+		uint32 end = frame.queries[i * 2 + 1];
+
+		if (begin == 0 || end == 0)
+			continue;
+
+		uint64 begintime = 0;
+		uint64 endtime = 0;
+
+		if (!getGPUTimestamp(end, wait, endtime) || !getGPUTimestamp(begin, wait, begintime))
+			return false;
+
+		frame.profile.scopes[i].gpuTime = (double) (endtime - begintime) / 1000000000.0;
+	}
+
+	for (uint32 query : frame.queries)
+	{
+		if (query != 0)
+			releaseGPUTimestamp(query);
+	}
+
+	frame.queries.clear();
+	return true;
+}
+
+void Graphics::finishProfileFrame()
+{
+	ProfileState &state = profileState;
+
+	// Scopes left open at the end of the frame are closed here.
+	while (!state.openScopes.empty())
+		endScope();
+
+	state.pendingFrames.push_back(state.current);
+	state.current = ProfileFrame();
+
+	// Frames complete in order, once the GPU has caught up with them. Waiting
+	// is only done when too many frames are in flight.
+	int completed = 0;
+
+	for (ProfileFrame &frame : state.pendingFrames)
+	{
+		bool wait = (int) state.pendingFrames.size() - completed > MAX_PENDING_PROFILE_FRAMES;
+
+		if (!resolveProfileFrame(frame, wait))
+			break;
+
+		state.completed = frame.profile;
+		completed++;
+	}
+
+	state.pendingFrames.erase(state.pendingFrames.begin(), state.pendingFrames.begin() + completed);
+
+	// The disjoint flag is checked after reading results, as the extension
+	// requires. A disjoint event invalidates every timestamp that was in
+	// flight, so neither the results just read nor the pending frames' results
+	// can be trusted.
+	if (checkGPUTimestampDisjoint())
+	{
+		if (completed > 0)
+		{
+			for (auto &scope : state.completed.scopes)
+				scope.gpuTime = -1.0;
+		}
+
+		for (ProfileFrame &frame : state.pendingFrames)
+			frame.disjoint = true;
+	}
+}
+
+void Graphics::discardProfileQueries()
+{
+	// The queries are destroyed along with the context, so their results will
+	// never be available.
+	for (ProfileFrame &frame : profileState.pendingFrames)
+	{
+		frame.queries.clear();
+		profileState.completed = frame.profile;
+	}
+
+	profileState.pendingFrames.clear();
+
+	for (uint32 &query : profileState.current.queries)
+		query = 0;
+}
+
 size_t Graphics::getStackDepth() const
 {
 	return stackTypeStack.size();
@@ -1858,6 +2632,31 @@ bool Graphics::getConstant(SystemLimit in, const char *&out)
 	return systemLimits.find(in, out);
 }
 
+bool Graphics::getConstant(const char *in, BatchBreakReason &out)
+{
+	return batchBreakReasons.find(in, out);
+}
+
+bool Graphics::getConstant(BatchBreakReason in, const char *&out)
+{
+	return batchBreakReasons.find(in, out);
+}
+
+bool Graphics::getConstant(const char *in, BatchMode &out)
+{
+	return batchModes.find(in, out);
+}
+
+bool Graphics::getConstant(BatchMode in, const char *&out)
+{
+	return batchModes.find(in, out);
+}
+
+std::vector<std::string> Graphics::getConstants(BatchMode)
+{
+	return batchModes.getNames();
+}
+
 bool Graphics::getConstant(const char *in, StackType &out)
 {
 	return stackTypes.find(in, out);
@@ -1958,6 +2757,25 @@ StringMap<Graphics::SystemLimit, Graphics::LIMIT_MAX_ENUM>::Entry Graphics::syst
 
 StringMap<Graphics::SystemLimit, Graphics::LIMIT_MAX_ENUM> Graphics::systemLimits(Graphics::systemLimitEntries, sizeof(Graphics::systemLimitEntries));
 
+StringMap<Graphics::BatchBreakReason, Graphics::BATCHBREAK_MAX_ENUM>::Entry Graphics::batchBreakReasonEntries[] =
+{
+	{ "state",   BATCHBREAK_STATE   },
+	{ "texture", BATCHBREAK_TEXTURE },
+	{ "shader",  BATCHBREAK_SHADER  },
+	{ "format",  BATCHBREAK_FORMAT  },
+	{ "buffer",  BATCHBREAK_BUFFER  },
+};
+
+StringMap<Graphics::BatchBreakReason, Graphics::BATCHBREAK_MAX_ENUM> Graphics::batchBreakReasons(Graphics::batchBreakReasonEntries, sizeof(Graphics::batchBreakReasonEntries));
+
+StringMap<Graphics::BatchMode, Graphics::BATCH_MAX_ENUM>::Entry Graphics::batchModeEntries[] =
+{
+	{ "immediate", BATCH_IMMEDIATE },
+	{ "deferred",  BATCH_DEFERRED  },
+};
+
+StringMap<Graphics::BatchMode, Graphics::BATCH_MAX_ENUM> Graphics::batchModes(Graphics::batchModeEntries, sizeof(Graphics::batchModeEntries));
+
 StringMap<Graphics::StackType, Graphics::STACK_MAX_ENUM>::Entry Graphics::stackTypeEntries[] =
 {
 	{ "all",       STACK_ALL       },
@@ -46,8 +46,13 @@
 #include "font/Font.h"
 #include "video/VideoStream.h"
 #include "data/HashFunction.h"
+#include "filesystem/File.h"
+#include "image/Image.h"
+#include "thread/WorkerPool.h"
+#include "TextureArrayAtlas.h"
 
 // C++
+#include <list>
 #include <string>
 #include <vector>
 
@@ -60,6 +65,7 @@ namespace graphics
 class SpriteBatch;
 class ParticleSystem;
 class Text;
+class Path;
 class Video;
 class Buffer;
 
@@ -78,6 +84,13 @@ void setGammaCorrect(bool gammacorrect);
  **/
 bool isGammaCorrect();
 
+/**
+ * Globally sets whether linked shader programs are cached in the save
+ * directory. This should be set prior to creating the window.
+ **/
+void setShaderCacheEnabled(bool enable);
+bool isShaderCacheEnabled();
+
 /**
  * Gamma-corrects a color (converts it from sRGB to linear RGB, if
  * gamma correction is enabled.)
@@ -194,6 +207,23 @@ public:
 		STACK_MAX_ENUM
 	};
 
+	enum BatchMode
+	{
+		BATCH_IMMEDIATE,
+		BATCH_DEFERRED,
+		BATCH_MAX_ENUM
+	};
+
+	enum BatchBreakReason
+	{
+		BATCHBREAK_STATE,
+		BATCHBREAK_TEXTURE,
+		BATCHBREAK_SHADER,
+		BATCHBREAK_FORMAT,
+		BATCHBREAK_BUFFER,
+		BATCHBREAK_MAX_ENUM
+	};
+
 	enum TemporaryRenderTargetFlags
 	{
 		TEMPORARY_RT_DEPTH   = (1 << 0),
@@ -225,6 +255,42 @@ public:
 		int images;
 		int fonts;
 		int64 textureMemory;
+
+		// Number of times writing batched vertices had to wait for the GPU.
+		int streamBufferStalls;
+
+		// Number of print/printf calls which reused or regenerated text
+		// vertices.
+		int64 textLayoutCacheHits;
+		int64 textLayoutCacheMisses;
+
+		// Number of Shaders whose programs were loaded from, or were missing
+		// in, the persistent shader cache.
+		int64 shaderCacheHits;
+		int64 shaderCacheMisses;
+	};
+
+	struct ProfileScope
+	{
+		std::string name;
+		int depth = 0;
+		int drawCalls = 0;
+		double cpuTime = 0.0;
+
+		// Negative if GPU timing isn't supported.
+		double gpuTime = -1.0;
+	};
+
+	struct Profile
+	{
+		std::vector<ProfileScope> scopes;
+		int batchBreaks[BATCHBREAK_MAX_ENUM];
+
+		Profile()
+		{
+			for (int i = 0; i < BATCHBREAK_MAX_ENUM; i++)
+				batchBreaks[i] = 0;
+		}
 	};
 
 	struct ColorMask
@@ -354,6 +420,15 @@ public:
 		void *data = nullptr;
 	};
 
+	struct AsyncImageInfo;
+	typedef void (*AsyncImageCallback)(const AsyncImageInfo *info, Image *image, const char *error, void *ud);
+
+	struct AsyncImageInfo
+	{
+		AsyncImageCallback callback = nullptr;
+		void *data = nullptr;
+	};
+
 	struct RenderTargetStrongRef;
 
 	struct RenderTarget
@@ -478,7 +553,7 @@ public:
 	Font *newDefaultFont(int size, font::TrueTypeRasterizer::Hinting hinting, const Texture::Filter &filter = Texture::defaultFilter);
 	Video *newVideo(love::video::VideoStream *stream, float dpiscale);
 
-	SpriteBatch *newSpriteBatch(Texture *texture, int size, vertex::Usage usage);
+	SpriteBatch *newSpriteBatch(Texture *texture, int size, vertex::Usage usage, bool instanced);
 	ParticleSystem *newParticleSystem(Texture *texture, int size);
 
 	virtual Canvas *newCanvas(const Canvas::Settings &settings) = 0;
@@ -486,6 +561,14 @@ public:
 	ShaderStage *newShaderStage(ShaderStage::StageType stage, const std::string &source);
 	Shader *newShader(const std::string &vertex, const std::string &pixel);
 
+	/**
+	 * The optional instanced vertex source is the same vertex code with the
+	 * main function used by instanced SpriteBatches. It's compiled when the
+	 * Shader is first used to draw one.
+	 **/
+	Shader *newShader(const std::string &vertex, const std::string &pixel, const std::string &instancedvertex);
+	Shader *newInstancedShaderVariant(const std::string &vertex, ShaderStage *pixel);
+
 	virtual Buffer *newBuffer(size_t size, const void *data, BufferType type, vertex::Usage usage, uint32 mapflags) = 0;
 
 	Mesh *newMesh(const std::vector<Vertex> &vertices, PrimitiveType drawmode, vertex::Usage usage);
@@ -495,6 +578,8 @@ public:
 
 	Text *newText(Font *font, const std::vector<Font::ColoredString> &text = {});
 
+	Path *newPath(DrawMode mode);
+
 	bool validateShader(bool gles, const std::string &vertex, const std::string &pixel, std::string &err);
 
 	/**
@@ -557,6 +642,12 @@ public:
 	double getCurrentDPIScale() const;
 	double getScreenDPIScale() const;
 
+	/**
+	 * Approximate scale of the current transform, used to size the smoothed
+	 * edges of lines in screen pixels.
+	 **/
+	double getCurrentPixelScale() const;
+
 	/**
 	 * Sets the current constant color.
 	 **/
@@ -717,8 +808,59 @@ public:
 	 **/
 	bool isWireframe() const;
 
+	/**
+	 * Sets how automatically batched draws are submitted. In deferred mode,
+	 * draws are recorded and reordered at flush time so that draws sharing
+	 * the same state are merged, as long as they don't overlap.
+	 **/
+	void setBatchMode(BatchMode mode);
+	BatchMode getBatchMode() const;
+
+	/**
+	 * Sets whether small Images drawn with the default shader are drawn from
+	 * copies in shared array textures, so draws of different Images with the
+	 * same size and format don't break batches. Disabling it frees the copies.
+	 **/
+	void setAutoBatching(bool enable);
+	bool isAutoBatching() const;
+
+	/**
+	 * Gets the array textures used for automatic batching. They're created on
+	 * first use.
+	 **/
+	TextureArrayAtlas *getTextureArrayAtlas();
+
 	void captureScreenshot(const ScreenshotInfo &info);
 
+	/**
+	 * Reads back the pixels of a Canvas without waiting for the GPU. The
+	 * callback is called from present() once the GPU has finished rendering
+	 * to the Canvas, usually a frame or two later.
+	 **/
+	virtual void captureCanvas(Canvas *canvas, int slice, int mipmap, const Rect &rect, const ScreenshotInfo &info) = 0;
+
+	/**
+	 * Reads and decodes an image file on the worker threads. The Image is
+	 * created and passed to the callback from present() once it's ready, or
+	 * the callback gets an error message if it couldn't be loaded.
+	 **/
+	void newImageAsync(love::filesystem::File *file, const Image::Settings &settings, const AsyncImageInfo &info);
+	void newImageAsync(love::Data *filedata, const Image::Settings &settings, const AsyncImageInfo &info);
+
+	/**
+	 * Limits how much file and decoded image data async image loads can hold
+	 * at once, in bytes. Queued loads don't start until the Images of earlier
+	 * ones have been created.
+	 **/
+	void setAsyncImageBudget(size_t bytes);
+	size_t getAsyncImageBudget() const;
+
+	/**
+	 * Gets the number of async image loads whose callbacks haven't been
+	 * called yet.
+	 **/
+	int getAsyncImageCount() const;
+
 	void draw(Drawable *drawable, const Matrix4 &m);
 	void draw(Texture *texture, Quad *quad, const Matrix4 &m);
 	void drawLayer(Texture *texture, int layer, const Matrix4 &m);
@@ -848,6 +990,26 @@ public:
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * Profiling scopes measure the CPU and GPU time of everything drawn
+	 * between beginScope and endScope. Results are available in getProfile
+	 * once the GPU has finished the frame they were recorded in.
+	 **/
+	void beginScope(const std::string &name);
+	void endScope();
+
+	/**
+	 * Returns the scopes and batch break counts of the most recently completed
+	 * frame.
+	 **/
+	const Profile &getProfile() const;
+
+	/**
+	 * Gets the worker threads used to split up CPU-side work, such as updating
+	 * large ParticleSystems. They're created on first use.
+	 **/
+	love::thread::WorkerPool *getWorkerPool();
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -922,6 +1084,13 @@ public:
 	static bool getConstant(const char *in, SystemLimit &out);
 	static bool getConstant(SystemLimit in, const char *&out);
 
+	static bool getConstant(const char *in, BatchBreakReason &out);
+	static bool getConstant(BatchBreakReason in, const char *&out);
+
+	static bool getConstant(const char *in, BatchMode &out);
+	static bool getConstant(BatchMode in, const char *&out);
+	static std::vector<std::string> getConstants(BatchMode);
+
 	static bool getConstant(const char *in, StackType &out);
 	static bool getConstant(StackType in, const char *&out);
 	static std::vector<std::string> getConstants(StackType);
@@ -983,6 +1152,8 @@ protected:
 		Shader::StandardShader standardShaderType = Shader::STANDARD_DEFAULT;
 		int vertexCount = 0;
 		int indexCount = 0;
+		IndexDataType indexType = INDEX_UINT16;
+		bool quadIndices = false;
 
 		StreamBuffer::MapInfo vbMap[2];
 		StreamBuffer::MapInfo indexBufferMap = StreamBuffer::MapInfo();
@@ -995,6 +1166,62 @@ protected:
 		}
 	};
 
+	struct DeferredStreamDraw
+	{
+		StreamDrawCommand command;
+		StrongRef<Texture> texture;
+		size_t dataOffsets[2];
+		float bounds[4];
+	};
+
+	struct DeferredStreamState
+	{
+		std::vector<DeferredStreamDraw> draws;
+		std::vector<uint8> data[2];
+		bool submitting = false;
+	};
+
+	struct ProfileFrame
+	{
+		Profile profile;
+
+		// Two GPU timestamp queries per scope, or 0 if unsupported.
+		std::vector<uint32> queries;
+
+		// Set when the GPU reported a disjoint event while the frame's queries
+		// were in flight. Its timings are unreliable and aren't reported.
+		bool disjoint = false;
+	};
+
+	struct ProfileState
+	{
+		ProfileFrame current;
+		std::vector<int> openScopes;
+		std::vector<ProfileFrame> pendingFrames;
+		Profile completed;
+		BatchBreakReason flushReason = BATCHBREAK_STATE;
+	};
+
+	struct AsyncImageLoad
+	{
+		StrongRef<love::filesystem::File> file;
+		StrongRef<love::Data> fileData;
+		Image::Settings settings;
+		AsyncImageInfo info;
+
+		// Written by a worker thread while the load is started but not
+		// finished, and only read once it's finished.
+		StrongRef<love::image::ImageData> imageData;
+		StrongRef<love::image::CompressedImageData> compressedData;
+		std::string error;
+
+		// Bytes counted against the async image budget.
+		size_t memory = 0;
+
+		bool started = false;
+		bool finished = false;
+	};
+
 	struct TemporaryCanvas
 	{
 		Canvas *canvas;
@@ -1014,6 +1241,24 @@ protected:
 
 	virtual void initCapabilities() = 0;
 	virtual void getAPIStats(int &shaderswitches) const = 0;
+	virtual bool isUInt32IndexSupported() const = 0;
+
+	// GPU timestamp queries for profiling scopes. A query value of 0 means
+	// timestamps aren't supported.
+	virtual uint32 queryGPUTimestamp() = 0;
+	virtual bool getGPUTimestamp(uint32 query, bool wait, uint64 &nanoseconds) = 0;
+	virtual void releaseGPUTimestamp(uint32 query) = 0;
+
+	// Returns whether an event (e.g. a GPU frequency change) invalidated the
+	// timestamp queries in flight since the last call, and resets the flag.
+	virtual bool checkGPUTimestampDisjoint() = 0;
+
+	void finishProfileFrame();
+
+	// Creates the Images of finished async loads, calls their callbacks, and
+	// starts queued loads.
+	void processAsyncImages(void *callbackdata);
+	void discardProfileQueries();
 
 	void createQuadIndexBuffer();
 
@@ -1042,6 +1287,16 @@ protected:
 
 	StreamBufferState streamBufferState;
 
+	BatchMode batchMode;
+	DeferredStreamState deferredStreamState;
+
+	ProfileState profileState;
+
+	love::thread::WorkerPool *workerPool;
+
+	bool autoBatching;
+	TextureArrayAtlas *textureArrayAtlas;
+
 	std::vector<Matrix4> transformStack;
 	Matrix4 projectionMatrix;
 
@@ -1064,16 +1319,42 @@ protected:
 
 	static const size_t MAX_USER_STACK_DEPTH = 128;
 	static const int MAX_TEMPORARY_CANVAS_UNUSED_FRAMES = 16;
+	static const int MAX_PENDING_PROFILE_FRAMES = 3;
 
 private:
 
 	void checkSetDefaultFont();
+
+	StreamVertexData requestImmediateStreamDraw(const StreamDrawCommand &command);
+	StreamVertexData requestDeferredStreamDraw(const StreamDrawCommand &command);
+	bool isQuadIndexBatch(const StreamDrawCommand &command, bool newbatch) const;
+	void submitDeferredStreamDraws();
+
+	bool resolveProfileFrame(ProfileFrame &frame, bool wait);
+	void addAsyncImageLoad(AsyncImageLoad *load);
+	void startAsyncImageLoads();
+	void decodeAsyncImage(AsyncImageLoad *load, love::image::Image *imagemodule);
 	int calculateEllipsePoints(float rx, float ry) const;
+	const Vector2 *getUnitCircle(int points);
 
 	std::vector<uint8> scratchBuffer;
 
+	// Points on the unit circle for each segment count, shared by ellipses
+	// and rounded rectangles. The last point is the same as the first.
+	std::unordered_map<int, std::vector<Vector2>> unitCircles;
+	static const size_t MAX_UNIT_CIRCLES = 256;
+
 	std::unordered_map<std::string, ShaderStage *> cachedShaderStages[ShaderStage::STAGE_MAX_ENUM];
 
+	// Loads are kept in the order they were added, and the list is only
+	// touched by the main thread. The mutex guards each load's results and
+	// finished flag, and asyncImageMemory.
+	std::list<AsyncImageLoad *> asyncImageLoads;
+	love::thread::MutexRef asyncImageMutex;
+	size_t asyncImageBudget;
+	size_t asyncImageMemory;
+	int asyncImagesDecoding;
+
 	static StringMap<DrawMode, DRAW_MAX_ENUM>::Entry drawModeEntries[];
 	static StringMap<DrawMode, DRAW_MAX_ENUM> drawModes;
 
@@ -1098,6 +1379,12 @@ private:
 	static StringMap<SystemLimit, LIMIT_MAX_ENUM>::Entry systemLimitEntries[];
 	static StringMap<SystemLimit, LIMIT_MAX_ENUM> systemLimits;
 
+	static StringMap<BatchBreakReason, BATCHBREAK_MAX_ENUM>::Entry batchBreakReasonEntries[];
+	static StringMap<BatchBreakReason, BATCHBREAK_MAX_ENUM> batchBreakReasons;
+
+	static StringMap<BatchMode, BATCH_MAX_ENUM>::Entry batchModeEntries[];
+	static StringMap<BatchMode, BATCH_MAX_ENUM> batchModes;
+
 	static StringMap<StackType, STACK_MAX_ENUM>::Entry stackTypeEntries[];
 	static StringMap<StackType, STACK_MAX_ENUM> stackTypes;
 
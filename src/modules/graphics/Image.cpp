@@ -40,6 +40,9 @@ Image::Image(const Slices &data, const Settings &settings, bool validatedata)
 	, mipmapsType(settings.mipmaps ? MIPMAPS_GENERATED : MIPMAPS_NONE)
 	, sRGB(isGammaCorrect() && !settings.linear)
 	, usingDefaultTexture(false)
+	, arrayPage(-1)
+	, arrayLayer(-1)
+	, arrayBatchable(true)
 {
 	if (validatedata && data.validate() == MIPMAPS_DATA)
 		mipmapsType = MIPMAPS_DATA;
@@ -73,9 +76,36 @@ Image::Image(const Slices &slices, const Settings &settings)
 
 Image::~Image()
 {
+	if (arrayPage >= 0)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (gfx != nullptr)
+			gfx->getTextureArrayAtlas()->removeImage(this);
+	}
+
 	--imageCount;
 }
 
+void Image::draw(Graphics *gfx, Quad *q, const Matrix4 &m)
+{
+	// Custom shaders expect a 2D MainTex, so they always get the Image itself.
+	if (texType == TEXTURE_2D && gfx->isAutoBatching() && Shader::isDefaultActive())
+	{
+		int layer = 0;
+		Image *array = gfx->getTextureArrayAtlas()->getArray(this, layer);
+
+		if (array != nullptr)
+		{
+			// The layer has the same size as this Image, so the Quad's texture
+			// coordinates can be used as-is.
+			array->drawLayer(gfx, layer, q, m);
+			return;
+		}
+	}
+
+	Texture::draw(gfx, q, m);
+}
+
 void Image::init(PixelFormat fmt, int w, int h, const Settings &settings)
 {
 	Graphics *gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
@@ -175,6 +205,22 @@ void Image::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap,
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
 		generateMipmaps();
+
+	if (arrayPage >= 0)
+	{
+		// Partial replacements aren't kept in the stored ImageData, which
+		// array copies are made from.
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		if (rect == currect)
+			gfx->getTextureArrayAtlas()->updateImage(this);
+		else
+		{
+			gfx->getTextureArrayAtlas()->removeImage(this);
+			arrayBatchable = false;
+		}
+	}
+	else if (!(rect == currect))
+		arrayBatchable = false;
 }
 
 void Image::replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps)
@@ -185,6 +231,12 @@ void Image::replacePixels(const void *data, size_t size, int slice, int mipmap,
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
 		generateMipmaps();
+
+	// The stored ImageData no longer matches the Image's contents.
+	if (arrayPage >= 0)
+		Module::getInstance<Graphics>(Module::M_GRAPHICS)->getTextureArrayAtlas()->removeImage(this);
+
+	arrayBatchable = false;
 }
 
 bool Image::isCompressed() const
@@ -93,6 +93,9 @@ public:
 
 	virtual ~Image();
 
+	// Drawn from a shared array texture when automatic batching is enabled.
+	void draw(Graphics *gfx, Quad *q, const Matrix4 &m) override;
+
 	void replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
 	void replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
 
@@ -131,10 +134,17 @@ protected:
 
 private:
 
+	friend class TextureArrayAtlas;
+
 	Image(const Slices &data, const Settings &settings, bool validatedata);
 
 	void init(PixelFormat fmt, int w, int h, const Settings &settings);
 
+	// Where TextureArrayAtlas keeps a copy of this Image, if anywhere.
+	int arrayPage;
+	int arrayLayer;
+	bool arrayBatchable;
+
 	static StringMap<SettingType, SETTING_MAX_ENUM>::Entry settingTypeEntries[];
 	static StringMap<SettingType, SETTING_MAX_ENUM> settingTypes;
 
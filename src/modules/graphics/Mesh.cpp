@@ -566,6 +566,50 @@ bool Mesh::getDrawRange(int &start, int &count) const
 	return true;
 }
 
+void Mesh::setBoneTransforms(const Matrix4 *transforms, int count)
+{
+	if (count < 0 || count > MAX_BONES)
+		throw love::Exception("Invalid number of bone transforms: %d (max %d).", count, MAX_BONES);
+
+	bonePalette.resize(count * 8);
+
+	for (int i = 0; i < count; i++)
+	{
+		const float *e = transforms[i].getElements();
+		float *row = &bonePalette[i * 8];
+
+		row[0] = e[0]; row[1] = e[4]; row[2] = e[12]; row[3] = 0.0f;
+		row[4] = e[1]; row[5] = e[5]; row[6] = e[13]; row[7] = 0.0f;
+	}
+}
+
+void Mesh::setBoneTransforms()
+{
+	bonePalette.clear();
+}
+
+int Mesh::getBoneCount() const
+{
+	return (int) bonePalette.size() / 8;
+}
+
+void Mesh::sendBonePalette()
+{
+	if (Shader::current == nullptr)
+		return;
+
+	const Shader::UniformInfo *info = Shader::current->getUniformInfo(Shader::BUILTIN_BONE_PALETTE);
+	if (info == nullptr || info->baseType != Shader::UNIFORM_FLOAT || info->components != 4)
+		return;
+
+	int count = std::min(info->count, (int) bonePalette.size() / 4);
+	if (count <= 0)
+		return;
+
+	memcpy(info->floats, bonePalette.data(), sizeof(float) * 4 * count);
+	Shader::current->updateUniform(info, count);
+}
+
 void Mesh::draw(Graphics *gfx, const love::Matrix4 &m)
 {
 	drawInstanced(gfx, m, 1);
@@ -581,12 +625,33 @@ void Mesh::drawInstanced(Graphics *gfx, const Matrix4 &m, int instancecount)
 
 	gfx->flushStreamDraws();
 
+	bool skinned = !bonePalette.empty();
+
+	if (skinned)
+	{
+		auto it = attachedAttributes.find("VertexBoneIndices");
+		if (it == attachedAttributes.end() || !it->second.enabled || attachedAttributes.count("VertexBoneWeights") == 0)
+			throw love::Exception("Mesh must have VertexBoneIndices and VertexBoneWeights attributes to be drawn with bone transforms.");
+
+		if (it->second.mesh->getVertexFormat()[it->second.index].type != vertex::DATA_FLOAT)
+			throw love::Exception("The VertexBoneIndices attribute must use the float data type.");
+	}
+
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	{
+		if (skinned && Shader::standardShaders[Shader::STANDARD_SKINNED] == nullptr)
+			throw love::Exception("Meshes with bone transforms are not supported on this system.");
+
+		Shader::attachDefault(skinned ? Shader::STANDARD_SKINNED : Shader::STANDARD_DEFAULT);
+	}
 
 	if (Shader::current && texture.get())
 		Shader::current->checkMainTexture(texture);
 
+	// Custom shaders can declare love_BonePalette to receive the palette too.
+	if (skinned)
+		sendBonePalette();
+
 	vertex::Attributes attributes;
 	vertex::Buffers buffers;
 
@@ -52,6 +52,9 @@ public:
 
 	static love::Type type;
 
+	// Keep in sync with love_MaxBones in wrap_GraphicsShader.lua.
+	static const int MAX_BONES = 48;
+
 	struct AttribFormat
 	{
 		std::string name;
@@ -167,6 +170,16 @@ public:
 	void setDrawRange();
 	bool getDrawRange(int &start, int &count) const;
 
+	/**
+	 * Sets the bone transform palette used to skin the Mesh's vertices on the
+	 * GPU. Vertices reference bones with the VertexBoneIndices attribute and
+	 * blend them with the VertexBoneWeights attribute. Only the 2D affine part
+	 * of each transform is used.
+	 **/
+	void setBoneTransforms(const Matrix4 *transforms, int count);
+	void setBoneTransforms();
+	int getBoneCount() const;
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
@@ -187,6 +200,7 @@ private:
 	};
 
 	void setupAttachedAttributes();
+	void sendBonePalette();
 	void calculateAttributeSizes();
 	size_t getAttributeOffset(size_t attribindex) const;
 
@@ -217,6 +231,9 @@ private:
 
 	StrongRef<Texture> texture;
 
+	// Two rows of a 2D affine transform per bone, as vec4s.
+	std::vector<float> bonePalette;
+
 }; // Mesh
 
 } // graphics
@@ -21,6 +21,7 @@
 //LOVE
 #include "common/config.h"
 #include "ParticleSystem.h"
+#include "GPUParticleSimulation.h"
 #include "Graphics.h"
 
 #include "common/math.h"
@@ -30,6 +31,15 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -39,6 +49,28 @@ namespace graphics
 namespace
 {
 
+#if defined(LOVE_SIMD_NEON)
+
+// NEON has no division or square root on 32-bit ARM, so these refine the
+// estimate instructions with two Newton-Raphson steps instead.
+inline float32x4_t reciprocal(float32x4_t x)
+{
+	float32x4_t r = vrecpeq_f32(x);
+	r = vmulq_f32(vrecpsq_f32(x, r), r);
+	r = vmulq_f32(vrecpsq_f32(x, r), r);
+	return r;
+}
+
+inline float32x4_t reciprocalSqrt(float32x4_t x)
+{
+	float32x4_t r = vrsqrteq_f32(x);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+	return r;
+}
+
+#endif
+
 love::math::RandomGenerator rng;
 
 float calculate_variation(float inner, float outer, float var)
@@ -55,12 +87,12 @@ love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
 ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, particles()
 	, texture(texture)
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
+	, simulationMode(SIMULATION_CPU)
+	, gpuSimulation(nullptr)
 	, maxParticles(0)
 	, activeParticles(0)
 	, emissionRate(0)
@@ -110,12 +142,12 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, particles()
 	, texture(p.texture)
 	, active(p.active)
 	, insertMode(p.insertMode)
+	, simulationMode(p.simulationMode)
+	, gpuSimulation(nullptr)
 	, maxParticles(p.maxParticles)
 	, activeParticles(0)
 	, emissionRate(p.emissionRate)
@@ -163,6 +195,7 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 ParticleSystem::~ParticleSystem()
 {
 	deleteBuffers();
+	delete gpuSimulation;
 }
 
 ParticleSystem *ParticleSystem::clone()
@@ -185,9 +218,12 @@ void ParticleSystem::createBuffers(size_t size)
 {
 	try
 	{
-		pFree = pMem = new Particle[size];
+		pMem = new float[size * PARTICLE_ATTRIBUTE_MAX_ENUM];
 		maxParticles = (uint32) size;
 
+		for (int i = 0; i < PARTICLE_ATTRIBUTE_MAX_ENUM; i++)
+			particles[i] = pMem + i * size;
+
 		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
 
 		size_t bytes = sizeof(Vertex) * size * 4;
@@ -207,6 +243,10 @@ void ParticleSystem::deleteBuffers()
 
 	pMem = nullptr;
 	buffer = nullptr;
+
+	for (int i = 0; i < PARTICLE_ATTRIBUTE_MAX_ENUM; i++)
+		particles[i] = nullptr;
+
 	maxParticles = 0;
 	activeParticles = 0;
 }
@@ -217,6 +257,26 @@ void ParticleSystem::setBufferSize(uint32 size)
 		throw love::Exception("Invalid buffer size");
 	deleteBuffers();
 	createBuffers(size);
+
+	if (simulationMode == SIMULATION_GPU)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+		delete gpuSimulation;
+		gpuSimulation = nullptr;
+
+		try
+		{
+			gpuSimulation = new GPUParticleSimulation(gfx, size);
+		}
+		catch (love::Exception &)
+		{
+			simulationMode = SIMULATION_CPU;
+			reset();
+			throw;
+		}
+	}
+
 	reset();
 }
 
@@ -227,46 +287,37 @@ uint32 ParticleSystem::getBufferSize() const
 
 void ParticleSystem::addParticle(float t)
 {
-	if (isFull())
-		return;
-
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
+	// In GPU mode the arrays only hold particles which haven't been spawned
+	// yet, so they count towards the limit as well.
+	uint32 count = activeParticles;
+	if (gpuSimulation != nullptr)
+		count += gpuSimulation->getCount();
 
-	switch (insertMode)
-	{
-	default:
-	case INSERT_MODE_TOP:
-		insertTop(p);
-		break;
-	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
-		break;
-	case INSERT_MODE_RANDOM:
-		insertRandom(p);
-		break;
-	}
+	if (count >= maxParticles)
+		return;
 
+	// New particles always go at the end; insertNewParticles moves them to
+	// their place in the draw order afterwards.
+	initParticle(activeParticles, t);
 	activeParticles++;
 }
 
-void ParticleSystem::initParticle(Particle *p, float t)
+void ParticleSystem::initParticle(uint32 index, float t)
 {
 	float min,max;
 
 	// Linearly interpolate between the previous and current emitter position.
 	love::Vector2 pos = prevPosition + (position - prevPosition) * t;
 
+	float plife;
 	min = particleLifeMin;
 	max = particleLifeMax;
 	if (min == max)
-		p->life = min;
+		plife = min;
 	else
-		p->life = (float) rng.random(min, max);
-	p->lifetime = p->life;
+		plife = (float) rng.random(min, max);
 
-	p->position = pos;
+	love::Vector2 ppos = pos;
 
 	min = direction - spread/2.0f;
 	max = direction + spread/2.0f;
@@ -282,15 +333,15 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(-emissionArea.x, emissionArea.x);
 		rand_y = (float) rng.random(-emissionArea.y, emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_NORMAL:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.randomNormal(emissionArea.x);
 		rand_y = (float) rng.randomNormal(emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -298,16 +349,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		rand_y = (float) rng.random(-1, 1);
 		min = emissionArea.x * (rand_x * sqrt(1 - 0.5f*pow(rand_y, 2)));
 		max = emissionArea.y * (rand_y * sqrt(1 - 0.5f*pow(rand_x, 2)));
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(0, LOVE_M_PI * 2);
 		min = cosf(rand_x) * emissionArea.x;
 		max = sinf(rand_x) * emissionArea.y;
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_RECTANGLE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -316,26 +367,26 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		if (rand_x < -rand_y)
 		{
 			min = rand_x + rand_y + emissionArea.x;
-			p->position.x += c * min - s * -emissionArea.y;
-			p->position.y += s * min + c * -emissionArea.y;
+			ppos.x += c * min - s * -emissionArea.y;
+			ppos.y += s * min + c * -emissionArea.y;
 		}
 		else if (rand_x < 0)
 		{
 			max = rand_x + emissionArea.y;
-			p->position.x += c * -emissionArea.x - s * max;
-			p->position.y += s * -emissionArea.x + c * max;
+			ppos.x += c * -emissionArea.x - s * max;
+			ppos.y += s * -emissionArea.x + c * max;
 		}
 		else if (rand_x < rand_y)
 		{
 			max = rand_x - emissionArea.y;
-			p->position.x += c * emissionArea.x - s * max;
-			p->position.y += s * emissionArea.x + c * max;
+			ppos.x += c * emissionArea.x - s * max;
+			ppos.y += s * emissionArea.x + c * max;
 		}
 		else
 		{
 			min = rand_x - rand_y - emissionArea.x;
-			p->position.x += c * min - s * emissionArea.y;
-			p->position.y += s * min + c * emissionArea.y;
+			ppos.x += c * min - s * emissionArea.y;
+			ppos.y += s * min + c * emissionArea.y;
 		}
 		break;
 	case DISTRIBUTION_NONE:
@@ -345,154 +396,170 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	// Determine if the origin of each particle is the center of the area
 	if (directionRelativeToEmissionCenter)
-		dir += atan2(p->position.y - pos.y, p->position.x - pos.x);
-
-	p->origin = pos;
+		dir += atan2(ppos.y - pos.y, ppos.x - pos.x);
 
 	min = speedMin;
 	max = speedMax;
 	float speed = (float) rng.random(min, max);
 
-	p->velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	love::Vector2 velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+
+	float *const *d = particles;
+
+	d[PARTICLE_LIFETIME][index] = plife;
+	d[PARTICLE_LIFE][index] = plife;
 
-	p->linearAcceleration.x = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
-	p->linearAcceleration.y = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
+	d[PARTICLE_POSITION_X][index] = ppos.x;
+	d[PARTICLE_POSITION_Y][index] = ppos.y;
+	d[PARTICLE_ORIGIN_X][index] = pos.x;
+	d[PARTICLE_ORIGIN_Y][index] = pos.y;
+
+	d[PARTICLE_VELOCITY_X][index] = velocity.x;
+	d[PARTICLE_VELOCITY_Y][index] = velocity.y;
+
+	d[PARTICLE_LINEAR_ACCELERATION_X][index] = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
+	d[PARTICLE_LINEAR_ACCELERATION_Y][index] = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
 
 	min = radialAccelerationMin;
 	max = radialAccelerationMax;
-	p->radialAcceleration = (float) rng.random(min, max);
+	d[PARTICLE_RADIAL_ACCELERATION][index] = (float) rng.random(min, max);
 
 	min = tangentialAccelerationMin;
 	max = tangentialAccelerationMax;
-	p->tangentialAcceleration = (float) rng.random(min, max);
+	d[PARTICLE_TANGENTIAL_ACCELERATION][index] = (float) rng.random(min, max);
 
 	min = linearDampingMin;
 	max = linearDampingMax;
-	p->linearDamping = (float) rng.random(min, max);
+	d[PARTICLE_LINEAR_DAMPING][index] = (float) rng.random(min, max);
 
-	p->sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
-	p->sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - p->sizeOffset;
-	p->size = sizes[(size_t)(p->sizeOffset - .5f) * (sizes.size() - 1)];
+	float sizeoffset = (float) rng.random(sizeVariation); // time offset for size change
+	d[PARTICLE_SIZE_OFFSET][index] = sizeoffset;
+	d[PARTICLE_SIZE_INTERVAL_SIZE][index] = (1.0f - (float) rng.random(sizeVariation)) - sizeoffset;
+	d[PARTICLE_SIZE][index] = sizes[(size_t)(sizeoffset - .5f) * (sizes.size() - 1)];
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
-	p->rotation = (float) rng.random(min, max);
+	d[PARTICLE_SPIN_START][index] = calculate_variation(spinStart, spinEnd, spinVariation);
+	d[PARTICLE_SPIN_END][index] = calculate_variation(spinEnd, spinStart, spinVariation);
+
+	float rotation = (float) rng.random(min, max);
+	d[PARTICLE_ROTATION][index] = rotation;
 
-	p->angle = p->rotation;
+	float angle = rotation;
 	if (relativeRotation)
-		p->angle += atan2f(p->velocity.y, p->velocity.x);
+		angle += atan2f(velocity.y, velocity.x);
+	d[PARTICLE_ANGLE][index] = angle;
 
-	p->color = colors[0];
+	d[PARTICLE_COLOR_R][index] = colors[0].r;
+	d[PARTICLE_COLOR_G][index] = colors[0].g;
+	d[PARTICLE_COLOR_B][index] = colors[0].b;
+	d[PARTICLE_COLOR_A][index] = colors[0].a;
 
-	p->quadIndex = 0;
+	d[PARTICLE_QUAD_INDEX][index] = 0.0f;
 }
 
-void ParticleSystem::insertTop(Particle *p)
+void ParticleSystem::insertNewParticles(uint32 first)
 {
-	if (pHead == nullptr)
+	uint32 count = activeParticles - first;
+
+	if (count == 0 || insertMode == INSERT_MODE_TOP)
+		return;
+
+	particleOrder.clear();
+	particleOrder.reserve(activeParticles);
+
+	if (insertMode == INSERT_MODE_BOTTOM)
 	{
-		pHead = p;
-		p->prev = nullptr;
+		// Each new particle goes below all others, including earlier new ones.
+		for (uint32 i = activeParticles; i > first; i--)
+			particleOrder.push_back(i - 1);
+
+		for (uint32 i = 0; i < first; i++)
+			particleOrder.push_back(i);
 	}
 	else
 	{
-		pTail->next = p;
-		p->prev = pTail;
-	}
-	p->next = nullptr;
-	pTail = p;
-}
+		// Pick a random slot among the existing particles for each new one,
+		// then merge them in a single pass.
+		std::vector<std::pair<uint32, uint32>> slots(count);
 
-void ParticleSystem::insertBottom(Particle *p)
-{
-	if (pTail == nullptr)
-	{
-		pTail = p;
-		p->next = nullptr;
+		for (uint32 i = 0; i < count; i++)
+		{
+			// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
+			slots[i].first = (uint32) (rng.rand() % ((uint64) first + 1));
+			slots[i].second = first + i;
+		}
+
+		std::stable_sort(slots.begin(), slots.end(), [](const std::pair<uint32, uint32> &a, const std::pair<uint32, uint32> &b)
+		{
+			return a.first < b.first;
+		});
+
+		uint32 next = 0;
+		for (const auto &slot : slots)
+		{
+			while (next < slot.first)
+				particleOrder.push_back(next++);
+			particleOrder.push_back(slot.second);
+		}
+
+		while (next < first)
+			particleOrder.push_back(next++);
 	}
-	else
+
+	particleScratch.resize(activeParticles);
+
+	for (int a = 0; a < PARTICLE_ATTRIBUTE_MAX_ENUM; a++)
 	{
-		pHead->prev = p;
-		p->next = pHead;
+		float *values = particles[a];
+
+		for (uint32 i = 0; i < activeParticles; i++)
+			particleScratch[i] = values[particleOrder[i]];
+
+		memcpy(values, particleScratch.data(), sizeof(float) * activeParticles);
 	}
-	p->prev = nullptr;
-	pHead = p;
 }
 
-void ParticleSystem::insertRandom(Particle *p)
+void ParticleSystem::removeDeadParticles()
 {
-	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
-	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
+	const float *life = particles[PARTICLE_LIFE];
 
-	// Special case where the particle gets inserted before the head.
-	if (pos == activeParticles)
-	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
+	uint32 first = 0;
+	while (first < activeParticles && life[first] > 0.0f)
+		first++;
+
+	if (first == activeParticles)
 		return;
-	}
 
-	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
-	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
-}
+	// Shift the remaining live particles down, one attribute at a time. The
+	// life values decide what's kept, so they're shifted last.
+	uint32 count = first;
 
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
-{
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
+	for (int a = 0; a < PARTICLE_ATTRIBUTE_MAX_ENUM; a++)
+	{
+		if (a == PARTICLE_LIFE)
+			continue;
 
-	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
-	else
-		pHead = p->next;
+		float *values = particles[a];
+		count = first;
 
-	if (p->next)
-	{
-		p->next->prev = p->prev;
-		pNext = p->next;
+		for (uint32 i = first; i < activeParticles; i++)
+		{
+			if (life[i] > 0.0f)
+				values[count++] = values[i];
+		}
 	}
-	else
-		pTail = p->prev;
-
-	// The (in memory) last particle can now be moved into the free slot.
-	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
-	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
 
-		if (p->prev)
-			p->prev->next = p;
-		else
-			pHead = p;
+	float *values = particles[PARTICLE_LIFE];
+	count = first;
 
-		if (p->next)
-			p->next->prev = p;
-		else
-			pTail = p;
+	for (uint32 i = first; i < activeParticles; i++)
+	{
+		if (values[i] > 0.0f)
+			values[count++] = values[i];
 	}
 
-	activeParticles--;
-	return pNext;
+	activeParticles = count;
 }
 
 void ParticleSystem::setTexture(Texture *tex)
@@ -513,6 +580,9 @@ Texture *ParticleSystem::getTexture() const
 
 void ParticleSystem::setInsertMode(InsertMode mode)
 {
+	if (gpuSimulation != nullptr && mode != INSERT_MODE_TOP)
+		throw love::Exception("GPU-simulated ParticleSystems only support the 'top' insert mode.");
+
 	insertMode = mode;
 }
 
@@ -521,6 +591,37 @@ ParticleSystem::InsertMode ParticleSystem::getInsertMode() const
 	return insertMode;
 }
 
+void ParticleSystem::setSimulationMode(SimulationMode mode)
+{
+	if (mode == simulationMode)
+		return;
+
+	if (mode == SIMULATION_GPU)
+	{
+		if (insertMode != INSERT_MODE_TOP)
+			throw love::Exception("GPU-simulated ParticleSystems only support the 'top' insert mode.");
+
+		if (quads.size() > (size_t) GPUParticleSimulation::MAX_QUADS)
+			throw love::Exception("GPU-simulated ParticleSystems can use at most %d Quads.", GPUParticleSimulation::MAX_QUADS);
+
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		gpuSimulation = new GPUParticleSimulation(gfx, maxParticles);
+	}
+	else
+	{
+		delete gpuSimulation;
+		gpuSimulation = nullptr;
+	}
+
+	simulationMode = mode;
+	reset();
+}
+
+ParticleSystem::SimulationMode ParticleSystem::getSimulationMode() const
+{
+	return simulationMode;
+}
+
 void ParticleSystem::setEmissionRate(float rate)
 {
 	if (rate < 0.0f)
@@ -797,6 +898,9 @@ std::vector<Colorf> ParticleSystem::getColor() const
 
 void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 {
+	if (gpuSimulation != nullptr && newQuads.size() > (size_t) GPUParticleSimulation::MAX_QUADS)
+		throw love::Exception("GPU-simulated ParticleSystems can use at most %d Quads.", GPUParticleSimulation::MAX_QUADS);
+
 	std::vector<StrongRef<Quad>> quadlist;
 	quadlist.reserve(newQuads.size());
 
@@ -837,6 +941,9 @@ bool ParticleSystem::hasRelativeRotation() const
 
 uint32 ParticleSystem::getCount() const
 {
+	if (gpuSimulation != nullptr)
+		return gpuSimulation->getCount();
+
 	return activeParticles;
 }
 
@@ -862,12 +969,12 @@ void ParticleSystem::reset()
 	if (pMem == nullptr)
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
 	activeParticles = 0;
 	life = lifetime;
 	emitCounter = 0;
+
+	if (gpuSimulation != nullptr)
+		gpuSimulation->reset();
 }
 
 void ParticleSystem::emit(uint32 num)
@@ -875,10 +982,20 @@ void ParticleSystem::emit(uint32 num)
 	if (!active)
 		return;
 
-	num = std::min(num, maxParticles - activeParticles);
+	num = std::min(num, maxParticles - getCount());
+
+	uint32 first = activeParticles;
 
 	while (num--)
 		addParticle(1.0f);
+
+	if (gpuSimulation != nullptr)
+	{
+		gpuSimulation->spawn(particles, activeParticles);
+		activeParticles = 0;
+	}
+	else
+		insertNewParticles(first);
 }
 
 bool ParticleSystem::isActive() const
@@ -898,12 +1015,12 @@ bool ParticleSystem::isStopped() const
 
 bool ParticleSystem::isEmpty() const
 {
-	return activeParticles == 0;
+	return getCount() == 0;
 }
 
 bool ParticleSystem::isFull() const
 {
-	return activeParticles == maxParticles;
+	return getCount() >= maxParticles;
 }
 
 void ParticleSystem::update(float dt)
@@ -911,100 +1028,38 @@ void ParticleSystem::update(float dt)
 	if (pMem == nullptr || dt == 0.0f)
 		return;
 
-	// Traverse all particles and update.
-	Particle *p = pHead;
-
-	while (p)
+	if (gpuSimulation != nullptr)
 	{
-		// Decrease lifespan.
-		p->life -= dt;
+		updateGPU(dt);
+		return;
+	}
 
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
+	// Decrease lifespans and remove the particles which have run out.
+	float *plife = particles[PARTICLE_LIFE];
+	for (uint32 i = 0; i < activeParticles; i++)
+		plife[i] -= dt;
+
+	removeDeadParticles();
+
+	// Large systems are split across worker threads. Each particle only
+	// depends on its own values, so the ranges are independent.
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	if (activeParticles >= PARALLEL_UPDATE_THRESHOLD && gfx != nullptr)
+	{
+		gfx->getWorkerPool()->parallelFor((int) activeParticles, PARALLEL_UPDATE_GRAIN, [&](int start, int end)
 		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
-
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
-
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
-
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
-
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
-
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
-
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
-
-			// Modify position.
-			ppos += p->velocity * dt;
-
-			p->position = ppos;
-
-			const float t = 1.0f - p->life / p->lifetime;
-
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
-
-			p->angle = p->rotation;
-
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
-
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
-			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
-			size_t i = (size_t)s;
-			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
-			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
-
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
-			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
-
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
-
-			// Next particle.
-			p = p->next;
-		}
+			updateParticles((uint32) start, (uint32) end, dt);
+		});
 	}
+	else
+		updateParticles(0, activeParticles, dt);
 
 	// Make some more particles.
 	if (active)
 	{
+		uint32 first = activeParticles;
+
 		float rate = 1.0f / emissionRate; // the amount of time between each particle emit
 		emitCounter += dt;
 		float total = emitCounter - rate;
@@ -1014,6 +1069,37 @@ void ParticleSystem::update(float dt)
 			emitCounter -= rate;
 		}
 
+		insertNewParticles(first);
+
+		life -= dt;
+		if (lifetime != -1 && life < 0)
+			stop();
+	}
+
+	prevPosition = position;
+}
+
+void ParticleSystem::updateGPU(float dt)
+{
+	// New particles are made on the CPU as usual, and then handed to the GPU
+	// along with the step which moves the existing ones.
+	if (active)
+	{
+		float rate = 1.0f / emissionRate;
+		emitCounter += dt;
+		float total = emitCounter - rate;
+		while (emitCounter > rate)
+		{
+			addParticle(1.0f - (emitCounter - rate) / total);
+			emitCounter -= rate;
+		}
+	}
+
+	gpuSimulation->step(dt, particles, activeParticles);
+	activeParticles = 0;
+
+	if (active)
+	{
 		life -= dt;
 		if (lifetime != -1 && life < 0)
 			stop();
@@ -1022,8 +1108,220 @@ void ParticleSystem::update(float dt)
 	prevPosition = position;
 }
 
+void ParticleSystem::updateParticles(uint32 start, uint32 end, float dt)
+{
+	float *const *d = particles;
+
+	const float *lifetime = d[PARTICLE_LIFETIME];
+	const float *life = d[PARTICLE_LIFE];
+	float *posx = d[PARTICLE_POSITION_X];
+	float *posy = d[PARTICLE_POSITION_Y];
+	const float *originx = d[PARTICLE_ORIGIN_X];
+	const float *originy = d[PARTICLE_ORIGIN_Y];
+	float *velx = d[PARTICLE_VELOCITY_X];
+	float *vely = d[PARTICLE_VELOCITY_Y];
+	const float *linaccelx = d[PARTICLE_LINEAR_ACCELERATION_X];
+	const float *linaccely = d[PARTICLE_LINEAR_ACCELERATION_Y];
+	const float *radialaccel = d[PARTICLE_RADIAL_ACCELERATION];
+	const float *tangentialaccel = d[PARTICLE_TANGENTIAL_ACCELERATION];
+	const float *damping = d[PARTICLE_LINEAR_DAMPING];
+	float *rotation = d[PARTICLE_ROTATION];
+	float *angle = d[PARTICLE_ANGLE];
+	const float *spinstart = d[PARTICLE_SPIN_START];
+	const float *spinend = d[PARTICLE_SPIN_END];
+
+	uint32 i = start;
+
+	// Motion and rotation, four particles at a time where SIMD is available.
+	// The scalar loop below handles the rest.
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 vdt = _mm_set1_ps(dt);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(posx + i);
+		__m128 py = _mm_loadu_ps(posy + i);
+
+		__m128 radialx = _mm_sub_ps(px, _mm_loadu_ps(originx + i));
+		__m128 radialy = _mm_sub_ps(py, _mm_loadu_ps(originy + i));
+
+		// Particles at the origin have no radial direction.
+		__m128 lensq = _mm_add_ps(_mm_mul_ps(radialx, radialx), _mm_mul_ps(radialy, radialy));
+		__m128 invlen = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(lensq)), _mm_cmpgt_ps(lensq, zero));
+		radialx = _mm_mul_ps(radialx, invlen);
+		radialy = _mm_mul_ps(radialy, invlen);
+
+		__m128 radial = _mm_loadu_ps(radialaccel + i);
+		__m128 tangential = _mm_loadu_ps(tangentialaccel + i);
+
+		__m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(radialx, radial), _mm_mul_ps(radialy, tangential)), _mm_loadu_ps(linaccelx + i));
+		__m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(radialy, radial), _mm_mul_ps(radialx, tangential)), _mm_loadu_ps(linaccely + i));
+
+		__m128 dampingscale = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(_mm_loadu_ps(damping + i), vdt)));
+		__m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velx + i), _mm_mul_ps(ax, vdt)), dampingscale);
+		__m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vely + i), _mm_mul_ps(ay, vdt)), dampingscale);
+
+		_mm_storeu_ps(velx + i, vx);
+		_mm_storeu_ps(vely + i, vy);
+		_mm_storeu_ps(posx + i, _mm_add_ps(px, _mm_mul_ps(vx, vdt)));
+		_mm_storeu_ps(posy + i, _mm_add_ps(py, _mm_mul_ps(vy, vdt)));
+
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(life + i), _mm_loadu_ps(lifetime + i)));
+		__m128 spin = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(spinstart + i), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(spinend + i), t));
+		__m128 rot = _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(spin, vdt));
+
+		_mm_storeu_ps(rotation + i, rot);
+		_mm_storeu_ps(angle + i, rot);
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+
+	for (; i + 4 <= end; i += 4)
+	{
+		float32x4_t px = vld1q_f32(posx + i);
+		float32x4_t py = vld1q_f32(posy + i);
+
+		float32x4_t radialx = vsubq_f32(px, vld1q_f32(originx + i));
+		float32x4_t radialy = vsubq_f32(py, vld1q_f32(originy + i));
+
+		// Particles at the origin have no radial direction.
+		float32x4_t lensq = vmlaq_f32(vmulq_f32(radialx, radialx), radialy, radialy);
+		uint32x4_t nonzero = vcgtq_f32(lensq, zero);
+		float32x4_t invlen = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(reciprocalSqrt(lensq)), nonzero));
+		radialx = vmulq_f32(radialx, invlen);
+		radialy = vmulq_f32(radialy, invlen);
+
+		float32x4_t radial = vld1q_f32(radialaccel + i);
+		float32x4_t tangential = vld1q_f32(tangentialaccel + i);
+
+		float32x4_t ax = vaddq_f32(vmlsq_f32(vmulq_f32(radialx, radial), radialy, tangential), vld1q_f32(linaccelx + i));
+		float32x4_t ay = vaddq_f32(vmlaq_f32(vmulq_f32(radialy, radial), radialx, tangential), vld1q_f32(linaccely + i));
+
+		float32x4_t dampingscale = reciprocal(vmlaq_n_f32(one, vld1q_f32(damping + i), dt));
+		float32x4_t vx = vmulq_f32(vmlaq_n_f32(vld1q_f32(velx + i), ax, dt), dampingscale);
+		float32x4_t vy = vmulq_f32(vmlaq_n_f32(vld1q_f32(vely + i), ay, dt), dampingscale);
+
+		vst1q_f32(velx + i, vx);
+		vst1q_f32(vely + i, vy);
+		vst1q_f32(posx + i, vmlaq_n_f32(px, vx, dt));
+		vst1q_f32(posy + i, vmlaq_n_f32(py, vy, dt));
+
+		float32x4_t t = vsubq_f32(one, vmulq_f32(vld1q_f32(life + i), reciprocal(vld1q_f32(lifetime + i))));
+		float32x4_t spin = vmlaq_f32(vmulq_f32(vld1q_f32(spinstart + i), vsubq_f32(one, t)), vld1q_f32(spinend + i), t);
+		float32x4_t rot = vmlaq_n_f32(vld1q_f32(rotation + i), spin, dt);
+
+		vst1q_f32(rotation + i, rot);
+		vst1q_f32(angle + i, rot);
+	}
+
+#endif
+
+	for (; i < end; i++)
+	{
+		// Get vector from particle center to particle.
+		float radialx = posx[i] - originx[i];
+		float radialy = posy[i] - originy[i];
+
+		float len = sqrtf(radialx * radialx + radialy * radialy);
+		float invlen = len > 0.0f ? 1.0f / len : 0.0f;
+		radialx *= invlen;
+		radialy *= invlen;
+
+		// The tangential direction is the radial direction rotated by 90
+		// degrees.
+		float ax = radialx * radialaccel[i] - radialy * tangentialaccel[i] + linaccelx[i];
+		float ay = radialy * radialaccel[i] + radialx * tangentialaccel[i] + linaccely[i];
+
+		// Update velocity, and apply damping.
+		float dampingscale = 1.0f / (1.0f + damping[i] * dt);
+		velx[i] = (velx[i] + ax * dt) * dampingscale;
+		vely[i] = (vely[i] + ay * dt) * dampingscale;
+
+		// Modify position.
+		posx[i] += velx[i] * dt;
+		posy[i] += vely[i] * dt;
+
+		const float t = 1.0f - life[i] / lifetime[i];
+
+		// Rotate.
+		rotation[i] += (spinstart[i] * (1.0f - t) + spinend[i] * t) * dt;
+		angle[i] = rotation[i];
+	}
+
+	if (relativeRotation)
+	{
+		for (uint32 i = start; i < end; i++)
+			angle[i] += atan2f(vely[i], velx[i]);
+	}
+
+	float *size = d[PARTICLE_SIZE];
+	const float *sizeoffset = d[PARTICLE_SIZE_OFFSET];
+	const float *sizeinterval = d[PARTICLE_SIZE_INTERVAL_SIZE];
+	float *color[4] = {d[PARTICLE_COLOR_R], d[PARTICLE_COLOR_G], d[PARTICLE_COLOR_B], d[PARTICLE_COLOR_A]};
+	float *quadindex = d[PARTICLE_QUAD_INDEX];
+
+	size_t numquads = quads.size();
+
+	// Size, color and quad interpolation, which need table lookups.
+	for (uint32 i = start; i < end; i++)
+	{
+		const float t = 1.0f - life[i] / lifetime[i];
+
+		// Change size according to given intervals:
+		// i = 0       1       2      3          n-1
+		//     |-------|-------|------|--- ... ---|
+		// t = 0    1/(n-1)        3/(n-1)        1
+		//
+		// `s' is the interpolation variable scaled to the current
+		// interval width, e.g. if n = 5 and t = 0.3, then the current
+		// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+		float s = sizeoffset[i] + t * sizeinterval[i]; // size variation
+		s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
+		size_t j = (size_t)s;
+		size_t k = (j == sizes.size() - 1) ? j : j + 1; // boundary check (prevents failing on t = 1.0f)
+		s -= (float)j; // transpose s to be in interval [0:1]: j <= s < j + 1 ~> 0 <= s < 1
+		size[i] = sizes[j] * (1.0f - s) + sizes[k] * s;
+
+		// Update color according to given intervals (as above)
+		s = t * (float)(colors.size() - 1);
+		j = (size_t)s;
+		k = (j == colors.size() - 1) ? j : j + 1;
+		s -= (float)j;                            // 0 <= s <= 1
+		Colorf c = colors[j] * (1.0f - s) + colors[k] * s;
+		color[0][i] = c.r;
+		color[1][i] = c.g;
+		color[2][i] = c.b;
+		color[3][i] = c.a;
+
+		// Update the quad index.
+		if (numquads > 0)
+		{
+			s = t * (float) numquads; // [0:numquads-1] (clamped below)
+			j = (s > 0.0f) ? (size_t) s : 0;
+			quadindex[i] = (float) ((j < numquads) ? j : numquads - 1);
+		}
+	}
+}
+
 void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 {
+	if (gpuSimulation != nullptr)
+	{
+		// The simulation draws with its own shader.
+		if (!Shader::isDefaultActive())
+			throw love::Exception("Custom shaders can't be used to draw GPU-simulated ParticleSystems.");
+
+		if (texture.get() != nullptr)
+			gpuSimulation->draw(gfx, m, texture, sizes, colors, quads, offset, relativeRotation);
+		return;
+	}
+
 	uint32 pCount = getCount();
 
 	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr || buffer == nullptr)
@@ -1041,28 +1339,31 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
 	Vertex *pVerts = (Vertex *) buffer->map();
-	Particle *p = pHead;
+
+	float *const *d = particles;
 
 	bool useQuads = !quads.empty();
 
 	Matrix3 t;
 
 	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	for (uint32 i = 0; i < pCount; i++)
 	{
 		if (useQuads)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			int quadindex = (int) d[PARTICLE_QUAD_INDEX][i];
+			positions = quads[quadindex]->getVertexPositions();
+			texcoords = quads[quadindex]->getVertexTexCoords();
 		}
 
 		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
+		float size = d[PARTICLE_SIZE][i];
+		t.setTransformation(d[PARTICLE_POSITION_X][i], d[PARTICLE_POSITION_Y][i], d[PARTICLE_ANGLE][i], size, size, offset.x, offset.y, 0.0f, 0.0f);
 		t.transformXY(pVerts, positions, 4);
 
 		// Particle colors are stored as floats (0-1) but vertex colors are
 		// unsigned bytes (0-255).
-		Color c = toColor(p->color);
+		Color c = toColor(Colorf(d[PARTICLE_COLOR_R][i], d[PARTICLE_COLOR_G][i], d[PARTICLE_COLOR_B][i], d[PARTICLE_COLOR_A][i]));
 
 		// set the texture coordinate and color data for particle vertices
 		for (int v = 0; v < 4; v++)
@@ -1073,7 +1374,6 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 		}
 
 		pVerts += 4;
-		p = p->next;
 	}
 
 	Graphics::TempTransform transform(gfx, m);
@@ -1116,6 +1416,21 @@ std::vector<std::string> ParticleSystem::getConstants(InsertMode)
 	return insertModes.getNames();
 }
 
+bool ParticleSystem::getConstant(const char *in, SimulationMode &out)
+{
+	return simulationModes.find(in, out);
+}
+
+bool ParticleSystem::getConstant(SimulationMode in, const char *&out)
+{
+	return simulationModes.find(in, out);
+}
+
+std::vector<std::string> ParticleSystem::getConstants(SimulationMode)
+{
+	return simulationModes.getNames();
+}
+
 StringMap<ParticleSystem::AreaSpreadDistribution, ParticleSystem::DISTRIBUTION_MAX_ENUM>::Entry ParticleSystem::distributionsEntries[] =
 {
 	{ "none",    DISTRIBUTION_NONE },
@@ -1137,5 +1452,13 @@ StringMap<ParticleSystem::InsertMode, ParticleSystem::INSERT_MODE_MAX_ENUM>::Ent
 
 StringMap<ParticleSystem::InsertMode, ParticleSystem::INSERT_MODE_MAX_ENUM> ParticleSystem::insertModes(ParticleSystem::insertModesEntries, sizeof(ParticleSystem::insertModesEntries));
 
+StringMap<ParticleSystem::SimulationMode, ParticleSystem::SIMULATION_MAX_ENUM>::Entry ParticleSystem::simulationModesEntries[] =
+{
+	{ "cpu", SIMULATION_CPU },
+	{ "gpu", SIMULATION_GPU },
+};
+
+StringMap<ParticleSystem::SimulationMode, ParticleSystem::SIMULATION_MAX_ENUM> ParticleSystem::simulationModes(ParticleSystem::simulationModesEntries, sizeof(ParticleSystem::simulationModesEntries));
+
 } // graphics
 } // love
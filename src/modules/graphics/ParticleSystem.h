@@ -40,6 +40,7 @@ namespace graphics
 {
 
 class Graphics;
+class GPUParticleSimulation;
 
 /**
  * A class for creating, moving and drawing particles.
@@ -76,6 +77,16 @@ public:
 		INSERT_MODE_MAX_ENUM
 	};
 
+	/**
+	 * Where particles are moved: on the CPU, or in a shader on the GPU.
+	 */
+	enum SimulationMode
+	{
+		SIMULATION_CPU,
+		SIMULATION_GPU,
+		SIMULATION_MAX_ENUM
+	};
+
 	/**
 	 * Maximum numbers of particles in a ParticleSystem.
 	 * This limit comes from the fact that a quad requires four vertices and the
@@ -135,6 +146,19 @@ public:
 	 */
 	InsertMode getInsertMode() const;
 
+	/**
+	 * Sets whether particles are simulated on the CPU or the GPU. Changing
+	 * the mode removes all existing particles. GPU-simulated systems only
+	 * support the 'top' insert mode, and can't be drawn with custom shaders.
+	 * @param mode The new simulation mode.
+	 **/
+	void setSimulationMode(SimulationMode mode);
+
+	/**
+	 * Returns the current simulation mode.
+	 **/
+	SimulationMode getSimulationMode() const;
+
 	/**
 	 * Sets the emission rate.
 	 * @param rate The amount of particles per second.
@@ -521,68 +545,82 @@ public:
 	static bool getConstant(InsertMode in, const char *&out);
 	static std::vector<std::string> getConstants(InsertMode);
 
-private:
-
-	// Represents a single particle.
-	struct Particle
-	{
-		Particle *prev;
-		Particle *next;
-
-		float lifetime;
-		float life;
-
-		love::Vector2 position;
+	static bool getConstant(const char *in, SimulationMode &out);
+	static bool getConstant(SimulationMode in, const char *&out);
+	static std::vector<std::string> getConstants(SimulationMode);
 
-		// Particles gravitate towards this point.
-		love::Vector2 origin;
-
-		love::Vector2 velocity;
-		love::Vector2 linearAcceleration;
-		float radialAcceleration;
-		float tangentialAcceleration;
-
-		float linearDamping;
-
-		float size;
-		float sizeOffset;
-		float sizeIntervalSize;
-
-		float rotation; // Amount of rotation applied to the final angle.
-		float angle;
-		float spinStart;
-		float spinEnd;
+private:
 
-		Colorf color;
+	friend class GPUParticleSimulation;
 
-		int quadIndex;
+	// Per-particle values. Each one is stored in its own array, so update()
+	// can process them in tight loops.
+	enum ParticleAttribute
+	{
+		PARTICLE_LIFETIME,
+		PARTICLE_LIFE,
+		PARTICLE_POSITION_X,
+		PARTICLE_POSITION_Y,
+		PARTICLE_ORIGIN_X, // Particles gravitate towards this point.
+		PARTICLE_ORIGIN_Y,
+		PARTICLE_VELOCITY_X,
+		PARTICLE_VELOCITY_Y,
+		PARTICLE_LINEAR_ACCELERATION_X,
+		PARTICLE_LINEAR_ACCELERATION_Y,
+		PARTICLE_RADIAL_ACCELERATION,
+		PARTICLE_TANGENTIAL_ACCELERATION,
+		PARTICLE_LINEAR_DAMPING,
+		PARTICLE_SIZE,
+		PARTICLE_SIZE_OFFSET,
+		PARTICLE_SIZE_INTERVAL_SIZE,
+		PARTICLE_ROTATION, // Amount of rotation applied to the final angle.
+		PARTICLE_ANGLE,
+		PARTICLE_SPIN_START,
+		PARTICLE_SPIN_END,
+		PARTICLE_COLOR_R,
+		PARTICLE_COLOR_G,
+		PARTICLE_COLOR_B,
+		PARTICLE_COLOR_A,
+		PARTICLE_QUAD_INDEX,
+		PARTICLE_ATTRIBUTE_MAX_ENUM
 	};
 
+	// Particle counts above which update() is split across worker threads,
+	// and the number of particles given to a thread at a time.
+	static const uint32 PARALLEL_UPDATE_THRESHOLD = 8192;
+	static const int PARALLEL_UPDATE_GRAIN = 4096;
+
 	void resetOffset();
 
 	void createBuffers(size_t size);
 	void deleteBuffers();
 
 	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
 
 	// Called by addParticle.
-	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	void initParticle(uint32 index, float t);
 
-	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	// Moves particles added since 'first' to their place in the draw order,
+	// according to the insert mode. New particles are always added at the end.
+	void insertNewParticles(uint32 first);
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	// Removes particles whose life has run out, keeping the draw order.
+	void removeDeadParticles();
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	void updateParticles(uint32 start, uint32 end, float dt);
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	// Used instead of the CPU update in GPU simulation mode.
+	void updateGPU(float dt);
+
+	// Pointer to the beginning of the allocated memory.
+	float *pMem;
+
+	// Particle attribute arrays, in draw order. They all point into pMem.
+	float *particles[PARTICLE_ATTRIBUTE_MAX_ENUM];
+
+	// Scratch space used when reordering particles.
+	std::vector<uint32> particleOrder;
+	std::vector<float> particleScratch;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
@@ -593,6 +631,12 @@ private:
 	// Insert mode of new particles.
 	InsertMode insertMode;
 
+	SimulationMode simulationMode;
+
+	// Only exists in GPU simulation mode. The particle arrays then only hold
+	// particles which haven't been sent to the GPU yet.
+	GPUParticleSimulation *gpuSimulation;
+
 	// The maximum number of particles.
 	uint32 maxParticles;
 
@@ -681,6 +725,9 @@ private:
 
 	static StringMap<InsertMode, INSERT_MODE_MAX_ENUM>::Entry insertModesEntries[];
 	static StringMap<InsertMode, INSERT_MODE_MAX_ENUM> insertModes;
+
+	static StringMap<SimulationMode, SIMULATION_MAX_ENUM>::Entry simulationModesEntries[];
+	static StringMap<SimulationMode, SIMULATION_MAX_ENUM> simulationModes;
 };
 
 } // graphics
@@ -0,0 +1,601 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Path.h"
+#include "Polyline.h"
+#include "Shader.h"
+#include "common/math.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+namespace love
+{
+namespace graphics
+{
+
+// Maximum distance between a bezier curve and its flattened line segments.
+static const float BEZIER_TOLERANCE = 0.25f;
+static const int BEZIER_MAX_DEPTH = 10;
+
+static void flattenCubic(std::vector<Vector2> &out, const Vector2 &p0, const Vector2 &p1, const Vector2 &p2, const Vector2 &p3, int depth)
+{
+	// Upper bound on the distance between the curve and the line p0-p3,
+	// based on how far the control points are from it.
+	Vector2 u = p1 * 3.0f - p0 * 2.0f - p3;
+	Vector2 v = p2 * 3.0f - p3 * 2.0f - p0;
+	float d = std::max(u.x * u.x, v.x * v.x) + std::max(u.y * u.y, v.y * v.y);
+
+	if (depth >= BEZIER_MAX_DEPTH || d <= 16.0f * BEZIER_TOLERANCE * BEZIER_TOLERANCE)
+	{
+		out.push_back(p3);
+		return;
+	}
+
+	// de Casteljau subdivision at t = 0.5.
+	Vector2 p01 = (p0 + p1) * 0.5f;
+	Vector2 p12 = (p1 + p2) * 0.5f;
+	Vector2 p23 = (p2 + p3) * 0.5f;
+	Vector2 p012 = (p01 + p12) * 0.5f;
+	Vector2 p123 = (p12 + p23) * 0.5f;
+	Vector2 mid = (p012 + p123) * 0.5f;
+
+	flattenCubic(out, p0, p01, p012, mid, depth + 1);
+	flattenCubic(out, mid, p123, p23, p3, depth + 1);
+}
+
+namespace
+{
+
+struct FillEdge
+{
+	// The end with the smallest y comes first.
+	double x0, y0;
+	double x1, y1;
+	double dxdy;
+
+	// +1 if the path goes down along this edge, -1 if it goes up.
+	int winding;
+
+	double xAt(double y) const
+	{
+		return x0 + (y - y0) * dxdy;
+	}
+};
+
+struct SlabEdge
+{
+	const FillEdge *edge;
+	double top;
+	double bottom;
+};
+
+} // anonymous namespace
+
+template <typename T>
+static void addLineTriangles(const std::vector<Vector2> &coords, float halfwidth, float pixelsize, bool smooth, std::vector<vertex::XYf_STf_RGBAub> &triangles)
+{
+	T line;
+	line.render(coords.data(), coords.size(), halfwidth, pixelsize, smooth);
+	line.getTriangles(triangles);
+}
+
+static void addTriangle(const Vector2 &a, const Vector2 &b, const Vector2 &c, std::vector<vertex::XYf_STf_RGBAub> &triangles)
+{
+	Color white(255, 255, 255, 255);
+	triangles.push_back({a.x, a.y, 0.0f, 0.0f, white});
+	triangles.push_back({b.x, b.y, 0.0f, 0.0f, white});
+	triangles.push_back({c.x, c.y, 0.0f, 0.0f, white});
+}
+
+love::Type Path::type("Path", &Drawable::type);
+
+Path::Path(Graphics::DrawMode mode)
+	: drawMode(mode)
+	, fillRule(FILL_RULE_NONZERO)
+	, subPathOpen(false)
+	, vertexAttributes(vertex::CommonFormat::XYf_STf_RGBAub, 0)
+	, lineWidth(0.0f)
+	, lineJoin(Graphics::LINE_JOIN_MAX_ENUM)
+	, lineStyle(Graphics::LINE_MAX_ENUM)
+	, linePixelSize(0.0f)
+{
+}
+
+Path::~Path()
+{
+	delete fillGeometry.buffer;
+	delete lineGeometry.buffer;
+}
+
+void Path::moveTo(float x, float y)
+{
+	// Consecutive moves only keep the last one.
+	if (subPathOpen && subPaths.back().count == 1)
+	{
+		points.back() = Vector2(x, y);
+		invalidate();
+		return;
+	}
+
+	beginSubPath(Vector2(x, y));
+}
+
+void Path::lineTo(float x, float y)
+{
+	addPoint(Vector2(x, y));
+}
+
+void Path::bezierTo(float cx, float cy, float x, float y)
+{
+	// Elevate the quadratic curve to a cubic one.
+	Vector2 p0 = getCurrentPoint();
+	Vector2 c(cx, cy);
+	Vector2 p3(x, y);
+
+	if (subPaths.empty())
+		p0 = c;
+
+	Vector2 c1 = p0 + (c - p0) * (2.0f / 3.0f);
+	Vector2 c2 = p3 + (c - p3) * (2.0f / 3.0f);
+
+	bezierTo(c1.x, c1.y, c2.x, c2.y, x, y);
+}
+
+void Path::bezierTo(float cx1, float cy1, float cx2, float cy2, float x, float y)
+{
+	Vector2 c1(cx1, cy1);
+
+	// A curve without a current point starts at its first control point.
+	if (subPaths.empty())
+		beginSubPath(c1);
+
+	Vector2 p0 = getCurrentPoint();
+
+	std::vector<Vector2> curve;
+	flattenCubic(curve, p0, c1, Vector2(cx2, cy2), Vector2(x, y), 0);
+
+	for (const Vector2 &p : curve)
+		addPoint(p);
+}
+
+void Path::arc(float x, float y, float radius, float angle1, float angle2, int points)
+{
+	if (points <= 0)
+		return;
+
+	float angle_shift = (angle2 - angle1) / points;
+	float phi = angle1;
+
+	for (int i = 0; i <= points; ++i, phi += angle_shift)
+		addPoint(Vector2(x + radius * cosf(phi), y + radius * sinf(phi)));
+}
+
+void Path::arc(float x, float y, float radius, float angle1, float angle2)
+{
+	float points = std::max(sqrtf(fabsf(radius) * 20.0f), 8.0f);
+
+	// The amount of points is based on the fraction of the circle created by the arc.
+	float angle = fabsf(angle1 - angle2);
+	if (angle < 2.0f * (float) LOVE_M_PI)
+		points *= angle / (2.0f * (float) LOVE_M_PI);
+
+	arc(x, y, radius, angle1, angle2, std::max((int) (points + 0.5f), 1));
+}
+
+void Path::close()
+{
+	if (!subPathOpen)
+		return;
+
+	SubPath &subpath = subPaths.back();
+
+	// The closing line is implied.
+	if (subpath.count > 1 && points.back() == points[subpath.start])
+	{
+		points.pop_back();
+		subpath.count--;
+	}
+
+	subpath.closed = true;
+	subPathOpen = false;
+
+	invalidate();
+}
+
+void Path::clear()
+{
+	points.clear();
+	subPaths.clear();
+	subPathOpen = false;
+
+	invalidate();
+}
+
+void Path::setDrawMode(Graphics::DrawMode mode)
+{
+	drawMode = mode;
+}
+
+Graphics::DrawMode Path::getDrawMode() const
+{
+	return drawMode;
+}
+
+void Path::setFillRule(FillRule rule)
+{
+	if (rule != fillRule)
+		fillGeometry.valid = false;
+
+	fillRule = rule;
+}
+
+Path::FillRule Path::getFillRule() const
+{
+	return fillRule;
+}
+
+void Path::beginSubPath(const Vector2 &p)
+{
+	subPaths.push_back({points.size(), 1, false});
+	points.push_back(p);
+	subPathOpen = true;
+
+	invalidate();
+}
+
+void Path::addPoint(const Vector2 &p)
+{
+	if (!subPathOpen)
+	{
+		// After a close, the next subpath starts where the closed one did.
+		if (subPaths.empty())
+		{
+			beginSubPath(p);
+			return;
+		}
+
+		beginSubPath(points[subPaths.back().start]);
+	}
+
+	// Zero-length segments would break line joins.
+	if (points.back() == p)
+		return;
+
+	points.push_back(p);
+	subPaths.back().count++;
+
+	invalidate();
+}
+
+Vector2 Path::getCurrentPoint() const
+{
+	if (subPaths.empty())
+		return Vector2(0.0f, 0.0f);
+
+	if (!subPathOpen)
+		return points[subPaths.back().start];
+
+	return points.back();
+}
+
+void Path::invalidate()
+{
+	fillGeometry.valid = false;
+	lineGeometry.valid = false;
+}
+
+/**
+ * Subpaths are implicitly closed and split into horizontal slabs at every
+ * vertex and every point where two edges cross. No edges cross inside a slab,
+ * so the covered parts of a slab are trapezoids between pairs of edges, found
+ * by walking its edges from left to right while counting the winding number.
+ * This handles concave and self-intersecting paths with either fill rule.
+ **/
+void Path::tessellateFill(std::vector<vertex::XYf_STf_RGBAub> &triangles) const
+{
+	std::vector<FillEdge> edges;
+	std::vector<double> ys;
+
+	for (const SubPath &subpath : subPaths)
+	{
+		if (subpath.count < 3)
+			continue;
+
+		for (size_t i = 0; i < subpath.count; i++)
+		{
+			const Vector2 &a = points[subpath.start + i];
+			const Vector2 &b = points[subpath.start + (i + 1) % subpath.count];
+
+			// Horizontal edges don't change the winding number of any area.
+			if (a.y == b.y)
+				continue;
+
+			FillEdge e;
+
+			if (a.y < b.y)
+			{
+				e.x0 = a.x; e.y0 = a.y;
+				e.x1 = b.x; e.y1 = b.y;
+				e.winding = 1;
+			}
+			else
+			{
+				e.x0 = b.x; e.y0 = b.y;
+				e.x1 = a.x; e.y1 = a.y;
+				e.winding = -1;
+			}
+
+			e.dxdy = (e.x1 - e.x0) / (e.y1 - e.y0);
+
+			edges.push_back(e);
+			ys.push_back(e.y0);
+			ys.push_back(e.y1);
+		}
+	}
+
+	if (edges.empty())
+		return;
+
+	std::sort(ys.begin(), ys.end());
+	ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+	std::sort(edges.begin(), edges.end(), [](const FillEdge &a, const FillEdge &b)
+	{
+		return a.y0 < b.y0;
+	});
+
+	FillRule rule = fillRule;
+	auto isInside = [rule](int winding) -> bool
+	{
+		if (rule == FILL_RULE_EVENODD)
+			return (winding & 1) != 0;
+		return winding != 0;
+	};
+
+	std::vector<const FillEdge *> active;
+	std::vector<SlabEdge> slab;
+	size_t nextedge = 0;
+
+	for (size_t i = 0; i + 1 < ys.size(); i++)
+	{
+		double ya = ys[i];
+		double yb = ys[i + 1];
+
+		active.erase(std::remove_if(active.begin(), active.end(), [ya](const FillEdge *e)
+		{
+			return e->y1 <= ya;
+		}), active.end());
+
+		while (nextedge < edges.size() && edges[nextedge].y0 <= ya)
+			active.push_back(&edges[nextedge++]);
+
+		// Split the slab where edges cross, so the edges keep their order
+		// inside each part. Nearly coincident crossings are merged.
+		double minstep = (yb - ya) * 1e-5;
+		double top = ya;
+
+		while (top < yb)
+		{
+			slab.clear();
+			for (const FillEdge *e : active)
+				slab.push_back({e, e->xAt(top), e->xAt(yb)});
+
+			std::sort(slab.begin(), slab.end(), [](const SlabEdge &a, const SlabEdge &b)
+			{
+				if (a.top != b.top)
+					return a.top < b.top;
+				return a.bottom < b.bottom;
+			});
+
+			// The first crossing is always between edges that are next to
+			// each other at the top of the slab.
+			double bottom = yb;
+			for (size_t j = 0; j + 1 < slab.size(); j++)
+			{
+				const SlabEdge &l = slab[j];
+				const SlabEdge &r = slab[j + 1];
+
+				if (l.bottom > r.bottom)
+				{
+					double dtop = r.top - l.top;
+					double dbottom = r.bottom - l.bottom;
+					bottom = std::min(bottom, top + (yb - top) * dtop / (dtop - dbottom));
+				}
+			}
+
+			bottom = std::min(std::max(bottom, top + minstep), yb);
+
+			if (bottom < yb)
+			{
+				for (SlabEdge &e : slab)
+					e.bottom = e.edge->xAt(bottom);
+			}
+
+			int winding = 0;
+			const SlabEdge *left = nullptr;
+
+			for (const SlabEdge &e : slab)
+			{
+				bool wasinside = isInside(winding);
+				winding += e.edge->winding;
+				bool inside = isInside(winding);
+
+				if (!wasinside && inside)
+					left = &e;
+				else if (wasinside && !inside && left != nullptr)
+				{
+					Vector2 lt((float) left->top, (float) top);
+					Vector2 rt((float) e.top, (float) top);
+					Vector2 lb((float) left->bottom, (float) bottom);
+					Vector2 rb((float) e.bottom, (float) bottom);
+
+					if (rt.x > lt.x)
+						addTriangle(lt, rt, lb, triangles);
+					if (rb.x > lb.x)
+						addTriangle(rt, rb, lb, triangles);
+				}
+			}
+
+			top = bottom;
+		}
+	}
+}
+
+void Path::tessellateLine(std::vector<vertex::XYf_STf_RGBAub> &triangles) const
+{
+	float halfwidth = lineWidth * 0.5f;
+	bool smooth = lineStyle == Graphics::LINE_SMOOTH;
+
+	std::vector<Vector2> coords;
+
+	for (const SubPath &subpath : subPaths)
+	{
+		if (subpath.count < 2)
+			continue;
+
+		auto start = points.begin() + subpath.start;
+		coords.assign(start, start + subpath.count);
+
+		if (subpath.closed)
+			coords.push_back(coords[0]);
+
+		if (lineJoin == Graphics::LINE_JOIN_NONE)
+			addLineTriangles<NoneJoinPolyline>(coords, halfwidth, linePixelSize, smooth, triangles);
+		else if (lineJoin == Graphics::LINE_JOIN_BEVEL)
+			addLineTriangles<BevelJoinPolyline>(coords, halfwidth, linePixelSize, smooth, triangles);
+		else if (lineJoin == Graphics::LINE_JOIN_MITER)
+			addLineTriangles<MiterJoinPolyline>(coords, halfwidth, linePixelSize, smooth, triangles);
+	}
+}
+
+void Path::upload(Graphics *gfx, Geometry &geometry, const std::vector<vertex::XYf_STf_RGBAub> &triangles)
+{
+	geometry.vertexCount = 0;
+
+	size_t datasize = triangles.size() * sizeof(vertex::XYf_STf_RGBAub);
+
+	if (datasize > 0)
+	{
+		if (geometry.buffer == nullptr || datasize > geometry.buffer->getSize())
+		{
+			delete geometry.buffer;
+			geometry.buffer = nullptr;
+
+			geometry.buffer = gfx->newBuffer(datasize, triangles.data(), BUFFER_VERTEX, vertex::USAGE_DYNAMIC, Buffer::MAP_EXPLICIT_RANGE_MODIFY);
+			geometry.buffers.set(0, geometry.buffer, 0);
+		}
+		else
+			geometry.buffer->fill(0, datasize, triangles.data());
+	}
+
+	geometry.vertexCount = triangles.size();
+	geometry.valid = true;
+}
+
+void Path::draw(Graphics *gfx, const Matrix4 &m)
+{
+	Geometry &geometry = drawMode == Graphics::DRAW_FILL ? fillGeometry : lineGeometry;
+
+	if (drawMode == Graphics::DRAW_LINE)
+	{
+		// The line geometry depends on the current line state.
+		float width = gfx->getLineWidth();
+		Graphics::LineJoin join = gfx->getLineJoin();
+		Graphics::LineStyle style = gfx->getLineStyle();
+
+		// Same as Graphics::polyline, with the draw transform's scale included.
+		float sx, sy;
+		m.getApproximateScale(sx, sy);
+		float pixelscale = (float) gfx->getCurrentPixelScale() * (sx + sy) / 2.0f;
+		float pixelsize = 1.0f / std::max(pixelscale, 0.000001f);
+
+		if (width != lineWidth || join != lineJoin || style != lineStyle
+			|| (style == Graphics::LINE_SMOOTH && pixelsize != linePixelSize))
+		{
+			lineWidth = width;
+			lineJoin = join;
+			lineStyle = style;
+			linePixelSize = pixelsize;
+			lineGeometry.valid = false;
+		}
+	}
+
+	if (!geometry.valid)
+	{
+		std::vector<vertex::XYf_STf_RGBAub> triangles;
+
+		if (drawMode == Graphics::DRAW_FILL)
+			tessellateFill(triangles);
+		else
+			tessellateLine(triangles);
+
+		upload(gfx, geometry, triangles);
+	}
+
+	if (geometry.vertexCount == 0)
+		return;
+
+	gfx->flushStreamDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->checkMainTextureType(TEXTURE_2D, false);
+
+	geometry.buffer->unmap(); // Make sure all pending data is flushed to the GPU.
+
+	Graphics::TempTransform transform(gfx, m);
+
+	Graphics::DrawCommand cmd(&vertexAttributes, &geometry.buffers);
+	cmd.primitiveType = PRIMITIVE_TRIANGLES;
+	cmd.vertexCount = (int) geometry.vertexCount;
+
+	gfx->draw(cmd);
+}
+
+bool Path::getConstant(const char *in, FillRule &out)
+{
+	return fillRules.find(in, out);
+}
+
+bool Path::getConstant(FillRule in, const char *&out)
+{
+	return fillRules.find(in, out);
+}
+
+std::vector<std::string> Path::getConstants(FillRule)
+{
+	return fillRules.getNames();
+}
+
+StringMap<Path::FillRule, Path::FILL_RULE_MAX_ENUM>::Entry Path::fillRuleEntries[] =
+{
+	{ "nonzero", FILL_RULE_NONZERO },
+	{ "evenodd", FILL_RULE_EVENODD },
+};
+
+StringMap<Path::FillRule, Path::FILL_RULE_MAX_ENUM> Path::fillRules(Path::fillRuleEntries, sizeof(Path::fillRuleEntries));
+
+} // graphics
+} // love
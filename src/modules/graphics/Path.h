@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Vector.h"
+#include "common/StringMap.h"
+#include "Drawable.h"
+#include "Graphics.h"
+#include "Buffer.h"
+#include "vertex.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * A retained vector path made of lines, bezier curves and arcs. The fill and
+ * line geometry is generated when the path is drawn and kept in vertex
+ * buffers until the path is edited.
+ **/
+class Path : public Drawable
+{
+public:
+
+	enum FillRule
+	{
+		FILL_RULE_NONZERO,
+		FILL_RULE_EVENODD,
+		FILL_RULE_MAX_ENUM
+	};
+
+	static love::Type type;
+
+	Path(Graphics::DrawMode mode);
+	virtual ~Path();
+
+	/**
+	 * Starts a new subpath at the given point.
+	 **/
+	void moveTo(float x, float y);
+
+	/**
+	 * Adds a line from the current point to the given point.
+	 **/
+	void lineTo(float x, float y);
+
+	/**
+	 * Adds a quadratic bezier curve from the current point.
+	 **/
+	void bezierTo(float cx, float cy, float x, float y);
+
+	/**
+	 * Adds a cubic bezier curve from the current point.
+	 **/
+	void bezierTo(float cx1, float cy1, float cx2, float cy2, float x, float y);
+
+	/**
+	 * Adds an arc around the given center. If the path has a current point,
+	 * a line from it to the start of the arc is added first.
+	 **/
+	void arc(float x, float y, float radius, float angle1, float angle2, int points);
+	void arc(float x, float y, float radius, float angle1, float angle2);
+
+	/**
+	 * Closes the current subpath with a line back to its first point.
+	 **/
+	void close();
+
+	/**
+	 * Removes all subpaths.
+	 **/
+	void clear();
+
+	void setDrawMode(Graphics::DrawMode mode);
+	Graphics::DrawMode getDrawMode() const;
+
+	void setFillRule(FillRule rule);
+	FillRule getFillRule() const;
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+	static bool getConstant(const char *in, FillRule &out);
+	static bool getConstant(FillRule in, const char *&out);
+	static std::vector<std::string> getConstants(FillRule);
+
+private:
+
+	struct SubPath
+	{
+		size_t start;
+		size_t count;
+		bool closed;
+	};
+
+	// Generated vertices, stored in a vertex buffer.
+	struct Geometry
+	{
+		Buffer *buffer = nullptr;
+		vertex::Buffers buffers;
+		size_t vertexCount = 0;
+		bool valid = false;
+	};
+
+	void addPoint(const Vector2 &p);
+	void beginSubPath(const Vector2 &p);
+	Vector2 getCurrentPoint() const;
+
+	void tessellateFill(std::vector<vertex::XYf_STf_RGBAub> &triangles) const;
+	void tessellateLine(std::vector<vertex::XYf_STf_RGBAub> &triangles) const;
+	void upload(Graphics *gfx, Geometry &geometry, const std::vector<vertex::XYf_STf_RGBAub> &triangles);
+
+	void invalidate();
+
+	Graphics::DrawMode drawMode;
+	FillRule fillRule;
+
+	std::vector<Vector2> points;
+	std::vector<SubPath> subPaths;
+
+	// Whether the current subpath accepts more points (false after close.)
+	bool subPathOpen;
+
+	vertex::Attributes vertexAttributes;
+
+	Geometry fillGeometry;
+	Geometry lineGeometry;
+
+	// The line state the line geometry was generated with.
+	float lineWidth;
+	Graphics::LineJoin lineJoin;
+	Graphics::LineStyle lineStyle;
+	float linePixelSize;
+
+	static StringMap<FillRule, FILL_RULE_MAX_ENUM>::Entry fillRuleEntries[];
+	static StringMap<FillRule, FILL_RULE_MAX_ENUM> fillRules;
+
+}; // Path
+
+} // graphics
+} // love
@@ -24,6 +24,7 @@
 
 // C++
 #include <algorithm>
+#include <vector>
 
 // treat adjacent segments with angles between their directions <5 degree as straight
 static const float LINES_PARALLEL_EPS = 0.05f;
@@ -33,44 +34,67 @@ namespace love
 namespace graphics
 {
 
+// Scratch memory for the generated geometry, reused by every Polyline so
+// drawing a line doesn't allocate once the arrays are large enough.
+static std::vector<Vector2> scratchVectors;
+static std::vector<float> scratchLengths;
+
 void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, float halfwidth, float pixel_size, bool draw_overdraw)
 {
-	static std::vector<Vector2> anchors;
-	anchors.clear();
-	anchors.reserve(size_hint);
-
-	static std::vector<Vector2> normals;
-	normals.clear();
-	normals.reserve(size_hint);
+	// Segment directions and normals, the sleeve normals, and the sleeve and
+	// overdraw vertices (at most 4 overdraw vertices per sleeve vertex).
+	size_t segment_count = count + 1;
+	size_t scratch_size = segment_count * 2 + size_hint * 6 + 2;
+	if (scratchVectors.size() < scratch_size)
+		scratchVectors.resize(scratch_size);
+	if (scratchLengths.size() < segment_count)
+		scratchLengths.resize(segment_count);
+
+	Vector2 *dirs = scratchVectors.data();
+	Vector2 *segnormals = dirs + segment_count;
+	float *lengths = scratchLengths.data();
+
+	normals = segnormals + segment_count;
+	vertices = normals + size_hint;
+	overdraw = nullptr;
+	overdraw_vertex_count = 0;
+	overdraw_vertex_start = 0;
 
 	// prepare vertex arrays
 	if (draw_overdraw)
 		halfwidth -= pixel_size * 0.3f;
 
-	// compute sleeve
+	// Compute all segments up front, including a virtual segment before the
+	// first and after the last point. The loops have no dependencies between
+	// iterations, so the compiler is free to vectorize them.
 	bool is_looping = (coords[0] == coords[count - 1]);
-	Vector2 s;
 	if (!is_looping) // virtual starting point at second point mirrored on first point
-		s = coords[1] - coords[0];
+		dirs[0] = coords[1] - coords[0];
 	else // virtual starting point at last vertex
-		s = coords[0] - coords[count - 2];
+		dirs[0] = coords[0] - coords[count - 2];
+
+	for (size_t i = 1; i < count; i++)
+		dirs[i] = coords[i] - coords[i - 1];
 
-	float len_s = s.getLength();
-	Vector2 ns = s.getNormal(halfwidth / len_s);
+	dirs[count] = is_looping ? coords[1] - coords[0] : dirs[count - 1];
 
-	Vector2 q, r(coords[0]);
-	for (size_t i = 0; i + 1 < count; i++)
+	for (size_t i = 0; i < segment_count; i++)
+		lengths[i] = dirs[i].getLength();
+
+	for (size_t i = 0; i < segment_count; i++)
+		segnormals[i] = dirs[i].getNormal(halfwidth / lengths[i]);
+
+	// compute sleeve
+	Vector2 *verts = vertices;
+	Vector2 *norms = normals;
+	for (size_t i = 0; i < count; i++)
 	{
-		q = r;
-		r = coords[i + 1];
-		renderEdge(anchors, normals, s, len_s, ns, q, r, halfwidth);
+		renderEdge(verts, norms, coords[i],
+		           dirs[i], lengths[i], segnormals[i],
+		           dirs[i + 1], lengths[i + 1], segnormals[i + 1]);
 	}
 
-	q = r;
-	r = is_looping ? coords[1] : r + s;
-	renderEdge(anchors, normals, s, len_s, ns, q, r, halfwidth);
-
-	vertex_count = normals.size();
+	vertex_count = norms - normals;
 
 	size_t extra_vertices = 0;
 
@@ -87,16 +111,11 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	}
 
 	// Use a single linear array for both the regular and overdraw vertices.
-	vertices = new Vector2[vertex_count + extra_vertices + overdraw_vertex_count];
-
-	for (size_t i = 0; i < vertex_count; ++i)
-		vertices[i] = anchors[i] + normals[i];
-
 	if (draw_overdraw)
 	{
 		overdraw = vertices + vertex_count + extra_vertices;
 		overdraw_vertex_start = vertex_count + extra_vertices;
-		render_overdraw(normals, pixel_size, is_looping);
+		render_overdraw(pixel_size, is_looping);
 	}
 
 	// Add the degenerate triangle strip.
@@ -107,9 +126,9 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	}
 }
 
-void NoneJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
-                                Vector2 &s, float &len_s, Vector2 &ns,
-                                const Vector2 &q, const Vector2 &r, float hw)
+void NoneJoinPolyline::renderEdge(Vector2 *&verts, Vector2 *&norms, const Vector2 &q,
+                                  const Vector2 &/*s*/, float /*len_s*/, const Vector2 &ns,
+                                  const Vector2 &/*t*/, float /*len_t*/, const Vector2 &nt)
 {
 	//   ns1------ns2
 	//    |        |
@@ -117,19 +136,18 @@ void NoneJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vec
 	//    |        |
 	// (-ns1)----(-ns2)
 
-	anchors.push_back(q);
-	anchors.push_back(q);
-	normals.push_back(ns);
-	normals.push_back(-ns);
+	norms[0] = ns;
+	norms[1] = -ns;
+	norms[2] = nt;
+	norms[3] = -nt;
 
-	s     = (r - q);
-	len_s = s.getLength();
-	ns    = s.getNormal(hw / len_s);
+	verts[0] = q + ns;
+	verts[1] = q - ns;
+	verts[2] = q + nt;
+	verts[3] = q - nt;
 
-	anchors.push_back(q);
-	anchors.push_back(q);
-	normals.push_back(ns);
-	normals.push_back(-ns);
+	verts += 4;
+	norms += 4;
 }
 
 
@@ -170,36 +188,33 @@ void NoneJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vec
  *
  * the intersection points can be efficiently calculated using Cramer's rule.
  */
-void MiterJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
-                                   Vector2 &s, float &len_s, Vector2 &ns,
-                                   const Vector2 &q, const Vector2 &r, float hw)
+void MiterJoinPolyline::renderEdge(Vector2 *&verts, Vector2 *&norms, const Vector2 &q,
+                                   const Vector2 &s, float len_s, const Vector2 &ns,
+                                   const Vector2 &t, float len_t, const Vector2 &nt)
 {
-	Vector2 t    = (r - q);
-	float len_t = t.getLength();
-	Vector2 nt   = t.getNormal(hw / len_t);
-
-	anchors.push_back(q);
-	anchors.push_back(q);
+	Vector2 d;
 
 	float det = Vector2::cross(s, t);
 	if (fabs(det) / (len_s * len_t) < LINES_PARALLEL_EPS && Vector2::dot(s, t) > 0)
 	{
 		// lines parallel, compute as u1 = q + ns * w/2, u2 = q - ns * w/2
-		normals.push_back(ns);
-		normals.push_back(-ns);
+		d = ns;
 	}
 	else
 	{
 		// cramers rule
 		float lambda = Vector2::cross((nt - ns), t) / det;
-		Vector2 d = ns + s * lambda;
-		normals.push_back(d);
-		normals.push_back(-d);
+		d = ns + s * lambda;
 	}
 
-	s     = t;
-	ns    = nt;
-	len_s = len_t;
+	norms[0] = d;
+	norms[1] = -d;
+
+	verts[0] = q + d;
+	verts[1] = q - d;
+
+	verts += 2;
+	norms += 2;
 }
 
 /** Calculate line boundary points.
@@ -219,53 +234,47 @@ void MiterJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Ve
  *
  * uh1 = q + ns * w/2, uh2 = q + nt * w/2
  */
-void BevelJoinPolyline::renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
-                                   Vector2 &s, float &len_s, Vector2 &ns,
-                                   const Vector2 &q, const Vector2 &r, float hw)
+void BevelJoinPolyline::renderEdge(Vector2 *&verts, Vector2 *&norms, const Vector2 &q,
+                                   const Vector2 &s, float len_s, const Vector2 &ns,
+                                   const Vector2 &t, float len_t, const Vector2 &nt)
 {
-	Vector2 t    = (r - q);
-	float len_t = t.getLength();
-
 	float det = Vector2::cross(s, t);
 	if (fabs(det) / (len_s * len_t) < LINES_PARALLEL_EPS && Vector2::dot(s, t) > 0)
 	{
-		// lines parallel, compute as u1 = q + ns * w/2, u2 = q - ns * w/2
-		Vector2 n = t.getNormal(hw / len_t);
-		anchors.push_back(q);
-		anchors.push_back(q);
-		normals.push_back(n);
-		normals.push_back(-n);
-		s     = t;
-		len_s = len_t;
+		// lines parallel, compute as u1 = q + nt * w/2, u2 = q - nt * w/2
+		norms[0] = nt;
+		norms[1] = -nt;
+		verts[0] = q + nt;
+		verts[1] = q - nt;
+		verts += 2;
+		norms += 2;
 		return; // early out
 	}
 
 	// cramers rule
-	Vector2 nt= t.getNormal(hw / len_t);
 	float lambda = Vector2::cross((nt - ns), t) / det;
 	Vector2 d = ns + s * lambda;
 
-	anchors.push_back(q);
-	anchors.push_back(q);
-	anchors.push_back(q);
-	anchors.push_back(q);
 	if (det > 0) // 'left' turn -> intersection on the top
 	{
-		normals.push_back(d);
-		normals.push_back(-ns);
-		normals.push_back(d);
-		normals.push_back(-nt);
+		norms[0] = d;
+		norms[1] = -ns;
+		norms[2] = d;
+		norms[3] = -nt;
 	}
 	else
 	{
-		normals.push_back(ns);
-		normals.push_back(-d);
-		normals.push_back(nt);
-		normals.push_back(-d);
+		norms[0] = ns;
+		norms[1] = -d;
+		norms[2] = nt;
+		norms[3] = -d;
 	}
-	s     = t;
-	len_s = len_t;
-	ns    = nt;
+
+	for (int i = 0; i < 4; i++)
+		verts[i] = q + norms[i];
+
+	verts += 4;
+	norms += 4;
 }
 
 void Polyline::calc_overdraw_vertex_count(bool is_looping)
@@ -273,7 +282,7 @@ void Polyline::calc_overdraw_vertex_count(bool is_looping)
 	overdraw_vertex_count = 2 * vertex_count + (is_looping ? 0 : 2);
 }
 
-void Polyline::render_overdraw(const std::vector<Vector2> &normals, float pixel_size, bool is_looping)
+void Polyline::render_overdraw(float pixel_size, bool is_looping)
 {
 	// upper segment
 	for (size_t i = 0; i + 1 < vertex_count; i += 2)
@@ -319,10 +328,10 @@ void Polyline::render_overdraw(const std::vector<Vector2> &normals, float pixel_
 
 void NoneJoinPolyline::calc_overdraw_vertex_count(bool /*is_looping*/)
 {
-	overdraw_vertex_count = 4 * (vertex_count-2); // less than ideal
+	overdraw_vertex_count = 4 * (vertex_count-4);
 }
 
-void NoneJoinPolyline::render_overdraw(const std::vector<Vector2> &/*normals*/, float pixel_size, bool /*is_looping*/)
+void NoneJoinPolyline::render_overdraw(float pixel_size, bool /*is_looping*/)
 {
 	for (size_t i = 2; i + 3 < vertex_count; i += 4)
 	{
@@ -359,12 +368,6 @@ void NoneJoinPolyline::render_overdraw(const std::vector<Vector2> &/*normals*/,
 	}
 }
 
-Polyline::~Polyline()
-{
-	if (vertices)
-		delete[] vertices;
-}
-
 void Polyline::draw(love::graphics::Graphics *gfx)
 {
 	int total_vertex_count = (int) vertex_count;
@@ -397,6 +400,43 @@ void Polyline::draw(love::graphics::Graphics *gfx)
 		fill_color_array(curcolor, colordata + overdraw_vertex_start);
 }
 
+void Polyline::getTriangles(std::vector<vertex::XYf_STf_RGBAub> &triangles)
+{
+	size_t total_vertex_count = vertex_count;
+	if (overdraw)
+		total_vertex_count = overdraw_vertex_start + overdraw_vertex_count;
+
+	if (total_vertex_count < 3)
+		return;
+
+	Color white(255, 255, 255, 255);
+
+	std::vector<Color> colors(total_vertex_count, white);
+	if (overdraw)
+		fill_color_array(white, &colors[overdraw_vertex_start]);
+
+	std::vector<uint32> indices(vertex::getIndexCount(triangle_mode, (int) total_vertex_count));
+	vertex::fillIndices(triangle_mode, (uint32) 0, (uint32) total_vertex_count, indices.data());
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		const uint32 *tri = &indices[i];
+		const Vector2 &a = vertices[tri[0]];
+		const Vector2 &b = vertices[tri[1]];
+		const Vector2 &c = vertices[tri[2]];
+
+		// Skip the degenerate triangles used to stitch strips together.
+		if (a == b || b == c || a == c)
+			continue;
+
+		for (int j = 0; j < 3; j++)
+		{
+			const Vector2 &v = vertices[tri[j]];
+			triangles.push_back({v.x, v.y, 0.0f, 0.0f, colors[tri[j]]});
+		}
+	}
+}
+
 void Polyline::fill_color_array(Color constant_color, Color *colors)
 {
 	for (size_t i = 0; i < overdraw_vertex_count; ++i)
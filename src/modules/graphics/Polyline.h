@@ -46,6 +46,7 @@ public:
 
 	Polyline(vertex::TriangleIndexMode mode = vertex::TriangleIndexMode::STRIP)
 		: vertices(nullptr)
+		, normals(nullptr)
 		, overdraw(nullptr)
 		, vertex_count(0)
 		, overdraw_vertex_count(0)
@@ -53,12 +54,15 @@ public:
 		, overdraw_vertex_start(0)
 	{}
 
-	virtual ~Polyline();
+	virtual ~Polyline() {}
 
 	/**
+	 * The generated vertices are stored in scratch memory shared by all
+	 * Polylines, so only one Polyline can be rendered and drawn at a time.
+	 *
 	 * @param vertices      Vertices defining the core line segments
 	 * @param count         Number of vertices
-	 * @param size_hint     Expected number of vertices of the rendering sleeve around the core line.
+	 * @param size_hint     Maximum number of vertices of the rendering sleeve around the core line.
 	 * @param halfwidth     linewidth / 2.
 	 * @param pixel_size    Dimension of one pixel on the screen in world coordinates.
 	 * @param draw_overdraw Fake antialias the line.
@@ -69,28 +73,35 @@ public:
 	 */
 	void draw(love::graphics::Graphics *gfx);
 
+	/** Appends the rendered line to a list of triangles, with white vertex
+	 * colors, so it can be kept in a vertex buffer and drawn later.
+	 */
+	void getTriangles(std::vector<vertex::XYf_STf_RGBAub> &triangles);
+
 protected:
 
 	virtual void calc_overdraw_vertex_count(bool is_looping);
-	virtual void render_overdraw(const std::vector<Vector2> &normals, float pixel_size, bool is_looping);
+	virtual void render_overdraw(float pixel_size, bool is_looping);
 	virtual void fill_color_array(Color constant_color, Color *colors);
 
 	/** Calculate line boundary points.
 	 *
-	 * @param[out]    anchors Anchor points defining the core line.
-	 * @param[out]    normals Normals defining the edge of the sleeve.
-	 * @param[in,out] s       Direction of segment pq (updated to the segment qr).
-	 * @param[in,out] len_s   Length of segment pq (updated to the segment qr).
-	 * @param[in,out] ns      Normal on the segment pq (updated to the segment qr).
+	 * @param[in,out] verts   Output sleeve vertices (advanced past the written ones).
+	 * @param[in,out] norms   Output normals defining the edge of the sleeve.
 	 * @param[in]     q       Current point on the line.
-	 * @param[in]     r       Next point on the line.
-	 * @param[in]     hw      Half line width (see Polyline.render()).
+	 * @param[in]     s       Direction of segment pq.
+	 * @param[in]     len_s   Length of segment pq.
+	 * @param[in]     ns      Normal on the segment pq.
+	 * @param[in]     t       Direction of segment qr.
+	 * @param[in]     len_t   Length of segment qr.
+	 * @param[in]     nt      Normal on the segment qr.
 	 */
-	virtual void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
-	                        Vector2 &s, float &len_s, Vector2 &ns,
-	                        const Vector2 &q, const Vector2 &r, float hw) = 0;
+	virtual void renderEdge(Vector2 *&verts, Vector2 *&norms, const Vector2 &q,
+	                        const Vector2 &s, float len_s, const Vector2 &ns,
+	                        const Vector2 &t, float len_t, const Vector2 &nt) = 0;
 
 	Vector2 *vertices;
+	Vector2 *normals;
 	Vector2 *overdraw;
 	size_t vertex_count;
 	size_t overdraw_vertex_count;
@@ -114,7 +125,7 @@ public:
 
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
 	{
-		Polyline::render(vertices, count, 4 * count - 4, halfwidth, pixel_size, draw_overdraw);
+		Polyline::render(vertices, count, 4 * count, halfwidth, pixel_size, draw_overdraw);
 
 		// discard the first and last two vertices. (these are redundant)
 		for (size_t i = 0; i < vertex_count - 4; ++i)
@@ -132,11 +143,11 @@ public:
 protected:
 
 	virtual void calc_overdraw_vertex_count(bool is_looping);
-	virtual void render_overdraw(const std::vector<Vector2> &normals, float pixel_size, bool is_looping);
+	virtual void render_overdraw(float pixel_size, bool is_looping);
 	virtual void fill_color_array(Color constant_color, Color *colors);
-	virtual void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
-	                        Vector2 &s, float &len_s, Vector2 &ns,
-	                        const Vector2 &q, const Vector2 &r, float hw);
+	virtual void renderEdge(Vector2 *&verts, Vector2 *&norms, const Vector2 &q,
+	                        const Vector2 &s, float len_s, const Vector2 &ns,
+	                        const Vector2 &t, float len_t, const Vector2 &nt);
 
 }; // NoneJoinPolyline
 
@@ -156,9 +167,9 @@ public:
 
 protected:
 
-	virtual void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
-	                        Vector2 &s, float &len_s, Vector2 &ns,
-	                        const Vector2 &q, const Vector2 &r, float hw);
+	virtual void renderEdge(Vector2 *&verts, Vector2 *&norms, const Vector2 &q,
+	                        const Vector2 &s, float len_s, const Vector2 &ns,
+	                        const Vector2 &t, float len_t, const Vector2 &nt);
 
 }; // MiterJoinPolyline
 
@@ -173,14 +184,14 @@ public:
 
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
 	{
-		Polyline::render(vertices, count, 4 * count - 4, halfwidth, pixel_size, draw_overdraw);
+		Polyline::render(vertices, count, 4 * count, halfwidth, pixel_size, draw_overdraw);
 	}
 
 protected:
 
-	virtual void renderEdge(std::vector<Vector2> &anchors, std::vector<Vector2> &normals,
-	                        Vector2 &s, float &len_s, Vector2 &ns,
-	                        const Vector2 &q, const Vector2 &r, float hw);
+	virtual void renderEdge(Vector2 *&verts, Vector2 *&norms, const Vector2 &q,
+	                        const Vector2 &s, float len_s, const Vector2 &ns,
+	                        const Vector2 &t, float len_t, const Vector2 &nt);
 
 }; // BevelJoinPolyline
 
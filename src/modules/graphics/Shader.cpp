@@ -22,6 +22,9 @@
 #include "Shader.h"
 #include "Graphics.h"
 #include "math/MathModule.h"
+#include "data/DataModule.h"
+#include "filesystem/Filesystem.h"
+#include "common/version.h"
 
 // glslang
 #include "libraries/glslang/glslang/Public/ShaderLang.h"
@@ -39,13 +42,16 @@ love::Type Shader::type("Shader", &Object::type);
 Shader *Shader::current = nullptr;
 Shader *Shader::standardShaders[Shader::STANDARD_MAX_ENUM] = {nullptr};
 
+int64 Shader::programCacheHits = 0;
+int64 Shader::programCacheMisses = 0;
+
+static const char *PROGRAM_CACHE_DIRECTORY = "shadercache";
+
+// Stages are validated by the backend's Shader constructor, since programs
+// loaded from the shader cache don't need it.
 Shader::Shader(ShaderStage *vertex, ShaderStage *pixel)
 	: stages()
 {
-	std::string err;
-	if (!validate(vertex, pixel, err))
-		throw love::Exception("%s", err.c_str());
-
 	stages[ShaderStage::STAGE_VERTEX] = vertex;
 	stages[ShaderStage::STAGE_PIXEL] = pixel;
 }
@@ -130,6 +136,12 @@ bool Shader::validate(ShaderStage *vertex, ShaderStage *pixel, std::string &err)
 {
 	glslang::TProgram program;
 
+	if (vertex != nullptr)
+		vertex->validate();
+
+	if (pixel != nullptr)
+		pixel->validate();
+
 	if (vertex != nullptr)
 		program.addShader(vertex->getGLSLangShader());
 
@@ -145,6 +157,108 @@ bool Shader::validate(ShaderStage *vertex, ShaderStage *pixel, std::string &err)
 	return true;
 }
 
+Shader *Shader::getInstancedVariant()
+{
+	if (instancedVariant.get() == nullptr)
+	{
+		if (instancedVertexSource.empty())
+			throw love::Exception("This shader can't be used to draw instanced SpriteBatches.");
+
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		instancedVariant.set(gfx->newInstancedShaderVariant(instancedVertexSource, stages[ShaderStage::STAGE_PIXEL]), Acquire::NORETAIN);
+	}
+
+	instancedVariant->copyUniforms(this);
+	return instancedVariant.get();
+}
+
+void Shader::setInstancedVertexSource(const std::string &source)
+{
+	instancedVertexSource = source;
+}
+
+std::string Shader::getProgramCacheKey(ShaderStage *vertex, ShaderStage *pixel)
+{
+	if (!isShaderCacheEnabled())
+		return "";
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (gfx == nullptr || fs == nullptr)
+		return "";
+
+	Graphics::RendererInfo info = gfx->getRendererInfo();
+
+	std::string keysource = std::string(LOVE_VERSION_STRING) + "\n"
+		+ info.name + "\n" + info.version + "\n" + info.vendor + "\n" + info.device + "\n";
+
+	keysource += (vertex != nullptr ? vertex->getSource() : std::string()) + '\0';
+	keysource += pixel != nullptr ? pixel->getSource() : std::string();
+
+	data::HashFunction::Value hashvalue;
+	data::hash(data::HashFunction::FUNCTION_SHA1, keysource.c_str(), keysource.size(), hashvalue);
+
+	static const char hexchars[] = "0123456789abcdef";
+
+	std::string key;
+	key.reserve(hashvalue.size * 2);
+	for (size_t i = 0; i < hashvalue.size; i++)
+	{
+		uint8 byte = (uint8) hashvalue.data[i];
+		key += hexchars[byte >> 4];
+		key += hexchars[byte & 0xF];
+	}
+
+	return key;
+}
+
+bool Shader::readProgramCache(const std::string &key, std::vector<uint8> &data)
+{
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (key.empty() || fs == nullptr)
+		return false;
+
+	std::string filename = std::string(PROGRAM_CACHE_DIRECTORY) + "/" + key;
+
+	filesystem::Filesystem::Info fileinfo = {};
+	if (!fs->getInfo(filename.c_str(), fileinfo) || fileinfo.type != filesystem::Filesystem::FILETYPE_FILE)
+		return false;
+
+	try
+	{
+		StrongRef<filesystem::FileData> filedata(fs->read(filename.c_str()), Acquire::NORETAIN);
+
+		const uint8 *bytes = (const uint8 *) filedata->getData();
+		data.assign(bytes, bytes + filedata->getSize());
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	return !data.empty();
+}
+
+void Shader::writeProgramCache(const std::string &key, const void *data, size_t size)
+{
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (key.empty() || fs == nullptr || size == 0)
+		return;
+
+	std::string filename = std::string(PROGRAM_CACHE_DIRECTORY) + "/" + key;
+
+	// The cache is best-effort: without a save directory (no identity set)
+	// programs are simply compiled every time.
+	try
+	{
+		if (fs->createDirectory(PROGRAM_CACHE_DIRECTORY))
+			fs->write(filename.c_str(), data, (int64) size);
+	}
+	catch (love::Exception &)
+	{
+	}
+}
+
 bool Shader::initialize()
 {
 	return glslang::InitializeProcess();
@@ -197,6 +311,7 @@ StringMap<Shader::BuiltinUniform, Shader::BUILTIN_MAX_ENUM>::Entry Shader::built
 	{ "ViewNormalFromLocal", BUILTIN_MATRIX_VIEW_NORMAL_FROM_LOCAL },
 	{ "love_PointSize",      BUILTIN_POINT_SIZE                    },
 	{ "love_ScreenSize",     BUILTIN_SCREEN_SIZE                   },
+	{ "love_BonePalette",    BUILTIN_BONE_PALETTE                  },
 };
 
 StringMap<Shader::BuiltinUniform, Shader::BUILTIN_MAX_ENUM> Shader::builtinNames(Shader::builtinNameEntries, sizeof(Shader::builtinNameEntries));
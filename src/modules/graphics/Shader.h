@@ -22,6 +22,7 @@
 
 // LOVE
 #include "common/Object.h"
+#include "common/int.h"
 #include "common/StringMap.h"
 #include "Texture.h"
 #include "ShaderStage.h"
@@ -74,6 +75,7 @@ public:
 		BUILTIN_MATRIX_VIEW_NORMAL_FROM_LOCAL,
 		BUILTIN_POINT_SIZE,
 		BUILTIN_SCREEN_SIZE,
+		BUILTIN_BONE_PALETTE,
 		BUILTIN_MAX_ENUM
 	};
 
@@ -95,6 +97,9 @@ public:
 		STANDARD_DEFAULT,
 		STANDARD_VIDEO,
 		STANDARD_ARRAY,
+		STANDARD_INSTANCED,
+		STANDARD_DISTANCE_FIELD,
+		STANDARD_SKINNED,
 		STANDARD_MAX_ENUM
 	};
 
@@ -139,6 +144,10 @@ public:
 	// Pointer to the default Shader.
 	static Shader *standardShaders[STANDARD_MAX_ENUM];
 
+	// Number of programs loaded from or missing in the persistent shader cache.
+	static int64 programCacheHits;
+	static int64 programCacheMisses;
+
 	Shader(ShaderStage *vertex, ShaderStage *pixel);
 	virtual ~Shader();
 
@@ -188,6 +197,29 @@ public:
 
 	static bool validate(ShaderStage *vertex, ShaderStage *pixel, std::string &err);
 
+	/**
+	 * Gets the version of this Shader used to draw instanced SpriteBatches,
+	 * compiling it the first time. The values of this Shader's uniforms are
+	 * copied to it on every call.
+	 **/
+	Shader *getInstancedVariant();
+	void setInstancedVertexSource(const std::string &source);
+
+	/**
+	 * Copies the values of uniforms with matching names and types from
+	 * another Shader. Built-in uniforms are skipped.
+	 **/
+	virtual void copyUniforms(const Shader *source) = 0;
+
+	/**
+	 * Linked program binaries can be stored in the save directory, keyed by
+	 * the source code, the renderer and the LOVE version. The key is empty if
+	 * the cache is disabled or unavailable.
+	 **/
+	static std::string getProgramCacheKey(ShaderStage *vertex, ShaderStage *pixel);
+	static bool readProgramCache(const std::string &key, std::vector<uint8> &data);
+	static void writeProgramCache(const std::string &key, const void *data, size_t size);
+
 	static bool initialize();
 	static void deinitialize();
 
@@ -203,6 +235,9 @@ protected:
 
 private:
 
+	std::string instancedVertexSource;
+	StrongRef<Shader> instancedVariant;
+
 	static StringMap<Language, LANGUAGE_MAX_ENUM>::Entry languageEntries[];
 	static StringMap<Language, LANGUAGE_MAX_ENUM> languages;
 	
@@ -140,24 +140,28 @@ ShaderStage::ShaderStage(Graphics *gfx, StageType stage, const std::string &glsl
 	: stageType(stage)
 	, source(glsl)
 	, cacheKey(cachekey)
+	, gles(gles)
+	, supportsGLSL3(gfx->getCapabilities().features[Graphics::FEATURE_GLSL3])
 	, glslangShader(nullptr)
 {
-	EShLanguage glslangStage = EShLangCount;
-	if (stage == STAGE_VERTEX)
-		glslangStage = EShLangVertex;
-	else if (stage == STAGE_PIXEL)
-		glslangStage = EShLangFragment;
-	else
+	if (stage != STAGE_VERTEX && stage != STAGE_PIXEL)
 		throw love::Exception("Cannot compile shader stage: unknown stage type.");
+}
+
+void ShaderStage::validate()
+{
+	if (glslangShader != nullptr)
+		return;
+
+	EShLanguage glslangStage = stageType == STAGE_VERTEX ? EShLangVertex : EShLangFragment;
 
 	glslangShader = new glslang::TShader(glslangStage);
 
-	bool supportsGLSL3 = gfx->getCapabilities().features[Graphics::FEATURE_GLSL3];
 	int defaultversion = gles ? 100 : 120;
 	EProfile defaultprofile = ENoProfile;
 
-	const char *csrc = glsl.c_str();
-	int srclen = (int) glsl.length();
+	const char *csrc = source.c_str();
+	int srclen = (int) source.length();
 	glslangShader->setStringsWithLengths(&csrc, &srclen, 1);
 
 	bool forcedefault = false;
@@ -169,13 +173,14 @@ ShaderStage::ShaderStage(Graphics *gfx, StageType stage, const std::string &glsl
 	if (!glslangShader->parse(&defaultTBuiltInResource, defaultversion, defaultprofile, forcedefault, forwardcompat, EShMsgSuppressWarnings))
 	{
 		const char *stagename = "unknown";
-		getConstant(stage, stagename);
+		getConstant(stageType, stagename);
 
 		std::string err = "Error validating " + std::string(stagename) + " shader:\n\n"
 			+ std::string(glslangShader->getInfoLog()) + "\n"
 			+ std::string(glslangShader->getInfoDebugLog());
 
 		delete glslangShader;
+		glslangShader = nullptr;
 		throw love::Exception("%s", err.c_str());
 	}
 }
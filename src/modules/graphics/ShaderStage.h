@@ -59,6 +59,13 @@ public:
 	const std::string &getWarnings() const { return warnings; }
 	glslang::TShader *getGLSLangShader() const { return glslangShader; }
 
+	/**
+	 * Parses and validates the source code with glslang, if that hasn't been
+	 * done already. This is deferred until a Shader needs it, so programs
+	 * loaded from the shader cache can skip it entirely.
+	 **/
+	void validate();
+
 	static bool getConstant(const char *in, StageType &out);
 	static bool getConstant(StageType in, const char *&out);
 
@@ -71,6 +78,8 @@ private:
 	StageType stageType;
 	std::string source;
 	std::string cacheKey;
+	bool gles;
+	bool supportsGLSL3;
 	glslang::TShader *glslangShader;
 
 	static StringMap<StageType, STAGE_MAX_ENUM>::Entry stageNameEntries[];
@@ -33,6 +33,14 @@
 // C
 #include <stddef.h>
 
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace love
 {
 namespace graphics
@@ -40,13 +48,101 @@ namespace graphics
 
 love::Type SpriteBatch::type("SpriteBatch", &Drawable::type);
 
-SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage)
+static inline void setVertexLayer(vertex::XYf_STf_RGBAub &, float)
+{
+}
+
+static inline void setVertexLayer(vertex::XYf_STPf_RGBAub &v, float layer)
+{
+	v.p = layer;
+}
+
+// Gets the 2D affine transform of packed sprite values, where
+// x' = a*x + c*y + tx and y' = b*x + d*y + ty. This is the same as
+// Matrix4::setTransformation without the shear terms.
+static inline void getPackedAffine(const float *t, float &a, float &b, float &c, float &d, float &tx, float &ty)
+{
+	float cs = cosf(t[2]);
+	float sn = sinf(t[2]);
+
+	a = cs * t[3];
+	b = sn * t[3];
+	c = -sn * t[4];
+	d = cs * t[4];
+	tx = t[0] - t[5] * a - t[6] * c;
+	ty = t[1] - t[5] * b - t[6] * d;
+}
+
+template <typename Vertex>
+static void fillSpriteVertices(Vertex *verts, const float *transforms, int count, const Quad *quad, float layer, Color color)
+{
+	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
+	const Vector2 &quadsize = quad->getVertexPositions()[3];
+
+	// Quad vertex positions are (0,0), (0,h), (w,0), (w,h). All four corners
+	// are transformed at once.
+#if defined(LOVE_SIMD_SSE)
+	const __m128 qx = _mm_set_ps(quadsize.x, quadsize.x, 0.0f, 0.0f);
+	const __m128 qy = _mm_set_ps(quadsize.y, 0.0f, quadsize.y, 0.0f);
+#elif defined(LOVE_SIMD_NEON)
+	const float qxvalues[4] = {0.0f, 0.0f, quadsize.x, quadsize.x};
+	const float qyvalues[4] = {0.0f, quadsize.y, 0.0f, quadsize.y};
+	const float32x4_t qx = vld1q_f32(qxvalues);
+	const float32x4_t qy = vld1q_f32(qyvalues);
+#else
+	const float qx[4] = {0.0f, 0.0f, quadsize.x, quadsize.x};
+	const float qy[4] = {0.0f, quadsize.y, 0.0f, quadsize.y};
+#endif
+
+	float x[4];
+	float y[4];
+
+	for (int i = 0; i < count; i++)
+	{
+		float a, b, c, d, tx, ty;
+		getPackedAffine(transforms + i * SpriteBatch::PACKED_TRANSFORM_COMPONENTS, a, b, c, d, tx, ty);
+
+#if defined(LOVE_SIMD_SSE)
+		__m128 vx = _mm_add_ps(_mm_set1_ps(tx), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a), qx), _mm_mul_ps(_mm_set1_ps(c), qy)));
+		__m128 vy = _mm_add_ps(_mm_set1_ps(ty), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(b), qx), _mm_mul_ps(_mm_set1_ps(d), qy)));
+		_mm_storeu_ps(x, vx);
+		_mm_storeu_ps(y, vy);
+#elif defined(LOVE_SIMD_NEON)
+		float32x4_t vx = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(tx), qx, a), qy, c);
+		float32x4_t vy = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(ty), qx, b), qy, d);
+		vst1q_f32(x, vx);
+		vst1q_f32(y, vy);
+#else
+		for (int j = 0; j < 4; j++)
+		{
+			x[j] = tx + a * qx[j] + c * qy[j];
+			y[j] = ty + b * qx[j] + d * qy[j];
+		}
+#endif
+
+		Vertex *v = verts + i * 4;
+
+		for (int j = 0; j < 4; j++)
+		{
+			v[j].x = x[j];
+			v[j].y = y[j];
+			v[j].s = quadtexcoords[j].x;
+			v[j].t = quadtexcoords[j].y;
+			v[j].color = color;
+			setVertexLayer(v[j], layer);
+		}
+	}
+}
+
+SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage, bool instanced)
 	: texture(texture)
 	, size(size)
 	, next(0)
 	, color(255, 255, 255, 255)
 	, color_active(false)
+	, instanced(instanced)
 	, array_buf(nullptr)
+	, quad_buf(nullptr)
 	, range_start(-1)
 	, range_count(-1)
 {
@@ -62,14 +158,40 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usag
 		vertex_format = vertex::CommonFormat::XYf_STf_RGBAub;
 
 	vertex_stride = vertex::getFormatStride(vertex_format);
+	sprite_stride = vertex_stride * 4;
+
+	if (instanced)
+	{
+		if (!gfx->getCapabilities().features[Graphics::FEATURE_INSTANCING] || Shader::standardShaders[Shader::STANDARD_INSTANCED] == nullptr)
+			throw love::Exception("Instanced SpriteBatches are not supported on this system.");
 
-	size_t vertex_size = vertex_stride * 4 * size;
-	array_buf = gfx->newBuffer(vertex_size, nullptr, BUFFER_VERTEX, usage, Buffer::MAP_EXPLICIT_RANGE_MODIFY);
+		if (texture->getTextureType() != TEXTURE_2D)
+			throw love::Exception("Instanced SpriteBatches can only be used with 2D textures.");
+
+		// Same vertex order as Quads, so it can be drawn as a triangle strip.
+		const Vector2 corners[4] = {Vector2(0.0f, 0.0f), Vector2(0.0f, 1.0f), Vector2(1.0f, 0.0f), Vector2(1.0f, 1.0f)};
+
+		quad_buf = gfx->newBuffer(sizeof(corners), corners, BUFFER_VERTEX, vertex::USAGE_STATIC, 0);
+		sprite_stride = sizeof(SpriteInstance);
+	}
+
+	size_t vertex_size = sprite_stride * size;
+
+	try
+	{
+		array_buf = gfx->newBuffer(vertex_size, nullptr, BUFFER_VERTEX, usage, Buffer::MAP_EXPLICIT_RANGE_MODIFY);
+	}
+	catch (love::Exception &)
+	{
+		delete quad_buf;
+		throw;
+	}
 }
 
 SpriteBatch::~SpriteBatch()
 {
 	delete array_buf;
+	delete quad_buf;
 }
 
 int SpriteBatch::add(const Matrix4 &m, int index /*= -1*/)
@@ -81,6 +203,9 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 {
 	using namespace vertex;
 
+	if (instanced)
+		return addInstance(quad, m, index);
+
 	if (vertex_format == CommonFormat::XYf_STPf_RGBAub)
 		return addLayer(quad->getLayer(), quad, m, index);
 
@@ -94,7 +219,7 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
 
 	// Always keep the VBO mapped when adding data (it'll be unmapped on draw.)
-	size_t offset = (index == -1 ? next : index) * vertex_stride * 4;
+	size_t offset = (index == -1 ? next : index) * sprite_stride;
 	auto verts = (XYf_STf_RGBAub *) ((uint8 *) array_buf->map() + offset);
 
 	m.transformXY(verts, quadpositions, 4);
@@ -106,7 +231,7 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 		verts[i].color = color;
 	}
 
-	array_buf->setMappedRangeModified(offset, vertex_stride * 4);
+	array_buf->setMappedRangeModified(offset, sprite_stride);
 
 	// Increment counter.
 	if (index == -1)
@@ -115,6 +240,106 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 	return index;
 }
 
+void SpriteBatch::setInstance(SpriteInstance &inst, Quad *quad, const Matrix4 &m) const
+{
+	const float *e = m.getElements();
+	setInstance(inst, quad, e[0], e[1], e[4], e[5], e[12], e[13]);
+}
+
+void SpriteBatch::setInstance(SpriteInstance &inst, Quad *quad, float a, float b, float c, float d, float tx, float ty) const
+{
+	const Vector2 &quadsize = quad->getVertexPositions()[3];
+	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
+
+	inst.transform[0] = a * quadsize.x;
+	inst.transform[1] = c * quadsize.y;
+	inst.transform[2] = tx;
+	inst.transform[3] = b * quadsize.x;
+	inst.transform[4] = d * quadsize.y;
+	inst.transform[5] = ty;
+
+	inst.texrect[0] = quadtexcoords[0].x;
+	inst.texrect[1] = quadtexcoords[0].y;
+	inst.texrect[2] = quadtexcoords[3].x - quadtexcoords[0].x;
+	inst.texrect[3] = quadtexcoords[3].y - quadtexcoords[0].y;
+
+	inst.color = color;
+}
+
+int SpriteBatch::addInstance(Quad *quad, const Matrix4 &m, int index)
+{
+	if (index < -1 || index >= size)
+		throw love::Exception("Invalid sprite index: %d", index + 1);
+
+	if (index == -1 && next >= size)
+		setBufferSize(size * 2);
+
+	// Always keep the VBO mapped when adding data (it'll be unmapped on draw.)
+	size_t offset = (index == -1 ? next : index) * sprite_stride;
+	auto inst = (SpriteInstance *) ((uint8 *) array_buf->map() + offset);
+
+	setInstance(*inst, quad, m);
+
+	array_buf->setMappedRangeModified(offset, sprite_stride);
+
+	// Increment counter.
+	if (index == -1)
+		return next++;
+
+	return index;
+}
+
+int SpriteBatch::addMany(Quad *quad, const float *transforms, int count, int index)
+{
+	using namespace vertex;
+
+	if (count <= 0)
+		throw love::Exception("Invalid sprite count: %d", count);
+
+	if (index < -1 || index >= size)
+		throw love::Exception("Invalid sprite index: %d", index + 1);
+
+	if (index == -1 && next + count > size)
+		setBufferSize(std::max(size * 2, next + count));
+	else if (index != -1 && index + count > size)
+		throw love::Exception("Too many sprites (expected at most %d, got %d)", size - index, count);
+
+	int start = index == -1 ? next : index;
+
+	// Always keep the VBO mapped when adding data (it'll be unmapped on draw.)
+	size_t offset = start * sprite_stride;
+	uint8 *data = (uint8 *) array_buf->map() + offset;
+
+	if (instanced)
+	{
+		auto insts = (SpriteInstance *) data;
+
+		for (int i = 0; i < count; i++)
+		{
+			float a, b, c, d, tx, ty;
+			getPackedAffine(transforms + i * PACKED_TRANSFORM_COMPONENTS, a, b, c, d, tx, ty);
+			setInstance(insts[i], quad, a, b, c, d, tx, ty);
+		}
+	}
+	else if (vertex_format == CommonFormat::XYf_STPf_RGBAub)
+	{
+		int layer = quad->getLayer();
+		if (layer < 0 || layer >= texture->getLayerCount())
+			throw love::Exception("Invalid layer: %d (Texture has %d layers)", layer + 1, texture->getLayerCount());
+
+		fillSpriteVertices((XYf_STPf_RGBAub *) data, transforms, count, quad, (float) layer, color);
+	}
+	else
+		fillSpriteVertices((XYf_STf_RGBAub *) data, transforms, count, quad, 0.0f, color);
+
+	array_buf->setMappedRangeModified(offset, sprite_stride * count);
+
+	if (index == -1)
+		next += count;
+
+	return start;
+}
+
 int SpriteBatch::addLayer(int layer, const Matrix4 &m, int index)
 {
 	return addLayer(layer, texture->getQuad(), m, index);
@@ -140,7 +365,7 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
 
 	// Always keep the VBO mapped when adding data (it'll be unmapped on draw.)
-	size_t offset = (index == -1 ? next : index) * vertex_stride * 4;
+	size_t offset = (index == -1 ? next : index) * sprite_stride;
 	auto verts = (XYf_STPf_RGBAub *) ((uint8 *) array_buf->map() + offset);
 
 	m.transformXY(verts, quadpositions, 4);
@@ -153,7 +378,7 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 		verts[i].color = color;
 	}
 
-	array_buf->setMappedRangeModified(offset, vertex_stride * 4);
+	array_buf->setMappedRangeModified(offset, sprite_stride);
 
 	// Increment counter.
 	if (index == -1)
@@ -224,7 +449,7 @@ void SpriteBatch::setBufferSize(int newsize)
 	if (newsize == size)
 		return;
 
-	size_t vertex_size = vertex_stride * 4 * newsize;
+	size_t vertex_size = sprite_stride * newsize;
 	love::graphics::Buffer *new_array_buf = nullptr;
 
 	int new_next = std::min(next, newsize);
@@ -235,7 +460,7 @@ void SpriteBatch::setBufferSize(int newsize)
 		new_array_buf = gfx->newBuffer(vertex_size, nullptr, array_buf->getType(), array_buf->getUsage(), array_buf->getMapFlags());
 
 		// Copy as much of the old data into the new GLBuffer as can fit.
-		size_t copy_size = vertex_stride * 4 * new_next;
+		size_t copy_size = sprite_stride * new_next;
 		array_buf->copyTo(0, copy_size, new_array_buf, 0);
 	}
 	catch (love::Exception &)
@@ -258,13 +483,20 @@ int SpriteBatch::getBufferSize() const
 	return size;
 }
 
+bool SpriteBatch::isInstanced() const
+{
+	return instanced;
+}
+
 void SpriteBatch::attachAttribute(const std::string &name, Mesh *mesh)
 {
 	AttachedAttribute oldattrib = {};
 	AttachedAttribute newattrib = {};
 
-	if (mesh->getVertexCount() < (size_t) next * 4)
-		throw love::Exception("Mesh has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", next*4);
+	int requiredvertices = instanced ? next : next * 4;
+
+	if (mesh->getVertexCount() < (size_t) requiredvertices)
+		throw love::Exception("Mesh has too few vertices to be attached to this SpriteBatch (at least %d vertices are required)", requiredvertices);
 
 	auto it = attached_attributes.find(name);
 	if (it != attached_attributes.end())
@@ -318,7 +550,9 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 		if (Shader::isDefaultActive())
 		{
 			Shader::StandardShader defaultshader = Shader::STANDARD_DEFAULT;
-			if (texture->getTextureType() == TEXTURE_2D_ARRAY)
+			if (instanced)
+				defaultshader = Shader::STANDARD_INSTANCED;
+			else if (texture->getTextureType() == TEXTURE_2D_ARRAY)
 				defaultshader = Shader::STANDARD_ARRAY;
 
 			Shader::attachDefault(defaultshader);
@@ -331,6 +565,44 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 	// Make sure the VBO isn't mapped when we draw (sends data to GPU if needed.)
 	array_buf->unmap();
 
+	int start = std::min(std::max(0, range_start), next - 1);
+
+	int count = next;
+	if (range_count > 0)
+		count = std::min(count, range_count);
+
+	count = std::min(count, next - start);
+
+	if (instanced)
+	{
+		Graphics::TempTransform transform(gfx, m);
+
+		// Custom shaders are drawn with their instanced variant, which has the
+		// same code with the main function of the standard instanced shader.
+		Shader *shader = Shader::current;
+
+		if (shader != nullptr && !Shader::isDefaultActive())
+		{
+			shader->getInstancedVariant()->attach();
+
+			try
+			{
+				drawInstanced(gfx, start, count);
+			}
+			catch (love::Exception &)
+			{
+				shader->attach();
+				throw;
+			}
+
+			shader->attach();
+		}
+		else
+			drawInstanced(gfx, start, count);
+
+		return;
+	}
+
 	Attributes attributes;
 	Buffers buffers;
 
@@ -384,16 +656,90 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 	Graphics::TempTransform transform(gfx, m);
 
-	int start = std::min(std::max(0, range_start), next - 1);
+	if (count > 0)
+		gfx->drawQuads(start, count, attributes, buffers, texture);
+}
 
-	int count = next;
-	if (range_count > 0)
-		count = std::min(count, range_count);
+void SpriteBatch::drawInstanced(Graphics *gfx, int start, int count)
+{
+	using namespace vertex;
 
-	count = std::min(count, next - start);
+	if (count <= 0)
+		return;
 
-	if (count > 0)
-		gfx->drawQuads(start, count, attributes, buffers, texture);
+	if (Shader::current == nullptr)
+		return;
+
+	static const char *instanceattribs[] = {"InstanceTransform0", "InstanceTransform1", "InstanceTexRect"};
+
+	int attribindices[3];
+	for (int i = 0; i < 3; i++)
+	{
+		attribindices[i] = Shader::current->getVertexAttributeIndex(instanceattribs[i]);
+		if (attribindices[i] < 0)
+			throw love::Exception("The active shader must use the %s vertex attribute to draw an instanced SpriteBatch.", instanceattribs[i]);
+	}
+
+	Attributes attributes;
+	Buffers buffers;
+
+	uint16 stride = (uint16) sizeof(SpriteInstance);
+
+	// Sprites before the draw range are skipped by offsetting the per-instance
+	// buffers, since base instances aren't supported everywhere.
+	buffers.set(0, quad_buf, 0);
+	buffers.set(1, array_buf, start * sprite_stride);
+
+	attributes.set(ATTRIB_POS, DATA_FLOAT, 2, 0, (uint16) sizeof(Vector2), 0);
+	attributes.set(attribindices[0], DATA_FLOAT, 3, offsetof(SpriteInstance, transform), stride, 1, STEP_PER_INSTANCE);
+	attributes.set(attribindices[1], DATA_FLOAT, 3, offsetof(SpriteInstance, transform) + sizeof(float) * 3, stride, 1, STEP_PER_INSTANCE);
+	attributes.set(attribindices[2], DATA_FLOAT, 4, offsetof(SpriteInstance, texrect), stride, 1, STEP_PER_INSTANCE);
+
+	if (color_active)
+		attributes.set(ATTRIB_COLOR, DATA_UNORM8, 4, offsetof(SpriteInstance, color), stride, 1, STEP_PER_INSTANCE);
+
+	int activebuffers = 2;
+
+	for (const auto &it : attached_attributes)
+	{
+		Mesh *mesh = it.second.mesh.get();
+
+		if (mesh->getVertexCount() < (size_t) next)
+			throw love::Exception("Mesh with attribute '%s' attached to this SpriteBatch has too few vertices", it.first.c_str());
+
+		int attributeindex = -1;
+
+		VertexAttribID builtinattrib;
+		if (vertex::getConstant(it.first.c_str(), builtinattrib))
+			attributeindex = (int) builtinattrib;
+		else
+			attributeindex = Shader::current->getVertexAttributeIndex(it.first);
+
+		if (attributeindex >= 0)
+		{
+			mesh->vbo->unmap();
+
+			const auto &formats = mesh->getVertexFormat();
+			const auto &format = formats[it.second.index];
+
+			uint16 offset = (uint16) mesh->getAttributeOffset(it.second.index);
+			uint16 meshstride = (uint16) mesh->getVertexStride();
+
+			attributes.set(attributeindex, format.type, format.components, offset, meshstride, activebuffers, STEP_PER_INSTANCE);
+
+			buffers.set(activebuffers, mesh->vbo, start * mesh->getVertexStride());
+			activebuffers++;
+		}
+	}
+
+	Graphics::DrawCommand cmd(&attributes, &buffers);
+
+	cmd.primitiveType = PRIMITIVE_TRIANGLE_STRIP;
+	cmd.vertexCount = 4;
+	cmd.instanceCount = count;
+	cmd.texture = texture;
+
+	gfx->draw(cmd);
 }
 
 } // graphics
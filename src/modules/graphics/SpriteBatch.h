@@ -51,7 +51,11 @@ public:
 
 	static love::Type type;
 
-	SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage);
+	// Number of floats used by each sprite in packed transform data:
+	// x, y, angle, sx, sy, ox, oy.
+	static const int PACKED_TRANSFORM_COMPONENTS = 7;
+
+	SpriteBatch(Graphics *gfx, Texture *texture, int size, vertex::Usage usage, bool instanced);
 	virtual ~SpriteBatch();
 
 	int add(const Matrix4 &m, int index = -1);
@@ -59,6 +63,15 @@ public:
 	int addLayer(int layer, const Matrix4 &m, int index = -1);
 	int addLayer(int layer, Quad *quad, const Matrix4 &m, int index = -1);
 
+	/**
+	 * Adds or replaces several sprites which all use the same Quad, from
+	 * packed transform data (see PACKED_TRANSFORM_COMPONENTS). Sprites are
+	 * appended if index is -1.
+	 *
+	 * @return The index of the first sprite.
+	 **/
+	int addMany(Quad *quad, const float *transforms, int count, int index = -1);
+
 	void clear();
 
 	void flush();
@@ -96,9 +109,17 @@ public:
 	 **/
 	int getBufferSize() const;
 
+	/**
+	 * Gets whether this SpriteBatch stores one instance record per sprite
+	 * which is expanded into a quad on the GPU, instead of four vertices.
+	 **/
+	bool isInstanced() const;
+
 	/**
 	 * Attaches a specific vertex attribute from a Mesh to this SpriteBatch.
-	 * The vertex attribute will be used when drawing the SpriteBatch.
+	 * The vertex attribute will be used when drawing the SpriteBatch. In an
+	 * instanced SpriteBatch the attribute is used per-sprite instead of
+	 * per-vertex.
 	 **/
 	void attachAttribute(const std::string &name, Mesh *mesh);
 
@@ -117,6 +138,21 @@ private:
 		int index;
 	};
 
+	// Per-sprite data used by instanced SpriteBatches. The transform is the
+	// upper 2x3 part of the sprite's affine transform (row-major), with the
+	// quad's size folded in so it maps the unit square to the sprite.
+	struct SpriteInstance
+	{
+		float transform[6];
+		float texrect[4];
+		Color color;
+	};
+
+	void setInstance(SpriteInstance &inst, Quad *quad, const Matrix4 &m) const;
+	void setInstance(SpriteInstance &inst, Quad *quad, float a, float b, float c, float d, float tx, float ty) const;
+	int addInstance(Quad *quad, const Matrix4 &m, int index);
+	void drawInstanced(Graphics *gfx, int start, int count);
+
 	/**
 	 * Sets the total number of sprites this SpriteBatch can hold.
 	 * Leaves existing sprite data intact when possible.
@@ -138,9 +174,17 @@ private:
 
 	vertex::CommonFormat vertex_format;
 	size_t vertex_stride;
-	
+
+	// Size in bytes of a single sprite's data in array_buf.
+	size_t sprite_stride;
+
+	bool instanced;
+
 	love::graphics::Buffer *array_buf;
 
+	// The unit square expanded by each sprite in an instanced SpriteBatch.
+	love::graphics::Buffer *quad_buf;
+
 	std::unordered_map<std::string, AttachedAttribute> attached_attributes;
 	
 	int range_start;
@@ -30,6 +30,7 @@ StreamBuffer::StreamBuffer(BufferType mode, size_t size)
 	: bufferSize(size)
 	, frameGPUReadOffset(0)
 	, mode(mode)
+	, stallCount(0)
 {
 }
 
@@ -54,12 +54,28 @@ public:
 
 	size_t getSize() const { return bufferSize; }
 	BufferType getMode() const { return mode; }
-	size_t getUsableSize() const { return bufferSize - frameGPUReadOffset; }
+
+	/**
+	 * Gets the largest size which can be passed to map() without having to
+	 * resize the buffer.
+	 **/
+	virtual size_t getUsableSize() const { return bufferSize - frameGPUReadOffset; }
+
+	/**
+	 * Gets the number of times map() had to wait for the GPU this frame.
+	 **/
+	int getStallCount() const { return stallCount; }
 
 	virtual MapInfo map(size_t minsize) = 0;
 	virtual size_t unmap(size_t usedsize) = 0;
 	virtual void markUsed(size_t usedsize) = 0;
 
+	/**
+	 * Grows the buffer without replacing this object. Must not be called
+	 * while the buffer is mapped.
+	 **/
+	virtual void resize(size_t newsize) = 0;
+
 	virtual void nextFrame() {}
 
 protected:
@@ -69,6 +85,7 @@ protected:
 	size_t bufferSize;
 	size_t frameGPUReadOffset;
 	BufferType mode;
+	int stallCount;
 
 }; // StreamBuffer
 
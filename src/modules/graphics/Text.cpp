@@ -35,6 +35,7 @@ Text::Text(Font *font, const std::vector<Font::ColoredString> &text)
 	, vertexAttributes(Font::vertexFormat, 0)
 	, vbo(nullptr)
 	, vert_offset(0)
+	, free_vertex_count(0)
 	, texture_cache_id((uint32) -1)
 {
 	set(text);
@@ -61,7 +62,7 @@ void Text::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t
 			newsize = std::max(size_t(vbo->getSize() * 1.5), newsize);
 
 		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
-		Buffer *new_vbo = gfx->newBuffer(newsize, nullptr, BUFFER_VERTEX, vertex::USAGE_DYNAMIC, 0);
+		Buffer *new_vbo = gfx->newBuffer(newsize, nullptr, BUFFER_VERTEX, vertex::USAGE_DYNAMIC, Buffer::MAP_EXPLICIT_RANGE_MODIFY);
 
 		if (vbo != nullptr)
 			vbo->copyTo(0, vbo->getSize(), new_vbo, 0);
@@ -76,15 +77,153 @@ void Text::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t
 	{
 		vbodata = (uint8 *) vbo->map();
 		memcpy(vbodata + offset, &vertices[0], datasize);
+		vbo->setMappedRangeModified(offset, datasize);
 		// We unmap when we draw, to avoid unnecessary full map()/unmap() calls.
 	}
 }
 
+size_t Text::allocateVertices(size_t count, size_t &capacity)
+{
+	// First fit in the ranges freed by removed or shrunk text.
+	for (size_t i = 0; i < free_ranges.size(); i++)
+	{
+		VertexRange &range = free_ranges[i];
+
+		if (range.count >= count)
+		{
+			size_t start = range.start;
+			capacity = count;
+
+			range.start += count;
+			range.count -= count;
+			free_vertex_count -= count;
+
+			if (range.count == 0)
+				free_ranges.erase(free_ranges.begin() + i);
+
+			return start;
+		}
+	}
+
+	size_t start = vert_offset;
+	vert_offset += count;
+	capacity = count;
+
+	return start;
+}
+
+void Text::freeVertices(size_t start, size_t count)
+{
+	if (count == 0)
+		return;
+
+	// Keep the free list sorted, and merge neighbouring ranges.
+	auto it = std::lower_bound(free_ranges.begin(), free_ranges.end(), start,
+		[](const VertexRange &r, size_t s) { return r.start < s; });
+
+	it = free_ranges.insert(it, {start, count});
+	free_vertex_count += count;
+
+	auto next = it + 1;
+	if (next != free_ranges.end() && it->start + it->count == next->start)
+	{
+		it->count += next->count;
+		free_ranges.erase(next);
+	}
+
+	if (it != free_ranges.begin())
+	{
+		auto prev = it - 1;
+		if (prev->start + prev->count == it->start)
+		{
+			prev->count += it->count;
+			it = free_ranges.erase(it) - 1;
+		}
+	}
+
+	// A free range at the end just shrinks the used part of the buffer.
+	if (it->start + it->count == vert_offset)
+	{
+		vert_offset = it->start;
+		free_vertex_count -= it->count;
+		free_ranges.erase(it);
+	}
+}
+
+void Text::compactVertices()
+{
+	// Gaps left by removed or moved text prevent draws from being merged, so
+	// the vertices are moved together once enough of the buffer is unused.
+	if (vbo == nullptr || free_vertex_count <= COMPACT_MIN_FREE_VERTICES || free_vertex_count <= vert_offset / 2)
+		return;
+
+	std::vector<uint8> olddata(vert_offset * sizeof(Font::GlyphVertex));
+	uint8 *vbodata = (uint8 *) vbo->map();
+
+	if (!olddata.empty())
+		memcpy(olddata.data(), vbodata, olddata.size());
+
+	size_t offset = 0;
+
+	// Lay the text out in index order again, so draws can be merged.
+	for (TextData &t : text_data)
+	{
+		if (t.vertex_count > 0)
+		{
+			memcpy(vbodata + offset * sizeof(Font::GlyphVertex), olddata.data() + t.vertex_start * sizeof(Font::GlyphVertex), t.vertex_count * sizeof(Font::GlyphVertex));
+
+			for (Font::DrawCommand &cmd : t.commands)
+				cmd.startvertex = cmd.startvertex - (int) t.vertex_start + (int) offset;
+		}
+
+		t.vertex_start = offset;
+		t.vertex_capacity = t.vertex_count;
+
+		offset += t.vertex_count;
+	}
+
+	vbo->setMappedRangeModified(0, offset * sizeof(Font::GlyphVertex));
+
+	vert_offset = offset;
+	free_ranges.clear();
+	free_vertex_count = 0;
+}
+
+void Text::appendDrawCommands(const TextData &t)
+{
+	for (const Font::DrawCommand &cmd : t.commands)
+	{
+		// If the command has the same texture as the last one and its
+		// vertices directly follow the last one's, we can combine them
+		// (saving a draw call.)
+		if (!draw_commands.empty())
+		{
+			Font::DrawCommand &prevcmd = draw_commands.back();
+			if (prevcmd.texture == cmd.texture && (prevcmd.startvertex + prevcmd.vertexcount) == cmd.startvertex)
+			{
+				prevcmd.vertexcount += cmd.vertexcount;
+				continue;
+			}
+		}
+
+		draw_commands.push_back(cmd);
+	}
+}
+
+void Text::rebuildDrawCommands()
+{
+	draw_commands.clear();
+
+	for (const TextData &t : text_data)
+		appendDrawCommands(t);
+}
+
 void Text::regenerateVertices()
 {
-	// If the font's texture cache was invalidated then we need to recreate the
-	// text's vertices, since glyph texcoords might have changed.
-	if (font->getTextureCacheID() != texture_cache_id)
+	// If the font's texture cache was invalidated or glyphs we use were
+	// evicted then we need to recreate the text's vertices, since glyph
+	// texcoords might have changed.
+	if (!isTextureCacheValid())
 	{
 		std::vector<TextData> textdata = text_data;
 
@@ -97,70 +236,84 @@ void Text::regenerateVertices()
 	}
 }
 
-void Text::addTextData(const TextData &t)
+bool Text::isTextureCacheValid() const
 {
-	std::vector<Font::GlyphVertex> vertices;
-	std::vector<Font::DrawCommand> new_commands;
+	if (font->getTextureCacheID() != texture_cache_id)
+		return false;
 
-	Font::TextInfo text_info;
+	for (const auto &version : texture_versions)
+	{
+		if (font->getTextureVersion(version.first) != version.second)
+			return false;
+	}
+
+	return true;
+}
+
+void Text::layoutTextData(TextData &t)
+{
+	std::vector<Font::GlyphVertex> vertices;
 
 	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
 
 	// We only have formatted text if the align mode is valid.
 	if (t.align == Font::ALIGN_MAX_ENUM)
-		new_commands = font->generateVertices(t.codepoints, constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &text_info);
+		t.commands = font->generateVertices(t.codepoints, constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &t.text_info);
 	else
-		new_commands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &text_info);
-
-	if (vertices.empty())
-		return;
+		t.commands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &t.text_info);
 
-	if (t.use_matrix)
+	if (t.use_matrix && !vertices.empty())
 		t.matrix.transformXY(&vertices[0], &vertices[0], (int) vertices.size());
 
-	size_t voffset = vert_offset;
-
-	if (!t.append_vertices)
+	// Re-use the text's existing vertex range if the new vertices fit.
+	if (vertices.size() > t.vertex_capacity)
 	{
-		voffset = 0;
-		draw_commands.clear();
-		text_data.clear();
+		freeVertices(t.vertex_start, t.vertex_capacity);
+		t.vertex_start = allocateVertices(vertices.size(), t.vertex_capacity);
 	}
 
-	uploadVertices(vertices, voffset);
+	t.vertex_count = vertices.size();
 
-	if (!new_commands.empty())
+	// Give back most of the range if the text got much shorter.
+	if (t.vertex_count < t.vertex_capacity / 2)
 	{
-		// The start vertex should be adjusted to account for the vertex offset.
-		for (Font::DrawCommand &cmd : new_commands)
-			cmd.startvertex += (int) voffset;
+		freeVertices(t.vertex_start + t.vertex_count, t.vertex_capacity - t.vertex_count);
+		t.vertex_capacity = t.vertex_count;
+	}
 
-		auto firstcmd = new_commands.begin();
+	uploadVertices(vertices, t.vertex_start);
 
-		// If the first draw command in the new list has the same texture as the
-		// last one in the existing list we're building and its vertices are
-		// in-order, we can combine them (saving a draw call.)
-		if (!draw_commands.empty())
-		{
-			auto prevcmd = draw_commands.back();
-			if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
-			{
-				draw_commands.back().vertexcount += firstcmd->vertexcount;
-				++firstcmd;
-			}
-		}
+	// The start vertex should be adjusted to account for the vertex offset.
+	for (Font::DrawCommand &cmd : t.commands)
+	{
+		cmd.startvertex += (int) t.vertex_start;
 
-		// Append the new draw commands to the list we're building.
-		draw_commands.insert(draw_commands.end(), firstcmd, new_commands.end());
-	}
+		// Versions of textures we already use aren't updated, so glyphs
+		// evicted while generating the new vertices are noticed below.
+		auto it = std::find_if(texture_versions.begin(), texture_versions.end(),
+			[&](const std::pair<const Texture *, uint32> &v) { return v.first == cmd.texture; });
 
-	vert_offset = voffset + vertices.size();
+		if (it == texture_versions.end())
+			texture_versions.emplace_back(cmd.texture, font->getTextureVersion(cmd.texture));
+	}
+}
 
+void Text::addTextData(const TextData &t)
+{
 	text_data.push_back(t);
-	text_data.back().text_info = text_info;
+
+	TextData &newdata = text_data.back();
+	newdata.vertex_start = 0;
+	newdata.vertex_count = 0;
+	newdata.vertex_capacity = 0;
+
+	layoutTextData(newdata);
+
+	// New text always goes last, so only its own commands need to be added.
+	appendDrawCommands(newdata);
 
 	// Font::generateVertices can invalidate the font's texture cache.
-	if (font->getTextureCacheID() != texture_cache_id)
+	if (!isTextureCacheValid())
 		regenerateVertices();
 }
 
@@ -171,13 +324,15 @@ void Text::set(const std::vector<Font::ColoredString> &text)
 
 void Text::set(const std::vector<Font::ColoredString> &text, float wrap, Font::AlignMode align)
 {
+	clear();
+
 	if (text.empty() || (text.size() == 1 && text[0].str.empty()))
-		return clear();
+		return;
 
 	Font::ColoredCodepoints codepoints;
 	Font::getCodepointsFromString(text, codepoints);
 
-	addTextData({codepoints, wrap, align, {}, false, false, Matrix4()});
+	addTextData({codepoints, wrap, align, {}, false, Matrix4()});
 }
 
 int Text::add(const std::vector<Font::ColoredString> &text, const Matrix4 &m)
@@ -190,15 +345,63 @@ int Text::addf(const std::vector<Font::ColoredString> &text, float wrap, Font::A
 	Font::ColoredCodepoints codepoints;
 	Font::getCodepointsFromString(text, codepoints);
 
-	addTextData({codepoints, wrap, align, {}, true, true, m});
+	addTextData({codepoints, wrap, align, {}, true, m});
 
 	return (int) text_data.size() - 1;
 }
 
+void Text::setAt(int index, const std::vector<Font::ColoredString> &text, const Matrix4 &m)
+{
+	setfAt(index, text, -1.0f, Font::ALIGN_MAX_ENUM, m);
+}
+
+void Text::setfAt(int index, const std::vector<Font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m)
+{
+	if (index < 0 || index >= (int) text_data.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	TextData &t = text_data[index];
+
+	t.codepoints.cps.clear();
+	t.codepoints.colors.clear();
+	Font::getCodepointsFromString(text, t.codepoints);
+
+	t.wrap = wrap;
+	t.align = align;
+	t.use_matrix = true;
+	t.matrix = m;
+
+	// Only this text's vertices are generated and uploaded again.
+	layoutTextData(t);
+
+	compactVertices();
+	rebuildDrawCommands();
+
+	if (!isTextureCacheValid())
+		regenerateVertices();
+}
+
+void Text::remove(int index)
+{
+	if (index < 0 || index >= (int) text_data.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	const TextData &t = text_data[index];
+	freeVertices(t.vertex_start, t.vertex_capacity);
+
+	text_data.erase(text_data.begin() + index);
+
+	compactVertices();
+	rebuildDrawCommands();
+}
+
 void Text::clear()
 {
 	text_data.clear();
 	draw_commands.clear();
+	texture_versions.clear();
+	free_ranges.clear();
+	free_vertex_count = 0;
 	texture_cache_id = font->getTextureCacheID();
 	vert_offset = 0;
 }
@@ -248,13 +451,15 @@ void Text::draw(Graphics *gfx, const Matrix4 &m)
 	gfx->flushStreamDraws();
 
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(font->getStandardShaderType());
 
 	if (Shader::current)
 		Shader::current->checkMainTextureType(TEXTURE_2D, false);
 
+	font->addLoadedGlyphs();
+
 	// Re-generate the text if the Font's texture cache was invalidated.
-	if (font->getTextureCacheID() != texture_cache_id)
+	if (!isTextureCacheValid())
 		regenerateVertices();
 
 	int totalverts = 0;
@@ -48,6 +48,19 @@ public:
 	int add(const std::vector<Font::ColoredString> &text, const Matrix4 &m);
 	int addf(const std::vector<Font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
 
+	/**
+	 * Replaces the text at the given index (returned by add or addf.) Only
+	 * that text's vertices are regenerated and uploaded.
+	 **/
+	void setAt(int index, const std::vector<Font::ColoredString> &text, const Matrix4 &m);
+	void setfAt(int index, const std::vector<Font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
+
+	/**
+	 * Removes the text at the given index. Text at higher indices moves down
+	 * by one.
+	 **/
+	void remove(int index);
+
 	void clear();
 
 	void setFont(Font *f);
@@ -75,13 +88,35 @@ private:
 		Font::AlignMode align;
 		Font::TextInfo text_info;
 		bool use_matrix;
-		bool append_vertices;
 		Matrix4 matrix;
+
+		// The range of vertices in the VBO reserved for this text, and how
+		// many of them are used.
+		size_t vertex_start;
+		size_t vertex_count;
+		size_t vertex_capacity;
+
+		// Draw commands for this text's vertices.
+		std::vector<Font::DrawCommand> commands;
+	};
+
+	struct VertexRange
+	{
+		size_t start;
+		size_t count;
 	};
 
 	void uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset);
 	void regenerateVertices();
 	void addTextData(const TextData &s);
+	void layoutTextData(TextData &t);
+	bool isTextureCacheValid() const;
+
+	size_t allocateVertices(size_t count, size_t &capacity);
+	void freeVertices(size_t start, size_t count);
+	void compactVertices();
+	void appendDrawCommands(const TextData &t);
+	void rebuildDrawCommands();
 
 	StrongRef<Font> font;
 
@@ -94,10 +129,21 @@ private:
 
 	std::vector<TextData> text_data;
 
+	// The end of the used part of the VBO.
 	size_t vert_offset;
+
+	// Unused ranges of vertices before vert_offset, sorted by start.
+	std::vector<VertexRange> free_ranges;
+	size_t free_vertex_count;
 	
 	// Used so we know when the font's texture cache is invalidated.
 	uint32 texture_cache_id;
+
+	// Versions of the font texture pages used by the text, so we know when
+	// glyphs we use are evicted.
+	std::vector<std::pair<const Texture *, uint32>> texture_versions;
+
+	static const size_t COMPACT_MIN_FREE_VERTICES = 4096;
 	
 }; // Text
 
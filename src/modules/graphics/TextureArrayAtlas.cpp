@@ -0,0 +1,272 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "TextureArrayAtlas.h"
+#include "Graphics.h"
+#include "image/ImageData.h"
+#include "thread/threads.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+namespace
+{
+
+const int INITIAL_LAYERS = 4;
+const int MAX_LAYERS = 64;
+
+bool filtersEqual(const Texture::Filter &a, const Texture::Filter &b)
+{
+	return a.min == b.min && a.mag == b.mag && a.mipmap == b.mipmap && a.anisotropy == b.anisotropy;
+}
+
+bool wrapsEqual(const Texture::Wrap &a, const Texture::Wrap &b)
+{
+	return a.s == b.s && a.t == b.t && a.r == b.r;
+}
+
+} // anonymous namespace
+
+TextureArrayAtlas::TextureArrayAtlas(Graphics *gfx)
+	: gfx(gfx)
+	, maxLayers(0)
+{
+	const Graphics::Capabilities &caps = gfx->getCapabilities();
+	maxLayers = std::min((int) caps.limits[Graphics::LIMIT_TEXTURE_LAYERS], MAX_LAYERS);
+}
+
+TextureArrayAtlas::~TextureArrayAtlas()
+{
+	for (Page *page : pages)
+	{
+		for (Image *image : page->images)
+		{
+			if (image != nullptr)
+			{
+				image->arrayPage = -1;
+				image->arrayLayer = -1;
+			}
+		}
+
+		delete page;
+	}
+}
+
+Image *TextureArrayAtlas::getArray(Image *image, int &layer)
+{
+	if (!image->arrayBatchable)
+		return nullptr;
+
+	if (image->arrayPage < 0)
+	{
+		if (!isSupported(image))
+		{
+			image->arrayBatchable = false;
+			return nullptr;
+		}
+
+		addImage(image);
+	}
+
+	Page *page = pages[image->arrayPage];
+
+	// All layers share the array's sampler state.
+	if (!filtersEqual(image->getFilter(), page->filter) || !wrapsEqual(image->getWrap(), page->wrap))
+		return nullptr;
+
+	layer = image->arrayLayer;
+	return page->array.get();
+}
+
+void TextureArrayAtlas::updateImage(Image *image)
+{
+	if (image->arrayPage >= 0)
+		uploadLayer(pages[image->arrayPage], image->arrayLayer);
+}
+
+void TextureArrayAtlas::removeImage(Image *image)
+{
+	if (image->arrayPage < 0)
+		return;
+
+	Page *page = pages[image->arrayPage];
+
+	page->images[image->arrayLayer] = nullptr;
+	page->usedLayers--;
+
+	image->arrayPage = -1;
+	image->arrayLayer = -1;
+
+	// Empty pages keep their slot so they can be reused, but not their memory.
+	if (page->usedLayers == 0)
+	{
+		gfx->flushStreamDraws();
+		page->array.set(nullptr);
+		page->images.clear();
+	}
+}
+
+void TextureArrayAtlas::reload()
+{
+	for (Page *page : pages)
+	{
+		for (int i = 0; i < (int) page->images.size(); i++)
+		{
+			if (page->images[i] != nullptr)
+				uploadLayer(page, i);
+		}
+	}
+}
+
+bool TextureArrayAtlas::isSupported(Image *image) const
+{
+	if (maxLayers <= 0 || !gfx->getCapabilities().textureTypes[TEXTURE_2D_ARRAY])
+		return false;
+
+	if (image->getTextureType() != TEXTURE_2D || image->isCompressed() || !image->isReadable())
+		return false;
+
+	if (image->usingDefaultTexture || image->getMipmapsType() == Image::MIPMAPS_DATA)
+		return false;
+
+	if (image->getPixelWidth() > MAX_IMAGE_SIZE || image->getPixelHeight() > MAX_IMAGE_SIZE)
+		return false;
+
+	// The copy is made from the Image's ImageData, which Images created
+	// without any don't have.
+	return dynamic_cast<love::image::ImageData *>(image->data.get(0, 0)) != nullptr;
+}
+
+bool TextureArrayAtlas::matches(const Page *page, Image *image) const
+{
+	return page->format == image->getPixelFormat()
+		&& page->width == image->getPixelWidth()
+		&& page->height == image->getPixelHeight()
+		&& page->mipmaps == (image->getMipmapsType() == Image::MIPMAPS_GENERATED)
+		&& page->linear == image->isFormatLinear()
+		&& filtersEqual(page->filter, image->getFilter())
+		&& wrapsEqual(page->wrap, image->getWrap());
+}
+
+void TextureArrayAtlas::addImage(Image *image)
+{
+	Page *page = nullptr;
+	int pageindex = -1;
+
+	for (int i = 0; i < (int) pages.size(); i++)
+	{
+		Page *p = pages[i];
+		if (p->usedLayers > 0 && matches(p, image) && p->usedLayers < maxLayers)
+		{
+			page = p;
+			pageindex = i;
+			break;
+		}
+	}
+
+	if (page == nullptr)
+	{
+		for (int i = 0; i < (int) pages.size(); i++)
+		{
+			if (pages[i]->usedLayers == 0)
+			{
+				page = pages[i];
+				pageindex = i;
+				break;
+			}
+		}
+
+		if (page == nullptr)
+		{
+			page = new Page();
+			pages.push_back(page);
+			pageindex = (int) pages.size() - 1;
+		}
+
+		page->format = image->getPixelFormat();
+		page->width = image->getPixelWidth();
+		page->height = image->getPixelHeight();
+		page->mipmaps = image->getMipmapsType() == Image::MIPMAPS_GENERATED;
+		page->linear = image->isFormatLinear();
+		page->filter = image->getFilter();
+		page->wrap = image->getWrap();
+		page->usedLayers = 0;
+		page->images.clear();
+
+		createArray(page, std::min(INITIAL_LAYERS, maxLayers));
+	}
+	else if (page->usedLayers == (int) page->images.size())
+		createArray(page, std::min((int) page->images.size() * 2, maxLayers));
+
+	auto it = std::find(page->images.begin(), page->images.end(), nullptr);
+	int layer = (int) (it - page->images.begin());
+
+	page->images[layer] = image;
+	page->usedLayers++;
+
+	image->arrayPage = pageindex;
+	image->arrayLayer = layer;
+
+	uploadLayer(page, layer);
+}
+
+void TextureArrayAtlas::createArray(Page *page, int layercount)
+{
+	Image::Settings settings;
+	settings.mipmaps = page->mipmaps;
+	settings.linear = page->linear;
+
+	StrongRef<Image> array(gfx->newImage(TEXTURE_2D_ARRAY, page->format, page->width, page->height, layercount, settings), Acquire::NORETAIN);
+
+	array->setFilter(page->filter);
+	array->setWrap(page->wrap);
+
+	// Batched draws may still refer to the old array.
+	gfx->flushStreamDraws();
+
+	page->array = array;
+	page->images.resize(layercount, nullptr);
+
+	for (int i = 0; i < layercount; i++)
+	{
+		if (page->images[i] != nullptr)
+			uploadLayer(page, i);
+	}
+}
+
+void TextureArrayAtlas::uploadLayer(Page *page, int layer)
+{
+	Image *image = page->images[layer];
+	love::image::ImageData *data = (love::image::ImageData *) image->data.get(0, 0);
+
+	love::thread::Lock lock(data->getMutex());
+
+	Rect rect = {0, 0, data->getWidth(), data->getHeight()};
+	page->array->replacePixels(data->getData(), data->getSize(), layer, 0, rect, page->mipmaps);
+}
+
+} // graphics
+} // love
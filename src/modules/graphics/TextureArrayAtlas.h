@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/int.h"
+#include "Image.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * Keeps copies of small Images in layers of shared array textures, so draws
+ * of different Images with the same size and format can be batched together.
+ * Each array starts out with a few layers and is recreated with more as
+ * Images are added, up to a limit.
+ **/
+class TextureArrayAtlas
+{
+public:
+
+	// Images larger than this in either dimension aren't copied.
+	static const int MAX_IMAGE_SIZE = 512;
+
+	TextureArrayAtlas(Graphics *gfx);
+	~TextureArrayAtlas();
+
+	/**
+	 * Gets the array texture and layer holding a copy of the Image, adding the
+	 * Image first if needed. Returns null if the Image can't be drawn from an
+	 * array texture right now.
+	 **/
+	Image *getArray(Image *image, int &layer);
+
+	/**
+	 * Re-uploads the Image's copy after its contents have been replaced.
+	 **/
+	void updateImage(Image *image);
+
+	void removeImage(Image *image);
+
+	/**
+	 * Re-uploads all copies, after the array textures have been recreated.
+	 **/
+	void reload();
+
+private:
+
+	struct Page
+	{
+		StrongRef<Image> array;
+
+		PixelFormat format;
+		int width;
+		int height;
+		bool mipmaps;
+		bool linear;
+
+		Texture::Filter filter;
+		Texture::Wrap wrap;
+
+		// Null for free layers.
+		std::vector<Image *> images;
+		int usedLayers;
+	};
+
+	bool isSupported(Image *image) const;
+	bool matches(const Page *page, Image *image) const;
+
+	void addImage(Image *image);
+	void createArray(Page *page, int layercount);
+	void uploadLayer(Page *page, int layer);
+
+	Graphics *gfx;
+	int maxLayers;
+
+	std::vector<Page *> pages;
+
+}; // TextureArrayAtlas
+
+} // graphics
+} // love
@@ -161,6 +161,13 @@ void Buffer::setMappedRangeModified(size_t offset, size_t modifiedsize)
 	if (!is_mapped || !(map_flags & MAP_EXPLICIT_RANGE_MODIFY))
 		return;
 
+	if (modified_size == 0)
+	{
+		modified_offset = offset;
+		modified_size = modifiedsize;
+		return;
+	}
+
 	// We're being conservative right now by internally marking the whole range
 	// from the start of section a to the end of section b as modified if both
 	// a and b are marked as modified.
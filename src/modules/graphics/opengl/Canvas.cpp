@@ -414,8 +414,32 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 {
 	love::image::ImageData *data = love::graphics::Canvas::newImageData(module, slice, mipmap, r);
 
+	readPixels(slice, mipmap, r, data->getFormat(), data->getData());
+
+	return data;
+}
+
+love::image::ImageData *Canvas::newImageDataAsync(love::image::Image *module, int slice, int mipmap, const Rect &r, GLuint &pbo)
+{
+	love::image::ImageData *data = love::graphics::Canvas::newImageData(module, slice, mipmap, r);
+
+	glGenBuffers(1, &pbo);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+	glBufferData(GL_PIXEL_PACK_BUFFER, data->getSize(), nullptr, GL_STREAM_READ);
+
+	// With a pixel pack buffer bound, the destination is an offset into it
+	// and glReadPixels returns without waiting for the GPU.
+	readPixels(slice, mipmap, r, data->getFormat(), nullptr);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	return data;
+}
+
+void Canvas::readPixels(int slice, int mipmap, const Rect &r, PixelFormat format, void *dst)
+{
 	bool isSRGB = false;
-	OpenGL::TextureFormat fmt = gl.convertPixelFormat(data->getFormat(), false, isSRGB);
+	OpenGL::TextureFormat fmt = gl.convertPixelFormat(format, false, isSRGB);
 
 	GLuint current_fbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getFBO());
@@ -427,14 +451,12 @@ love::image::ImageData *Canvas::newImageData(love::image::Image *module, int sli
 		gl.framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, mipmap, layer, face);
 	}
 
-	glReadPixels(r.x, r.y, r.w, r.h, fmt.externalformat, fmt.type, data->getData());
+	glReadPixels(r.x, r.y, r.w, r.h, fmt.externalformat, fmt.type, dst);
 
 	if (slice > 0 || mipmap > 0)
 		gl.framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, 0, 0, 0);
 
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
-
-	return data;
 }
 
 void Canvas::generateMipmaps()
@@ -54,6 +54,14 @@ public:
 	ptrdiff_t getHandle() const override;
 
 	love::image::ImageData *newImageData(love::image::Image *module, int slice, int mipmap, const Rect &rect) override;
+
+	/**
+	 * Starts reading the Canvas's pixels into a new pixel buffer object,
+	 * without waiting for the GPU. The returned ImageData has the size and
+	 * format of the result, but its contents are only valid once the buffer
+	 * has been copied into it.
+	 **/
+	love::image::ImageData *newImageDataAsync(love::image::Image *module, int slice, int mipmap, const Rect &rect, GLuint &pbo);
 	void generateMipmaps() override;
 
 	int getMSAA() const override
@@ -85,6 +93,8 @@ public:
 
 private:
 
+	void readPixels(int slice, int mipmap, const Rect &rect, PixelFormat format, void *dst);
+
 	struct SupportedFormat
 	{
 		bool readable = false;
@@ -52,6 +52,7 @@ bool FenceSync::cpuWait()
 
 	GLbitfield flags = 0;
 	GLuint64 duration = 0;
+	bool stalled = false;
 
 	while (true)
 	{
@@ -65,11 +66,24 @@ bool FenceSync::cpuWait()
 
 		flags = GL_SYNC_FLUSH_COMMANDS_BIT;
 		duration = 1000000000; // 1 second in nanoseconds.
+		stalled = true;
 	}
 
 	cleanup();
 
-	return true;
+	return stalled;
+}
+
+bool FenceSync::isComplete()
+{
+	if (sync == 0)
+		return true;
+
+	// The flush makes sure the fence is eventually reached even if nothing
+	// else is submitted.
+	GLenum status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+	return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED;
 }
 
 void FenceSync::cleanup()
@@ -42,7 +42,13 @@ public:
 	~FenceSync();
 
 	bool fence();
+
+	// Returns true if the GPU hadn't reached the fence yet, so the CPU had to
+	// wait for it.
 	bool cpuWait();
+
+	// Returns true if the GPU has reached the fence, without waiting for it.
+	bool isComplete();
 	void cleanup();
 
 private:
@@ -221,6 +221,10 @@ bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, b
 	if (!Volatile::loadAll())
 		::printf("Could not reload all volatile objects.\n");
 
+	// Array textures used for automatic batching don't keep their own data.
+	if (textureArrayAtlas != nullptr)
+		textureArrayAtlas->reload();
+
 	createQuadIndexBuffer();
 
 	// Restore the graphics state.
@@ -235,6 +239,9 @@ bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, b
 		if (i == Shader::STANDARD_ARRAY && !capabilities.textureTypes[TEXTURE_2D_ARRAY])
 			continue;
 
+		if (i == Shader::STANDARD_INSTANCED && !capabilities.features[FEATURE_INSTANCING])
+			continue;
+
 		// Apparently some intel GMA drivers on windows fail to compile shaders
 		// which use array textures despite claiming support for the extension.
 		try
@@ -247,9 +254,11 @@ bool Graphics::setMode(int width, int height, int pixelwidth, int pixelheight, b
 		}
 		catch (love::Exception &)
 		{
+			// Distance field fonts fall back to the default shader when
+			// derivatives aren't available (OpenGL ES 2 without an extension.)
 			if (i == Shader::STANDARD_ARRAY)
 				capabilities.textureTypes[TEXTURE_2D_ARRAY] = false;
-			else
+			else if (i != Shader::STANDARD_INSTANCED && i != Shader::STANDARD_DISTANCE_FIELD && i != Shader::STANDARD_SKINNED)
 				throw;
 		}
 	}
@@ -282,6 +291,14 @@ void Graphics::unSetMode()
 	framebufferObjects.clear();
 	temporaryCanvases.clear();
 
+	cancelReadbacks();
+
+	discardProfileQueries();
+
+	if (!freeTimestampQueries.empty())
+		glDeleteQueries((GLsizei) freeTimestampQueries.size(), &freeTimestampQueries[0]);
+	freeTimestampQueries.clear();
+
 	if (mainVAO != 0)
 	{
 		glDeleteVertexArrays(1, &mainVAO);
@@ -899,6 +916,9 @@ void Graphics::present(void *screenshotCallbackData)
 
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, gl.getDefaultFBO());
 
+	processReadbacks(screenshotCallbackData);
+	processAsyncImages(screenshotCallbackData);
+
 	if (!pendingScreenshotCallbacks.empty())
 	{
 		int w = getPixelWidth();
@@ -997,6 +1017,8 @@ void Graphics::present(void *screenshotCallbackData)
 	glBindRenderbuffer(GL_RENDERBUFFER, info.info.uikit.colorbuffer);
 #endif
 
+	finishProfileFrame();
+
 	for (StreamBuffer *buffer : streamBufferState.vb)
 		buffer->nextFrame();
 	streamBufferState.indexBuffer->nextFrame();
@@ -1025,6 +1047,96 @@ void Graphics::present(void *screenshotCallbackData)
 	}
 }
 
+void Graphics::captureCanvas(love::graphics::Canvas *canvas, int slice, int mipmap, const Rect &rect, const ScreenshotInfo &info)
+{
+	auto imagemodule = Module::getInstance<love::image::Image>(M_IMAGE);
+	if (imagemodule == nullptr)
+		throw love::Exception("The love.image module must be loaded to read back Canvas pixels.");
+
+	Canvas *glcanvas = (Canvas *) canvas;
+
+	pendingReadbacks.emplace_back();
+	PendingReadback &readback = pendingReadbacks.back();
+	readback.info = info;
+
+	try
+	{
+		// Without async readback support the pixels are read right away, but
+		// the callback is still deferred to present() for consistency.
+		if (gl.isAsyncReadbackSupported())
+		{
+			readback.data.set(glcanvas->newImageDataAsync(imagemodule, slice, mipmap, rect, readback.pbo), Acquire::NORETAIN);
+			readback.sync.fence();
+		}
+		else
+			readback.data.set(glcanvas->newImageData(imagemodule, slice, mipmap, rect), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		if (readback.pbo != 0)
+			glDeleteBuffers(1, &readback.pbo);
+		pendingReadbacks.pop_back();
+		throw;
+	}
+}
+
+void Graphics::processReadbacks(void *callbackdata)
+{
+	auto it = pendingReadbacks.begin();
+
+	while (it != pendingReadbacks.end())
+	{
+		// Readbacks complete in order, so there's no point checking the rest.
+		if (it->pbo != 0 && !it->sync.isComplete())
+			break;
+
+		StrongRef<love::image::ImageData> data = it->data;
+		ScreenshotInfo info = it->info;
+		bool success = true;
+
+		if (it->pbo != 0)
+		{
+			size_t size = data->getSize();
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, it->pbo);
+
+			const void *src = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr) size, GL_MAP_READ_BIT);
+			if (src != nullptr)
+			{
+				memcpy(data->getData(), src, size);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			}
+			else
+				success = false;
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			glDeleteBuffers(1, &it->pbo);
+		}
+
+		// Remove it before calling the callback, which may add new readbacks
+		// or throw.
+		it = pendingReadbacks.erase(it);
+
+		if (success)
+			info.callback(&info, data, callbackdata);
+		else
+			info.callback(&info, nullptr, nullptr);
+	}
+}
+
+void Graphics::cancelReadbacks()
+{
+	for (PendingReadback &readback : pendingReadbacks)
+	{
+		if (readback.pbo != 0)
+			glDeleteBuffers(1, &readback.pbo);
+
+		readback.info.callback(&readback.info, nullptr, nullptr);
+	}
+
+	pendingReadbacks.clear();
+}
+
 void Graphics::setScissor(const Rect &rect)
 {
 	flushStreamDraws();
@@ -1303,7 +1415,9 @@ void Graphics::setBlendMode(BlendMode mode, BlendAlpha alphamode)
 
 void Graphics::setPointSize(float size)
 {
-	if (streamBufferState.primitiveMode == PRIMITIVE_POINTS)
+	// Deferred draws (including points) are only submitted later, so they
+	// must go out before the point size changes.
+	if (streamBufferState.primitiveMode == PRIMITIVE_POINTS || !deferredStreamState.draws.empty())
 		flushStreamDraws();
 
 	gl.setPointSize(size * getCurrentDPIScale());
@@ -1362,6 +1476,65 @@ void Graphics::getAPIStats(int &shaderswitches) const
 	shaderswitches = gl.stats.shaderSwitches;
 }
 
+bool Graphics::isUInt32IndexSupported() const
+{
+	return gl.isUInt32IndexSupported();
+}
+
+uint32 Graphics::queryGPUTimestamp()
+{
+	if (!isCreated() || !gl.isTimerQuerySupported())
+		return 0;
+
+	GLuint query = 0;
+
+	if (!freeTimestampQueries.empty())
+	{
+		query = freeTimestampQueries.back();
+		freeTimestampQueries.pop_back();
+	}
+	else
+		glGenQueries(1, &query);
+
+	glQueryCounter(query, GL_TIMESTAMP);
+	return query;
+}
+
+bool Graphics::getGPUTimestamp(uint32 query, bool wait, uint64 &nanoseconds)
+{
+	if (!wait)
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (available == GL_FALSE)
+			return false;
+	}
+
+	GLuint64 result = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+
+	nanoseconds = result;
+	return true;
+}
+
+void Graphics::releaseGPUTimestamp(uint32 query)
+{
+	freeTimestampQueries.push_back((GLuint) query);
+}
+
+bool Graphics::checkGPUTimestampDisjoint()
+{
+	// Only the ES extension has a disjoint flag. Reading it also clears it.
+	if (!isCreated() || !gl.isTimerQueryDisjointSupported())
+		return false;
+
+	GLint disjoint = GL_FALSE;
+	glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+	return disjoint != GL_FALSE;
+}
+
 void Graphics::initCapabilities()
 {
 	capabilities.features[FEATURE_MULTI_CANVAS_FORMATS] = Canvas::isMultiFormatMultiCanvasSupported();
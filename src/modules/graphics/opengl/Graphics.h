@@ -24,6 +24,7 @@
 // STD
 #include <stack>
 #include <vector>
+#include <list>
 #include <unordered_map>
 
 // OpenGL
@@ -39,6 +40,7 @@
 #include "Image.h"
 #include "Canvas.h"
 #include "Shader.h"
+#include "FenceSync.h"
 
 #include "libraries/xxHash/xxhash.h"
 
@@ -82,6 +84,8 @@ public:
 
 	void present(void *screenshotCallbackData) override;
 
+	void captureCanvas(love::graphics::Canvas *canvas, int slice, int mipmap, const Rect &rect, const ScreenshotInfo &info) override;
+
 	void setColor(Colorf c) override;
 
 	void setScissor(const Rect &rect) override;
@@ -142,6 +146,11 @@ private:
 	void setCanvasInternal(const RenderTargets &rts, int w, int h, int pixelw, int pixelh, bool hasSRGBcanvas) override;
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
+	bool isUInt32IndexSupported() const override;
+	uint32 queryGPUTimestamp() override;
+	bool getGPUTimestamp(uint32 query, bool wait, uint64 &nanoseconds) override;
+	void releaseGPUTimestamp(uint32 query) override;
+	bool checkGPUTimestampDisjoint() override;
 
 	void endPass();
 	void bindCachedFBO(const RenderTargets &targets);
@@ -149,10 +158,27 @@ private:
 
 	void setDebug(bool enable);
 
+	struct PendingReadback
+	{
+		// 0 if the pixels were read synchronously into the ImageData.
+		GLuint pbo = 0;
+		FenceSync sync;
+		StrongRef<love::image::ImageData> data;
+		ScreenshotInfo info;
+	};
+
+	void processReadbacks(void *callbackdata);
+	void cancelReadbacks();
+
 	std::unordered_map<RenderTargets, GLuint, CachedFBOHasher> framebufferObjects;
 	bool windowHasStencil;
 	GLuint mainVAO;
 
+	std::vector<GLuint> freeTimestampQueries;
+
+	// A list, since copying a FenceSync would delete its sync object twice.
+	std::list<PendingReadback> pendingReadbacks;
+
 }; // Graphics
 
 } // opengl
@@ -97,6 +97,7 @@ OpenGL::OpenGL()
 	, contextInitialized(false)
 	, pixelShaderHighpSupported(false)
 	, baseVertexSupported(false)
+	, programBinarySupported(false)
 	, maxAnisotropy(1.0f)
 	, max2DTextureSize(0)
 	, max3DTextureSize(0)
@@ -395,6 +396,19 @@ void OpenGL::initOpenGLFunctions()
 		}
 	}
 
+	if (GLAD_EXT_disjoint_timer_query && !(GLAD_VERSION_3_3 || GLAD_ARB_timer_query))
+	{
+		fp_glQueryCounter = fp_glQueryCounterEXT;
+		fp_glGetQueryObjectui64v = fp_glGetQueryObjectui64vEXT;
+
+		if (!GLAD_ES_VERSION_3_0)
+		{
+			fp_glGenQueries = fp_glGenQueriesEXT;
+			fp_glDeleteQueries = fp_glDeleteQueriesEXT;
+			fp_glGetQueryObjectuiv = fp_glGetQueryObjectuivEXT;
+		}
+	}
+
 	if (GLAD_ES_VERSION_2_0 && GLAD_OES_texture_3D && !GLAD_ES_VERSION_3_0)
 	{
 		// Function signatures don't match, we'll have to conditionally call it
@@ -431,6 +445,12 @@ void OpenGL::initOpenGLFunctions()
 
 		}
 	}
+
+	if (GLAD_OES_get_program_binary && !(GLAD_VERSION_4_1 || GLAD_ARB_get_program_binary || GLAD_ES_VERSION_3_0))
+	{
+		fp_glGetProgramBinary = fp_glGetProgramBinaryOES;
+		fp_glProgramBinary = fp_glProgramBinaryOES;
+	}
 }
 
 void OpenGL::initMaxValues()
@@ -448,6 +468,15 @@ void OpenGL::initMaxValues()
 	baseVertexSupported = GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_2 || GLAD_ARB_draw_elements_base_vertex
 		|| GLAD_OES_draw_elements_base_vertex || GLAD_EXT_draw_elements_base_vertex;
 
+	// Drivers can support the API without supporting any binary formats.
+	programBinarySupported = false;
+	if (GLAD_VERSION_4_1 || GLAD_ARB_get_program_binary || GLAD_ES_VERSION_3_0 || GLAD_OES_get_program_binary)
+	{
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		programBinarySupported = formats > 0;
+	}
+
 	// We'll need this value to clamp anisotropy.
 	if (GLAD_EXT_texture_filter_anisotropic)
 		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
@@ -1244,6 +1273,33 @@ bool OpenGL::isBaseVertexSupported() const
 	return baseVertexSupported;
 }
 
+bool OpenGL::isUInt32IndexSupported() const
+{
+	return GLAD_VERSION_1_1 || GLAD_ES_VERSION_3_0 || GLAD_OES_element_index_uint;
+}
+
+bool OpenGL::isTimerQuerySupported() const
+{
+	return GLAD_VERSION_3_3 || GLAD_ARB_timer_query || GLAD_EXT_disjoint_timer_query;
+}
+
+bool OpenGL::isTimerQueryDisjointSupported() const
+{
+	return GLAD_EXT_disjoint_timer_query && !(GLAD_VERSION_3_3 || GLAD_ARB_timer_query);
+}
+
+bool OpenGL::isProgramBinarySupported() const
+{
+	return programBinarySupported;
+}
+
+bool OpenGL::isAsyncReadbackSupported() const
+{
+	// Needs pixel buffer objects, fence syncs, and glMapBufferRange.
+	return GLAD_VERSION_3_2 || GLAD_ES_VERSION_3_0
+		|| (GLAD_VERSION_2_1 && GLAD_ARB_sync && GLAD_ARB_map_buffer_range);
+}
+
 int OpenGL::getMax2DTextureSize() const
 {
 	return std::max(max2DTextureSize, 1);
@@ -360,6 +360,11 @@ public:
 	bool isDepthCompareSampleSupported() const;
 	bool isSamplerLODBiasSupported() const;
 	bool isBaseVertexSupported() const;
+	bool isUInt32IndexSupported() const;
+	bool isTimerQuerySupported() const;
+	bool isTimerQueryDisjointSupported() const;
+	bool isProgramBinarySupported() const;
+	bool isAsyncReadbackSupported() const;
 
 	/**
 	 * Returns the maximum supported width or height of a texture.
@@ -440,6 +445,7 @@ private:
 
 	bool pixelShaderHighpSupported;
 	bool baseVertexSupported;
+	bool programBinarySupported;
 
 	float maxAnisotropy;
 	float maxLODBias;
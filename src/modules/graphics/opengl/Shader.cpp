@@ -46,6 +46,18 @@ Shader::Shader(love::graphics::ShaderStage *vertex, love::graphics::ShaderStage
 	, lastViewport()
 	, lastPointSize(0.0f)
 {
+	if (gl.isProgramBinarySupported())
+		programCacheKey = getProgramCacheKey(vertex, pixel);
+
+	// Programs in the shader cache were validated when they were first
+	// compiled, so glslang doesn't need to parse them again.
+	if (!readProgramCache(programCacheKey, cachedProgram))
+	{
+		std::string err;
+		if (!validate(vertex, pixel, err))
+			throw love::Exception("%s", err.c_str());
+	}
+
 	// load shader source and create program object
 	loadVolatile();
 }
@@ -312,42 +324,67 @@ bool Shader::loadVolatile()
 	textureUnits.clear();
 	textureUnits.push_back(TextureUnit());
 
-	for (const auto &stage : stages)
+	bool cachehit = !cachedProgram.empty() && loadCachedProgram();
+
+	// Drop the binary either way, since it's only needed once. Reloading
+	// after a context loss compiles from source again.
+	std::vector<uint8>().swap(cachedProgram);
+
+	if (!cachehit)
 	{
-		if (stage.get() != nullptr)
-			stage->loadVolatile();
-	}
+		for (const auto &stage : stages)
+		{
+			if (stage.get() != nullptr)
+				stage->loadVolatile();
+		}
 
-	program = glCreateProgram();
+		program = glCreateProgram();
 
-	if (program == 0)
-		throw love::Exception("Cannot create shader program object.");
+		if (program == 0)
+			throw love::Exception("Cannot create shader program object.");
 
-	for (const auto &stage : stages)
-	{
-		if (stage.get() != nullptr)
-			glAttachShader(program, (GLuint) stage->getHandle());
-	}
+		for (const auto &stage : stages)
+		{
+			if (stage.get() != nullptr)
+				glAttachShader(program, (GLuint) stage->getHandle());
+		}
 
-	// Bind generic vertex attribute indices to names in the shader.
-	for (int i = 0; i < int(ATTRIB_MAX_ENUM); i++)
-	{
-		const char *name = nullptr;
-		if (vertex::getConstant((VertexAttribID) i, name))
-			glBindAttribLocation(program, i, (const GLchar *) name);
-	}
+		// Bind generic vertex attribute indices to names in the shader.
+		for (int i = 0; i < int(ATTRIB_MAX_ENUM); i++)
+		{
+			const char *name = nullptr;
+			if (vertex::getConstant((VertexAttribID) i, name))
+				glBindAttribLocation(program, i, (const GLchar *) name);
+		}
 
-	glLinkProgram(program);
+		if (!programCacheKey.empty() && fp_glProgramParameteri != nullptr)
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
-	GLint status;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
+		glLinkProgram(program);
 
-	if (status == GL_FALSE)
+		GLint status;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+		if (status == GL_FALSE)
+		{
+			std::string warnings = getProgramWarnings();
+			glDeleteProgram(program);
+			program = 0;
+			throw love::Exception("Cannot link shader program object:\n%s", warnings.c_str());
+		}
+	}
+
+	if (!programCacheKey.empty())
 	{
-		std::string warnings = getProgramWarnings();
-		glDeleteProgram(program);
-		program = 0;
-		throw love::Exception("Cannot link shader program object:\n%s", warnings.c_str());
+		if (cachehit)
+			programCacheHits++;
+		else
+		{
+			programCacheMisses++;
+			saveCachedProgram();
+		}
+
+		programCacheKey.clear();
 	}
 
 	// Get all active uniform variables in this shader from OpenGL.
@@ -415,6 +452,61 @@ std::string Shader::getProgramWarnings() const
 	return warnings;
 }
 
+bool Shader::loadCachedProgram()
+{
+	// The cached data is the binary format enum followed by the binary.
+	if (cachedProgram.size() <= sizeof(uint32))
+		return false;
+
+	uint32 format = 0;
+	memcpy(&format, cachedProgram.data(), sizeof(uint32));
+
+	const uint8 *binary = cachedProgram.data() + sizeof(uint32);
+	GLsizei length = (GLsizei) (cachedProgram.size() - sizeof(uint32));
+
+	program = glCreateProgram();
+
+	if (program == 0)
+		return false;
+
+	glProgramBinary(program, (GLenum) format, binary, length);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		program = 0;
+		return false;
+	}
+
+	return true;
+}
+
+void Shader::saveCachedProgram()
+{
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+		return;
+
+	std::vector<uint8> data(sizeof(uint32) + length);
+
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &written, &format, data.data() + sizeof(uint32));
+
+	if (written <= 0)
+		return;
+
+	uint32 format32 = (uint32) format;
+	memcpy(data.data(), &format32, sizeof(uint32));
+
+	writeProgramCache(programCacheKey, data.data(), sizeof(uint32) + written);
+}
+
 std::string Shader::getWarnings() const
 {
 	std::string warnings;
@@ -654,6 +746,43 @@ void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count
 	}
 }
 
+void Shader::copyUniforms(const love::graphics::Shader *source)
+{
+	for (auto &p : uniforms)
+	{
+		UniformInfo &info = p.second;
+
+		// Built-in uniforms are kept up to date by Graphics.
+		BuiltinUniform builtin;
+		if (getConstant(info.name.c_str(), builtin))
+			continue;
+
+		const UniformInfo *sourceinfo = source->getUniformInfo(info.name);
+
+		if (sourceinfo == nullptr || sourceinfo->baseType != info.baseType || sourceinfo->count != info.count)
+			continue;
+
+		if (info.baseType == UNIFORM_MATRIX)
+		{
+			if (sourceinfo->matrix.columns != info.matrix.columns || sourceinfo->matrix.rows != info.matrix.rows)
+				continue;
+		}
+		else if (sourceinfo->components != info.components)
+			continue;
+
+		if (info.baseType == UNIFORM_SAMPLER)
+		{
+			if (sourceinfo->textureType == info.textureType)
+				sendTextures(&info, sourceinfo->textures, info.count, true);
+		}
+		else if (info.dataSize > 0 && memcmp(info.data, sourceinfo->data, info.dataSize) != 0)
+		{
+			memcpy(info.data, sourceinfo->data, info.dataSize);
+			updateUniform(&info, info.count);
+		}
+	}
+}
+
 void Shader::flushStreamDraws() const
 {
 	if (current == this)
@@ -65,6 +65,7 @@ public:
 	bool hasUniform(const std::string &name) const override;
 	ptrdiff_t getHandle() const override;
 	void setVideoTextures(Texture *ytexture, Texture *cbtexture, Texture *crtexture) override;
+	void copyUniforms(const love::graphics::Shader *source) override;
 
 	void updateScreenParams();
 	void updatePointSize(float size);
@@ -99,6 +100,11 @@ private:
 	// Get any warnings or errors generated only by the shader program object.
 	std::string getProgramWarnings() const;
 
+	// Creates the program from a binary in the shader cache. Returns false
+	// if the driver rejects it.
+	bool loadCachedProgram();
+	void saveCachedProgram();
+
 	// volatile
 	GLuint program;
 
@@ -119,6 +125,11 @@ private:
 
 	std::vector<std::pair<const UniformInfo *, int>> pendingUniformUpdates;
 
+	// Key in the shader cache and the binary read from it. Both are only used
+	// the first time the program is loaded.
+	std::string programCacheKey;
+	std::vector<uint8> cachedProgram;
+
 	bool canvasWasActive;
 	Rect lastViewport;
 
@@ -31,7 +31,8 @@ ShaderStage::ShaderStage(love::graphics::Graphics *gfx, StageType stage, const s
 	: love::graphics::ShaderStage(gfx, stage, source, gles, cachekey)
 	, glShader(0)
 {
-	loadVolatile();
+	// The GL shader object is compiled when a Shader using this stage needs
+	// it, since programs loaded from the shader cache don't.
 }
 
 ShaderStage::~ShaderStage()
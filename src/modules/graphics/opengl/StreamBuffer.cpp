@@ -36,8 +36,10 @@ namespace graphics
 namespace opengl
 {
 
-// Typically this should be 3 frames, but we only do per-frame syncing right now
-// so we add an extra frame to reduce the (small) chance of stalls.
+// The synced buffers are split into this many sections, each guarded by a
+// fence. Typically this should be 3 frames, but we only sync per frame (or when
+// a frame fills its section) so we add an extra one to reduce the (small)
+// chance of stalls.
 static const int BUFFER_FRAMES = 4;
 
 class StreamBufferClientMemory final : public love::graphics::StreamBuffer
@@ -73,6 +75,24 @@ public:
 		return (size_t) data;
 	}
 
+	void resize(size_t newsize) override
+	{
+		uint8 *newdata = nullptr;
+
+		try
+		{
+			newdata = new uint8[newsize];
+		}
+		catch (std::exception &)
+		{
+			throw love::Exception("Out of memory.");
+		}
+
+		delete[] data;
+		data = newdata;
+		bufferSize = newsize;
+	}
+
 	void markUsed(size_t /*usedsize*/) override { }
 	ptrdiff_t getHandle() const override { return 0; }
 
@@ -111,8 +131,17 @@ public:
 		delete[] data;
 	}
 
-	MapInfo map(size_t /*minsize*/) override
+	size_t getUsableSize() const override
 	{
+		// The buffer is orphaned if the rest of it is too small.
+		return bufferSize;
+	}
+
+	MapInfo map(size_t minsize) override
+	{
+		if (minsize > bufferSize - frameGPUReadOffset)
+			orphan = true;
+
 		if (orphan)
 		{
 			orphan = false;
@@ -136,6 +165,28 @@ public:
 		frameGPUReadOffset += usedsize;
 	}
 
+	void resize(size_t newsize) override
+	{
+		uint8 *newdata = nullptr;
+
+		try
+		{
+			newdata = new uint8[newsize];
+		}
+		catch (std::exception &)
+		{
+			throw love::Exception("Out of memory.");
+		}
+
+		unloadVolatile();
+
+		delete[] data;
+		data = newdata;
+		bufferSize = newsize;
+
+		loadVolatile();
+	}
+
 	void nextFrame() override
 	{
 		// Orphan the buffer before its first use in the next frame.
@@ -187,11 +238,19 @@ public:
 	StreamBufferSync(BufferType type, size_t size)
 		: love::graphics::StreamBuffer(type, size)
 		, frameIndex(0)
+		, frameSections(1)
 		, syncs()
 	{}
 
 	virtual ~StreamBufferSync() {}
 
+	size_t getUsableSize() const override
+	{
+		// map() moves on to the next section when this one is full, so a
+		// whole section is always available.
+		return bufferSize;
+	}
+
 	void nextFrame() override
 	{
 		// Insert a GPU fence for this frame's section of the data, we'll wait
@@ -200,6 +259,14 @@ public:
 
 		frameIndex = (frameIndex + 1) % BUFFER_FRAMES;
 		frameGPUReadOffset = 0;
+		stallCount = 0;
+
+		// Grow between frames if the last one didn't fit in a single section,
+		// so it doesn't have to happen in the middle of one.
+		if (frameSections > 1)
+			resize(bufferSize * frameSections);
+
+		frameSections = 1;
 	}
 
 	void markUsed(size_t usedsize) override
@@ -212,7 +279,25 @@ public:
 
 protected:
 
+	// Makes sure the current section has room for minsize bytes and that the
+	// GPU is done with it.
+	void prepareMap(size_t minsize)
+	{
+		if (minsize > bufferSize - frameGPUReadOffset)
+		{
+			syncs[frameIndex].fence();
+
+			frameIndex = (frameIndex + 1) % BUFFER_FRAMES;
+			frameGPUReadOffset = 0;
+			frameSections++;
+		}
+
+		if (syncs[frameIndex].cpuWait())
+			stallCount++;
+	}
+
 	int frameIndex;
+	int frameSections;
 	FenceSync syncs[BUFFER_FRAMES];
 
 }; // StreamBufferSync
@@ -234,12 +319,12 @@ public:
 		unloadVolatile();
 	}
 
-	MapInfo map(size_t /*minsize*/) override
+	MapInfo map(size_t minsize) override
 	{
 		gl.bindBuffer(mode, vbo);
 
 		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		prepareMap(minsize);
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -261,6 +346,13 @@ public:
 		return (frameIndex * bufferSize) + frameGPUReadOffset;
 	}
 
+	void resize(size_t newsize) override
+	{
+		unloadVolatile();
+		bufferSize = newsize;
+		loadVolatile();
+	}
+
 	ptrdiff_t getHandle() const override { return vbo; }
 
 	bool loadVolatile() override
@@ -315,10 +407,10 @@ public:
 		unloadVolatile();
 	}
 
-	MapInfo map(size_t /*minsize*/) override
+	MapInfo map(size_t minsize) override
 	{
 		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		prepareMap(minsize);
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -336,6 +428,13 @@ public:
 		return offset;
 	}
 
+	void resize(size_t newsize) override
+	{
+		unloadVolatile();
+		bufferSize = newsize;
+		loadVolatile();
+	}
+
 	ptrdiff_t getHandle() const override { return vbo; }
 
 	bool loadVolatile() override
@@ -406,10 +505,10 @@ public:
 		alignedFree(data);
 	}
 
-	MapInfo map(size_t /*minsize*/) override
+	MapInfo map(size_t minsize) override
 	{
 		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		prepareMap(minsize);
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -427,6 +526,22 @@ public:
 		return offset;
 	}
 
+	void resize(size_t newsize) override
+	{
+		unloadVolatile();
+		alignedFree(data);
+		data = nullptr;
+
+		size_t alignment = getPageSize();
+		bufferSize = newsize;
+		alignedSize = alignUp(newsize * BUFFER_FRAMES, alignment);
+
+		if (!alignedMalloc((void **) &data, alignedSize, alignment))
+			throw love::Exception("Out of memory.");
+
+		loadVolatile();
+	}
+
 	ptrdiff_t getHandle() const override { return vbo; }
 
 	bool loadVolatile() override
@@ -19,6 +19,7 @@
  **/
 
 #include "wrap_Canvas.h"
+#include "wrap_Graphics.h"
 #include "Graphics.h"
 
 namespace love
@@ -115,6 +116,39 @@ int w_Canvas_newImageData(lua_State *L)
 	return 1;
 }
 
+int w_Canvas_newImageDataAsync(lua_State *L)
+{
+	Canvas *canvas = luax_checkcanvas(L, 1);
+	Graphics *gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	int slice = 0;
+	int mipmap = 0;
+	Rect rect = {0, 0, canvas->getPixelWidth(), canvas->getPixelHeight()};
+
+	if (canvas->getTextureType() != TEXTURE_2D)
+		slice = (int) luaL_checkinteger(L, 3) - 1;
+
+	mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+
+	if (!lua_isnoneornil(L, 5))
+	{
+		rect.x = (int) luaL_checkinteger(L, 5);
+		rect.y = (int) luaL_checkinteger(L, 6);
+		rect.w = (int) luaL_checkinteger(L, 7);
+		rect.h = (int) luaL_checkinteger(L, 8);
+	}
+
+	Graphics::ScreenshotInfo info;
+	luax_checkscreenshotinfo(L, 2, info);
+
+	luax_catchexcept(L,
+		[&]() { gfx->captureCanvas(canvas, slice, mipmap, rect, info); },
+		[&](bool except) { if (except) info.callback(&info, nullptr, nullptr); }
+	);
+
+	return 0;
+}
+
 int w_Canvas_generateMipmaps(lua_State *L)
 {
 	Canvas *c = luax_checkcanvas(L, 1);
@@ -138,6 +172,7 @@ static const luaL_Reg w_Canvas_functions[] =
 	{ "getMSAA", w_Canvas_getMSAA },
 	{ "renderTo", w_Canvas_renderTo },
 	{ "newImageData", w_Canvas_newImageData },
+	{ "newImageDataAsync", w_Canvas_newImageDataAsync },
 	{ "generateMipmaps", w_Canvas_generateMipmaps },
 	{ "getMipmapMode", w_Canvas_getMipmapMode },
 	{ 0, 0 }
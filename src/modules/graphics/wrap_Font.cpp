@@ -233,6 +233,62 @@ int w_Font_getDPIScale(lua_State *L)
 	return 1;
 }
 
+int w_Font_prewarm(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::Codepoints codepoints;
+
+	int count = std::max(lua_gettop(L) - 1, 1);
+
+	luax_catchexcept(L, [&]() {
+		for (int i = 2; i < count + 2; i++)
+		{
+			if (lua_type(L, i) == LUA_TSTRING)
+				Font::getCodepointsFromString(luax_checkstring(L, i), codepoints);
+			else if (lua_istable(L, i))
+			{
+				// {first, last} inclusive codepoint range.
+				lua_rawgeti(L, i, 1);
+				lua_rawgeti(L, i, 2);
+				bool valid = lua_isnumber(L, -2) && lua_isnumber(L, -1);
+				lua_Number first = lua_tonumber(L, -2);
+				lua_Number last = lua_tonumber(L, -1);
+				lua_pop(L, 2);
+
+				if (!valid)
+					throw love::Exception("Codepoint ranges must be tables containing two numbers.");
+
+				if (first < 0 || last > 0x10FFFF || first > last)
+					throw love::Exception("Invalid codepoint range: [%d, %d]", (int) first, (int) last);
+
+				for (uint32 c = (uint32) first; c <= (uint32) last; c++)
+					codepoints.push_back(c);
+			}
+			else
+				codepoints.push_back((uint32) luaL_checknumber(L, i));
+		}
+
+		t->prewarm(codepoints);
+	});
+
+	return 0;
+}
+
+int w_Font_setAsyncLoading(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	luax_catchexcept(L, [&](){ t->setAsyncLoading(enable); });
+	return 0;
+}
+
+int w_Font_isAsyncLoading(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isAsyncLoading());
+	return 1;
+}
+
 static const luaL_Reg w_Font_functions[] =
 {
 	{ "getHeight", w_Font_getHeight },
@@ -248,6 +304,9 @@ static const luaL_Reg w_Font_functions[] =
 	{ "hasGlyphs", w_Font_hasGlyphs },
 	{ "setFallbacks", w_Font_setFallbacks },
 	{ "getDPIScale", w_Font_getDPIScale },
+	{ "prewarm", w_Font_prewarm },
+	{ "setAsyncLoading", w_Font_setAsyncLoading },
+	{ "isAsyncLoading", w_Font_isAsyncLoading },
 	{ 0, 0 }
 };
 
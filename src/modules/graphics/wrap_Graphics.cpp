@@ -31,6 +31,7 @@
 #include "common/Reference.h"
 #include "math/wrap_Transform.h"
 #include "thread/wrap_Channel.h"
+#include "thread/threads.h"
 
 #include "opengl/Graphics.h"
 
@@ -39,6 +40,7 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <map>
 
 // Shove the wrap_Graphics.lua code directly into a raw string literal.
 static const char graphics_lua[] =
@@ -461,24 +463,100 @@ struct ScreenshotFileInfo
 	image::FormatHandler::EncodedFormat format;
 };
 
+// Screenshots are encoded in parallel, but written in the order they were
+// captured, so a later screenshot to the same file is never overwritten by
+// an earlier one. Whichever encode finishes writes every screenshot which is
+// ready and next in line.
+struct ScreenshotWriteQueue
+{
+	love::thread::MutexRef mutex;
+	uint64 nextTicket = 0;
+	uint64 nextWrite = 0;
+
+	struct Encoded
+	{
+		StrongRef<love::filesystem::Filesystem> filesystem;
+		std::string filename;
+		StrongRef<love::filesystem::FileData> filedata; // Null if encoding failed.
+	};
+
+	std::map<uint64, Encoded> encoded;
+};
+
+static ScreenshotWriteQueue &getScreenshotWriteQueue()
+{
+	static ScreenshotWriteQueue queue;
+	return queue;
+}
+
+static void writeEncodedScreenshots(ScreenshotWriteQueue &queue, uint64 ticket, const ScreenshotWriteQueue::Encoded &result)
+{
+	love::thread::Lock lock(queue.mutex);
+
+	queue.encoded[ticket] = result;
+
+	for (auto it = queue.encoded.find(queue.nextWrite); it != queue.encoded.end(); it = queue.encoded.find(queue.nextWrite))
+	{
+		const ScreenshotWriteQueue::Encoded &e = it->second;
+
+		try
+		{
+			if (e.filedata.get() != nullptr)
+				e.filesystem->write(e.filename.c_str(), e.filedata->getData(), e.filedata->getSize());
+		}
+		catch (love::Exception &ex)
+		{
+			printf("Screenshot saving failed: %s", ex.what());
+		}
+
+		queue.encoded.erase(it);
+		queue.nextWrite++;
+	}
+}
+
 static void screenshotFileCallback(const Graphics::ScreenshotInfo *info, love::image::ImageData *i, void * /*gd*/)
 {
 	if (info == nullptr)
 		return;
 
 	ScreenshotFileInfo *fileinfo = (ScreenshotFileInfo *) info->data;
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
 
-	if (i != nullptr && fileinfo != nullptr)
+	if (i != nullptr && fileinfo != nullptr && fs != nullptr)
 	{
-		try
+		// Encoding (PNG compression especially) is slow enough to cause a
+		// hitch, so it happens on a worker thread. The references keep the
+		// pixels and love.filesystem alive until the file is written.
+		StrongRef<love::image::ImageData> imagedata(i);
+		StrongRef<love::filesystem::Filesystem> filesystem(fs);
+		std::string filename = fileinfo->filename;
+		image::FormatHandler::EncodedFormat format = fileinfo->format;
+
+		ScreenshotWriteQueue &queue = getScreenshotWriteQueue();
+		uint64 ticket = 0;
+
 		{
-			i->encode(fileinfo->format, fileinfo->filename.c_str(), true);
+			love::thread::Lock lock(queue.mutex);
+			ticket = queue.nextTicket++;
 		}
-		catch (love::Exception &e)
+
+		instance()->getWorkerPool()->submit([imagedata, filesystem, filename, format, ticket]()
 		{
-			printf("Screenshot encoding or saving failed: %s", e.what());
-			// Do nothing...
-		}
+			ScreenshotWriteQueue::Encoded result = {filesystem, filename, nullptr};
+
+			try
+			{
+				result.filedata.set(imagedata->encode(format, filename.c_str(), false), Acquire::NORETAIN);
+			}
+			catch (love::Exception &e)
+			{
+				printf("Screenshot encoding failed: %s", e.what());
+			}
+
+			// Failed screenshots still take their turn, so later ones aren't
+			// held back.
+			writeEncodedScreenshots(getScreenshotWriteQueue(), ticket, result);
+		});
 	}
 
 	delete fileinfo;
@@ -500,20 +578,18 @@ static void screenshotChannelCallback(const Graphics::ScreenshotInfo *info, love
 	}
 }
 
-int w_captureScreenshot(lua_State *L)
+void luax_checkscreenshotinfo(lua_State *L, int idx, Graphics::ScreenshotInfo &info)
 {
-	Graphics::ScreenshotInfo info;
-
-	if (lua_isfunction(L, 1))
+	if (lua_isfunction(L, idx))
 	{
-		lua_pushvalue(L, 1);
+		lua_pushvalue(L, idx);
 		info.data = luax_refif(L, LUA_TFUNCTION);
 		lua_pop(L, 1);
 		info.callback = screenshotFunctionCallback;
 	}
-	else if (lua_isstring(L, 1))
+	else if (lua_isstring(L, idx))
 	{
-		std::string filename = luax_checkstring(L, 1);
+		std::string filename = luax_checkstring(L, idx);
 		std::string ext;
 
 		size_t dotpos = filename.rfind('.');
@@ -525,7 +601,7 @@ int w_captureScreenshot(lua_State *L)
 
 		image::FormatHandler::EncodedFormat format;
 		if (!image::ImageData::getConstant(ext.c_str(), format))
-			return luax_enumerror(L, "encoded image format", image::ImageData::getConstants(format), ext.c_str());
+			luax_enumerror(L, "encoded image format", image::ImageData::getConstants(format), ext.c_str());
 
 		ScreenshotFileInfo *fileinfo = new ScreenshotFileInfo;
 		fileinfo->filename = filename;
@@ -534,15 +610,21 @@ int w_captureScreenshot(lua_State *L)
 		info.data = fileinfo;
 		info.callback = screenshotFileCallback;
 	}
-	else if (luax_istype(L, 1, love::thread::Channel::type))
+	else if (luax_istype(L, idx, love::thread::Channel::type))
 	{
-		auto *channel = love::thread::luax_checkchannel(L, 1);
+		auto *channel = love::thread::luax_checkchannel(L, idx);
 		channel->retain();
 		info.data = channel;
 		info.callback = screenshotChannelCallback;
 	}
 	else
-		return luax_typerror(L, 1, "function, string, or Channel");
+		luax_typerror(L, idx, "function, string, or Channel");
+}
+
+int w_captureScreenshot(lua_State *L)
+{
+	Graphics::ScreenshotInfo info;
+	luax_checkscreenshotinfo(L, 1, info);
 
 	luax_catchexcept(L,
 		[&]() { instance()->captureScreenshot(info); },
@@ -678,15 +760,9 @@ int w_getStencilTest(lua_State *L)
 	return 2;
 }
 
-static void parseDPIScale(Data *d, float *dpiscale)
+static void parseDPIScale(const std::string &fname, float *dpiscale)
 {
-	auto fd = dynamic_cast<love::filesystem::FileData *>(d);
-	if (fd == nullptr)
-		return;
-
 	// Parse a density scale of 2.0 from "image@2x.png".
-	const std::string &fname = fd->getName();
-
 	size_t namelen = fname.length();
 	size_t atpos = fname.rfind('@');
 
@@ -700,6 +776,13 @@ static void parseDPIScale(Data *d, float *dpiscale)
 	}
 }
 
+static void parseDPIScale(Data *d, float *dpiscale)
+{
+	auto fd = dynamic_cast<love::filesystem::FileData *>(d);
+	if (fd != nullptr)
+		parseDPIScale(fd->getName(), dpiscale);
+}
+
 static Image::Settings w__optImageSettings(lua_State *L, int idx, bool &setdpiscale)
 {
 	Image::Settings s;
@@ -1036,6 +1119,113 @@ int w_newImage(lua_State *L)
 	return w__pushNewImage(L, slices, settings);
 }
 
+static void asyncImageCallback(const Graphics::AsyncImageInfo *info, Image *image, const char *error, void *gd)
+{
+	if (info == nullptr)
+		return;
+
+	lua_State *L = (lua_State *) gd;
+	Reference *ref = (Reference *) info->data;
+
+	if ((image != nullptr || error != nullptr) && L != nullptr)
+	{
+		if (ref == nullptr)
+			luaL_error(L, "Internal error in async image callback.");
+
+		ref->push(L);
+		delete ref;
+
+		if (image != nullptr)
+		{
+			luax_pushtype(L, image);
+			lua_call(L, 1, 0);
+		}
+		else
+		{
+			lua_pushnil(L);
+			lua_pushstring(L, error);
+			lua_call(L, 2, 0);
+		}
+	}
+	else
+		delete ref;
+}
+
+int w_newImageAsync(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	bool dpiscaleset = false;
+	Image::Settings settings = w__optImageSettings(L, 3, dpiscaleset);
+	float *autodpiscale = dpiscaleset ? nullptr : &settings.dpiScale;
+
+	// Filenames are read on the worker threads along with decoding. Other
+	// file arguments are read here.
+	StrongRef<filesystem::File> file;
+	StrongRef<Data> filedata;
+
+	if (lua_type(L, 1) == LUA_TSTRING)
+	{
+		luax_catchexcept(L, [&]() { file.set(filesystem::luax_getfile(L, 1), Acquire::NORETAIN); });
+
+		// Match FileData::getName, which doesn't include the extension.
+		std::string name = file->getFilename();
+		size_t dotpos = name.rfind('.');
+		if (dotpos != std::string::npos)
+			name = name.substr(0, dotpos);
+
+		parseDPIScale(name, autodpiscale);
+	}
+	else
+	{
+		filedata.set(filesystem::luax_getdata(L, 1), Acquire::NORETAIN);
+		parseDPIScale(filedata, autodpiscale);
+	}
+
+	Graphics::AsyncImageInfo info;
+	info.callback = asyncImageCallback;
+
+	lua_pushvalue(L, 2);
+	info.data = luax_refif(L, LUA_TFUNCTION);
+	lua_pop(L, 1);
+
+	luax_catchexcept(L,
+		[&]()
+		{
+			if (file.get())
+				instance()->newImageAsync(file, settings, info);
+			else
+				instance()->newImageAsync(filedata, settings, info);
+		},
+		[&](bool except) { if (except) info.callback(&info, nullptr, nullptr, nullptr); }
+	);
+
+	return 0;
+}
+
+int w_setAsyncImageBudget(lua_State *L)
+{
+	double bytes = luaL_checknumber(L, 1);
+	if (bytes < 0.0)
+		return luaL_error(L, "The async image budget cannot be negative.");
+
+	instance()->setAsyncImageBudget((size_t) bytes);
+	return 0;
+}
+
+int w_getAsyncImageBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getAsyncImageBudget());
+	return 1;
+}
+
+int w_getAsyncImageCount(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getAsyncImageCount());
+	return 1;
+}
+
 int w_newQuad(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1155,9 +1345,11 @@ int w_newSpriteBatch(lua_State *L)
 			return luax_enumerror(L, "usage hint", vertex::getConstants(usage), usagestr);
 	}
 
+	bool instanced = luax_optboolean(L, 4, false);
+
 	SpriteBatch *t = nullptr;
 	luax_catchexcept(L,
-		[&](){ t = instance()->newSpriteBatch(texture, size, usage); }
+		[&](){ t = instance()->newSpriteBatch(texture, size, usage, instanced); }
 	);
 
 	luax_pushtype(L, t);
@@ -1257,7 +1449,7 @@ int w_newCanvas(lua_State *L)
 	return 1;
 }
 
-static int w_getShaderSource(lua_State *L, int startidx, bool gles, std::string &vertexsource, std::string &pixelsource)
+static int w_getShaderSource(lua_State *L, int startidx, bool gles, std::string &vertexsource, std::string &pixelsource, std::string &instancedvertexsource)
 {
 	using namespace love::filesystem;
 
@@ -1333,21 +1525,25 @@ static int w_getShaderSource(lua_State *L, int startidx, bool gles, std::string
 		lua_pushnil(L);
 
 	// call effectCodeToGLSL, returned values will be at the top of the stack
-	if (lua_pcall(L, 3, 2, 0) != 0)
+	if (lua_pcall(L, 3, 3, 0) != 0)
 		return luaL_error(L, "%s", lua_tostring(L, -1));
 
 	// vertex shader code
-	if (lua_isstring(L, -2))
-		vertexsource = luax_checkstring(L, -2);
+	if (lua_isstring(L, -3))
+		vertexsource = luax_checkstring(L, -3);
 	else if (has_arg1 && has_arg2)
 		return luaL_error(L, "Could not parse vertex shader code (missing 'position' function?)");
 
 	// pixel shader code
-	if (lua_isstring(L, -1))
-		pixelsource = luax_checkstring(L, -1);
+	if (lua_isstring(L, -2))
+		pixelsource = luax_checkstring(L, -2);
 	else if (has_arg1 && has_arg2)
 		return luaL_error(L, "Could not parse pixel shader code (missing 'effect' function?)");
 
+	// vertex shader code for instanced SpriteBatches
+	if (lua_isstring(L, -1))
+		instancedvertexsource = luax_checkstring(L, -1);
+
 	if (vertexsource.empty() && pixelsource.empty())
 	{
 		// Original args had source code, but effectCodeToGLSL couldn't translate it
@@ -1365,13 +1561,13 @@ int w_newShader(lua_State *L)
 {
 	bool gles = instance()->getRenderer() == Graphics::RENDERER_OPENGLES;
 
-	std::string vertexsource, pixelsource;
-	w_getShaderSource(L, 1, gles, vertexsource, pixelsource);
+	std::string vertexsource, pixelsource, instancedvertexsource;
+	w_getShaderSource(L, 1, gles, vertexsource, pixelsource, instancedvertexsource);
 
 	bool should_error = false;
 	try
 	{
-		Shader *shader = instance()->newShader(vertexsource, pixelsource);
+		Shader *shader = instance()->newShader(vertexsource, pixelsource, instancedvertexsource);
 		luax_pushtype(L, shader);
 		shader->release();
 	}
@@ -1395,8 +1591,8 @@ int w_validateShader(lua_State *L)
 {
 	bool gles = luax_checkboolean(L, 1);
 
-	std::string vertexsource, pixelsource;
-	w_getShaderSource(L, 2, gles, vertexsource, pixelsource);
+	std::string vertexsource, pixelsource, instancedvertexsource;
+	w_getShaderSource(L, 2, gles, vertexsource, pixelsource, instancedvertexsource);
 
 	bool success = true;
 	std::string err;
@@ -1661,6 +1857,26 @@ int w_newText(lua_State *L)
 	return 1;
 }
 
+int w_newPath(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	Graphics::DrawMode mode = Graphics::DRAW_FILL;
+	if (!lua_isnoneornil(L, 1))
+	{
+		const char *str = luaL_checkstring(L, 1);
+		if (!Graphics::getConstant(str, mode))
+			return luax_enumerror(L, "draw mode", Graphics::getConstants(mode), str);
+	}
+
+	Path *p = nullptr;
+	luax_catchexcept(L, [&](){ p = instance()->newPath(mode); });
+
+	luax_pushtype(L, p);
+	p->release();
+	return 1;
+}
+
 int w_newVideo(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -2116,13 +2332,19 @@ int w_setDefaultShaderCode(lua_State *L)
 			lua_getfield(L, -2, "pixel");
 			lua_getfield(L, -3, "videopixel");
 			lua_getfield(L, -4, "arraypixel");
+			lua_getfield(L, -5, "instancedvertex");
+			lua_getfield(L, -6, "distancefieldpixel");
+			lua_getfield(L, -7, "skinnedvertex");
 
-			std::string vertex = luax_checkstring(L, -4);
-			std::string pixel = luax_checkstring(L, -3);
-			std::string videopixel = luax_checkstring(L, -2);
-			std::string arraypixel = luax_checkstring(L, -1);
+			std::string vertex = luax_checkstring(L, -7);
+			std::string pixel = luax_checkstring(L, -6);
+			std::string videopixel = luax_checkstring(L, -5);
+			std::string arraypixel = luax_checkstring(L, -4);
+			std::string instancedvertex = luax_checkstring(L, -3);
+			std::string distancefieldpixel = luax_checkstring(L, -2);
+			std::string skinnedvertex = luax_checkstring(L, -1);
 
-			lua_pop(L, 5);
+			lua_pop(L, 8);
 
 			Graphics::defaultShaderCode[Shader::STANDARD_DEFAULT][lang][i].source[ShaderStage::STAGE_VERTEX] = vertex;
 			Graphics::defaultShaderCode[Shader::STANDARD_DEFAULT][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
@@ -2132,6 +2354,15 @@ int w_setDefaultShaderCode(lua_State *L)
 
 			Graphics::defaultShaderCode[Shader::STANDARD_ARRAY][lang][i].source[ShaderStage::STAGE_VERTEX] = vertex;
 			Graphics::defaultShaderCode[Shader::STANDARD_ARRAY][lang][i].source[ShaderStage::STAGE_PIXEL] = arraypixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED][lang][i].source[ShaderStage::STAGE_VERTEX] = instancedvertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_INSTANCED][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_DISTANCE_FIELD][lang][i].source[ShaderStage::STAGE_VERTEX] = vertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_DISTANCE_FIELD][lang][i].source[ShaderStage::STAGE_PIXEL] = distancefieldpixel;
+
+			Graphics::defaultShaderCode[Shader::STANDARD_SKINNED][lang][i].source[ShaderStage::STAGE_VERTEX] = skinnedvertex;
+			Graphics::defaultShaderCode[Shader::STANDARD_SKINNED][lang][i].source[ShaderStage::STAGE_PIXEL] = pixel;
 		}
 	}
 
@@ -2300,7 +2531,7 @@ int w_getStats(lua_State *L)
 	if (lua_istable(L, 1))
 		lua_pushvalue(L, 1);
 	else
-		lua_createtable(L, 0, 7);
+		lua_createtable(L, 0, 14);
 
 	lua_pushinteger(L, stats.drawCalls);
 	lua_setfield(L, -2, "drawcalls");
@@ -2326,6 +2557,88 @@ int w_getStats(lua_State *L)
 	lua_pushinteger(L, stats.textureMemory);
 	lua_setfield(L, -2, "texturememory");
 
+	lua_pushinteger(L, stats.streamBufferStalls);
+	lua_setfield(L, -2, "streambufferstalls");
+
+	lua_pushinteger(L, stats.textLayoutCacheHits);
+	lua_setfield(L, -2, "textlayoutcachehits");
+
+	lua_pushinteger(L, stats.textLayoutCacheMisses);
+	lua_setfield(L, -2, "textlayoutcachemisses");
+
+	lua_pushinteger(L, stats.shaderCacheHits);
+	lua_setfield(L, -2, "shadercachehits");
+
+	lua_pushinteger(L, stats.shaderCacheMisses);
+	lua_setfield(L, -2, "shadercachemisses");
+
+	return 1;
+}
+
+int w_beginScope(lua_State *L)
+{
+	std::string name = luax_checkstring(L, 1);
+	luax_catchexcept(L, [&](){ instance()->beginScope(name); });
+	return 0;
+}
+
+int w_endScope(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->endScope(); });
+	return 0;
+}
+
+int w_getProfile(lua_State *L)
+{
+	const Graphics::Profile &profile = instance()->getProfile();
+
+	lua_createtable(L, 0, 2);
+
+	lua_createtable(L, (int) profile.scopes.size(), 0);
+
+	for (size_t i = 0; i < profile.scopes.size(); i++)
+	{
+		const Graphics::ProfileScope &scope = profile.scopes[i];
+
+		lua_createtable(L, 0, 5);
+
+		luax_pushstring(L, scope.name);
+		lua_setfield(L, -2, "name");
+
+		lua_pushinteger(L, scope.depth + 1);
+		lua_setfield(L, -2, "depth");
+
+		lua_pushinteger(L, scope.drawCalls);
+		lua_setfield(L, -2, "drawcalls");
+
+		lua_pushnumber(L, scope.cpuTime);
+		lua_setfield(L, -2, "cputime");
+
+		if (scope.gpuTime >= 0.0)
+		{
+			lua_pushnumber(L, scope.gpuTime);
+			lua_setfield(L, -2, "gputime");
+		}
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	lua_setfield(L, -2, "scopes");
+
+	lua_createtable(L, 0, (int) Graphics::BATCHBREAK_MAX_ENUM);
+
+	for (int i = 0; i < (int) Graphics::BATCHBREAK_MAX_ENUM; i++)
+	{
+		const char *name = nullptr;
+		if (!Graphics::getConstant((Graphics::BatchBreakReason) i, name))
+			continue;
+
+		lua_pushinteger(L, profile.batchBreaks[i]);
+		lua_setfield(L, -2, name);
+	}
+
+	lua_setfield(L, -2, "batchbreaks");
+
 	return 1;
 }
 
@@ -2801,6 +3114,40 @@ int w_flushBatch(lua_State *)
 	return 0;
 }
 
+int w_setBatchMode(lua_State *L)
+{
+	Graphics::BatchMode mode;
+	const char *str = luaL_checkstring(L, 1);
+	if (!Graphics::getConstant(str, mode))
+		return luax_enumerror(L, "batch mode", Graphics::getConstants(mode), str);
+
+	luax_catchexcept(L, [&](){ instance()->setBatchMode(mode); });
+	return 0;
+}
+
+int w_getBatchMode(lua_State *L)
+{
+	Graphics::BatchMode mode = instance()->getBatchMode();
+	const char *str;
+	if (!Graphics::getConstant(mode, str))
+		return luaL_error(L, "Unknown batch mode");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_setAutoBatching(lua_State *L)
+{
+	bool enable = luax_checkboolean(L, 1);
+	luax_catchexcept(L, [&](){ instance()->setAutoBatching(enable); });
+	return 0;
+}
+
+int w_isAutoBatching(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isAutoBatching());
+	return 1;
+}
+
 int w_getStackDepth(lua_State *L)
 {
 	lua_pushnumber(L, instance()->getStackDepth());
@@ -2914,6 +3261,7 @@ static const luaL_Reg functions[] =
 	{ "present", w_present },
 
 	{ "newImage", w_newImage },
+	{ "newImageAsync", w_newImageAsync },
 	{ "newArrayImage", w_newArrayImage },
 	{ "newVolumeImage", w_newVolumeImage },
 	{ "newCubeImage", w_newCubeImage },
@@ -2926,6 +3274,7 @@ static const luaL_Reg functions[] =
 	{ "newShader", w_newShader },
 	{ "newMesh", w_newMesh },
 	{ "newText", w_newText },
+	{ "newPath", w_newPath },
 	{ "_newVideo", w_newVideo },
 
 	{ "validateShader", w_validateShader },
@@ -2978,6 +3327,12 @@ static const luaL_Reg functions[] =
 	{ "getSystemLimits", w_getSystemLimits },
 	{ "getTextureTypes", w_getTextureTypes },
 	{ "getStats", w_getStats },
+	{ "beginScope", w_beginScope },
+	{ "endScope", w_endScope },
+	{ "getProfile", w_getProfile },
+	{ "setAsyncImageBudget", w_setAsyncImageBudget },
+	{ "getAsyncImageBudget", w_getAsyncImageBudget },
+	{ "getAsyncImageCount", w_getAsyncImageCount },
 
 	{ "captureScreenshot", w_captureScreenshot },
 
@@ -3016,6 +3371,10 @@ static const luaL_Reg functions[] =
 	{ "polygon", w_polygon },
 
 	{ "flushBatch", w_flushBatch },
+	{ "setBatchMode", w_setBatchMode },
+	{ "getBatchMode", w_getBatchMode },
+	{ "setAutoBatching", w_setAutoBatching },
+	{ "isAutoBatching", w_isAutoBatching },
 
 	{ "getStackDepth", w_getStackDepth },
 	{ "push", w_push },
@@ -3052,6 +3411,7 @@ static const lua_CFunction types[] =
 	luaopen_shader,
 	luaopen_mesh,
 	luaopen_text,
+	luaopen_path,
 	luaopen_video,
 	0
 };
@@ -31,6 +31,7 @@
 #include "wrap_Shader.h"
 #include "wrap_Mesh.h"
 #include "wrap_Text.h"
+#include "wrap_Path.h"
 #include "wrap_Video.h"
 #include "Graphics.h"
 
@@ -39,6 +40,12 @@ namespace love
 namespace graphics
 {
 
+/**
+ * Gets the callback for a screenshot or Canvas readback from a function, a
+ * filename to save the image to, or a Channel to push the ImageData to.
+ **/
+void luax_checkscreenshotinfo(lua_State *L, int idx, Graphics::ScreenshotInfo &info);
+
 extern "C" LOVE_EXPORT int luaopen_love_graphics(lua_State *L);
 
 } // graphics
@@ -230,8 +230,72 @@ void main() {
 	setPointSize();
 	love_Position = position(ClipSpaceFromLocal, VertexPosition);
 }]],
+
+	-- Used by instanced SpriteBatches. VertexPosition is a corner of the unit
+	-- square, which is expanded by the per-instance affine transform (with the
+	-- quad's size already folded in) and texture coordinate rectangle.
+	MAIN_INSTANCED = [[
+attribute vec4 VertexPosition;
+attribute vec4 VertexColor;
+attribute vec4 ConstantColor;
+attribute vec3 InstanceTransform0;
+attribute vec3 InstanceTransform1;
+attribute vec4 InstanceTexRect;
+
+varying vec4 VaryingTexCoord;
+varying vec4 VaryingColor;
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition);
+
+void main() {
+	vec3 corner = vec3(VertexPosition.xy, 1.0);
+	vec4 localPosition = vec4(dot(InstanceTransform0, corner), dot(InstanceTransform1, corner), 0.0, 1.0);
+	VaryingTexCoord = vec4(InstanceTexRect.xy + VertexPosition.xy * InstanceTexRect.zw, 0.0, 0.0);
+	VaryingColor = gammaCorrectColor(VertexColor) * ConstantColor;
+	setPointSize();
+	love_Position = position(ClipSpaceFromLocal, localPosition);
+}]],
+
+	-- Used by Meshes with bone transforms. Each bone in the palette is a 2D
+	-- affine transform stored as two rows, and each vertex blends up to four
+	-- bones. Keep love_MaxBones in sync with Mesh::MAX_BONES.
+	MAIN_SKINNED = [[
+#define love_MaxBones 48
+
+attribute vec4 VertexPosition;
+attribute vec4 VertexTexCoord;
+attribute vec4 VertexColor;
+attribute vec4 ConstantColor;
+attribute vec4 VertexBoneIndices;
+attribute vec4 VertexBoneWeights;
+
+uniform vec4 love_BonePalette[love_MaxBones * 2];
+
+varying vec4 VaryingTexCoord;
+varying vec4 VaryingColor;
+
+vec4 position(mat4 clipSpaceFromLocal, vec4 localPosition);
+
+void main() {
+	vec4 localPosition = VertexPosition;
+	vec3 p = vec3(VertexPosition.xy, 1.0);
+	vec2 skinned = vec2(0.0);
+	for (int i = 0; i < 4; i++) {
+		int bone = int(VertexBoneIndices[i]) * 2;
+		skinned += VertexBoneWeights[i] * vec2(dot(love_BonePalette[bone].xyz, p), dot(love_BonePalette[bone + 1].xyz, p));
+	}
+	localPosition.xy = skinned;
+	VaryingTexCoord = VertexTexCoord;
+	VaryingColor = gammaCorrectColor(VertexColor) * ConstantColor;
+	setPointSize();
+	love_Position = position(ClipSpaceFromLocal, localPosition);
+}]],
 }
 
+-- Split the file into two C++ raw string literals, since VS2013 has a 16KB
+-- limit for each one. DO NOT REMOVE THE NEXT LINE.
+--)luastring"--" R"luastring"--(
+
 GLSL.PIXEL = {
 	HEADER = [[
 #ifdef GL_ES
@@ -310,8 +374,14 @@ local function getLanguageTarget(code)
 	return (code:match("^%s*#pragma language (%w+)")) or "glsl1"
 end
 
-local function createShaderStageCode(stage, code, lang, gles, glsl1on3, gammacorrect, custom, multicanvas)
+local function createShaderStageCode(stage, code, lang, gles, glsl1on3, gammacorrect, custom, multicanvas, variant)
 	stage = stage:upper()
+	local main = GLSL[stage].MAIN
+	if variant then
+		main = GLSL[stage]["MAIN_" .. variant]
+	elseif custom then
+		main = GLSL[stage].MAIN_CUSTOM
+	end
 	local lines = {
 		GLSL.VERSION[lang][gles],
 		"#define " ..stage .. " " .. stage,
@@ -323,7 +393,7 @@ local function createShaderStageCode(stage, code, lang, gles, glsl1on3, gammacor
 		GLSL.UNIFORMS,
 		GLSL.FUNCTIONS,
 		GLSL[stage].FUNCTIONS,
-		custom and GLSL[stage].MAIN_CUSTOM or GLSL[stage].MAIN,
+		main,
 		((lang == "glsl1" or glsl1on3) and not gles) and "#line 0" or "#line 1",
 		code,
 	}
@@ -374,7 +444,8 @@ function love.graphics._shaderCodeToGLSL(gles, arg1, arg2)
 		end
 	end
 
-	local supportsGLSL3 = love.graphics.getSupported().glsl3
+	local supported = love.graphics.getSupported()
+	local supportsGLSL3 = supported.glsl3
 	local gammacorrect = love.graphics.isGammaCorrect()
 
 	local targetlang = getLanguageTarget(pixelcode or vertexcode)
@@ -397,6 +468,13 @@ function love.graphics._shaderCodeToGLSL(gles, arg1, arg2)
 		glsl1on3 = true
 	end
 
+	-- The same vertex code with the main function of instanced SpriteBatches.
+	-- It's only compiled if the shader is used to draw one.
+	local instancedvertexcode
+	if vertexcode and supported.instancing then
+		instancedvertexcode = createShaderStageCode("VERTEX", vertexcode, lang, gles, glsl1on3, gammacorrect, false, false, "INSTANCED")
+	end
+
 	if vertexcode then
 		vertexcode = createShaderStageCode("VERTEX", vertexcode, lang, gles, glsl1on3, gammacorrect)
 	end
@@ -404,7 +482,7 @@ function love.graphics._shaderCodeToGLSL(gles, arg1, arg2)
 		pixelcode = createShaderStageCode("PIXEL", pixelcode, lang, gles, glsl1on3, gammacorrect, is_custompixel, is_multicanvas)
 	end
 
-	return vertexcode, pixelcode
+	return vertexcode, pixelcode, instancedvertexcode
 end
 
 function love.graphics._transformGLSLErrorMessages(message)
@@ -459,6 +537,14 @@ void effect() {
 uniform ArrayImage MainTex;
 void effect() {
 	love_PixelColor = Texel(MainTex, VaryingTexCoord.xyz) * VaryingColor;
+}]],
+	distancefieldpixel = [[
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord) {
+	// The glyph's alpha is a signed distance field with the outline at 0.5.
+	float dist = Texel(tex, texcoord).a;
+	float width = fwidth(dist) * 0.7;
+	float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+	return vec4(vcolor.rgb, vcolor.a * alpha);
 }]],
 }
 
@@ -480,6 +566,9 @@ for lang, info in pairs(langs) do
 			pixel = createShaderStageCode("PIXEL", defaultcode.pixel, info.target, info.gles, false, gammacorrect, false),
 			videopixel = createShaderStageCode("PIXEL", defaultcode.videopixel, info.target, info.gles, false, gammacorrect, true),
 			arraypixel = createShaderStageCode("PIXEL", defaultcode.arraypixel, info.target, info.gles, false, gammacorrect, true),
+			instancedvertex = createShaderStageCode("VERTEX", defaultcode.vertex, info.target, info.gles, false, gammacorrect, false, false, "INSTANCED"),
+			skinnedvertex = createShaderStageCode("VERTEX", defaultcode.vertex, info.target, info.gles, false, gammacorrect, false, false, "SKINNED"),
+			distancefieldpixel = createShaderStageCode("PIXEL", defaultcode.distancefieldpixel, info.target, info.gles, false, gammacorrect, false),
 		}
 	end
 end
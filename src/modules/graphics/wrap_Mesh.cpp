@@ -23,6 +23,7 @@
 #include "Image.h"
 #include "Canvas.h"
 #include "wrap_Texture.h"
+#include "math/Transform.h"
 
 // C++
 #include <algorithm>
@@ -575,6 +576,42 @@ int w_Mesh_getDrawRange(lua_State *L)
 	return 2;
 }
 
+int w_Mesh_setBoneTransforms(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+
+	if (lua_isnoneornil(L, 2))
+	{
+		t->setBoneTransforms();
+		return 0;
+	}
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+	int count = (int) luax_objlen(L, 2);
+
+	if (count > Mesh::MAX_BONES)
+		return luaL_error(L, "Too many bone transforms: %d (max %d).", count, Mesh::MAX_BONES);
+
+	Matrix4 transforms[Mesh::MAX_BONES];
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+		transforms[i] = luax_checktype<math::Transform>(L, -1)->getMatrix();
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ t->setBoneTransforms(transforms, count); });
+	return 0;
+}
+
+int w_Mesh_getBoneCount(lua_State *L)
+{
+	Mesh *t = luax_checkmesh(L, 1);
+	lua_pushinteger(L, t->getBoneCount());
+	return 1;
+}
+
 static const luaL_Reg w_Mesh_functions[] =
 {
 	{ "setVertices", w_Mesh_setVertices },
@@ -597,6 +634,8 @@ static const luaL_Reg w_Mesh_functions[] =
 	{ "getDrawMode", w_Mesh_getDrawMode },
 	{ "setDrawRange", w_Mesh_setDrawRange },
 	{ "getDrawRange", w_Mesh_getDrawRange },
+	{ "setBoneTransforms", w_Mesh_setBoneTransforms },
+	{ "getBoneCount", w_Mesh_getBoneCount },
 	{ 0, 0 }
 };
 
@@ -100,7 +100,7 @@ int w_ParticleSystem_setInsertMode(lua_State *L)
 	const char *str = luaL_checkstring(L, 2);
 	if (!ParticleSystem::getConstant(str, mode))
 		return luax_enumerror(L, "insert mode", ParticleSystem::getConstants(mode), str);
-	t->setInsertMode(mode);
+	luax_catchexcept(L, [&](){ t->setInsertMode(mode); });
 	return 0;
 }
 
@@ -116,6 +116,28 @@ int w_ParticleSystem_getInsertMode(lua_State *L)
 	return 1;
 }
 
+int w_ParticleSystem_setSimulationMode(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	ParticleSystem::SimulationMode mode;
+	const char *str = luaL_checkstring(L, 2);
+	if (!ParticleSystem::getConstant(str, mode))
+		return luax_enumerror(L, "simulation mode", ParticleSystem::getConstants(mode), str);
+	luax_catchexcept(L, [&](){ t->setSimulationMode(mode); });
+	return 0;
+}
+
+int w_ParticleSystem_getSimulationMode(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	ParticleSystem::SimulationMode mode = t->getSimulationMode();
+	const char *str;
+	if (!ParticleSystem::getConstant(mode, str))
+		return luaL_error(L, "Unknown simulation mode");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_ParticleSystem_setEmissionRate(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -768,6 +790,8 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "getBufferSize", w_ParticleSystem_getBufferSize },
 	{ "setInsertMode", w_ParticleSystem_setInsertMode },
 	{ "getInsertMode", w_ParticleSystem_getInsertMode },
+	{ "setSimulationMode", w_ParticleSystem_setSimulationMode },
+	{ "getSimulationMode", w_ParticleSystem_getSimulationMode },
 	{ "setEmissionRate", w_ParticleSystem_setEmissionRate },
 	{ "getEmissionRate", w_ParticleSystem_getEmissionRate },
 	{ "setEmitterLifetime", w_ParticleSystem_setEmitterLifetime },
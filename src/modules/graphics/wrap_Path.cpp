@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_Path.h"
+
+namespace love
+{
+namespace graphics
+{
+
+Path *luax_checkpath(lua_State *L, int idx)
+{
+	return luax_checktype<Path>(L, idx);
+}
+
+int w_Path_moveTo(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	p->moveTo(x, y);
+	return 0;
+}
+
+int w_Path_lineTo(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	p->lineTo(x, y);
+	return 0;
+}
+
+int w_Path_bezierTo(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+
+	float coords[6];
+	int count = lua_isnoneornil(L, 6) ? 4 : 6;
+
+	for (int i = 0; i < count; i++)
+		coords[i] = (float) luaL_checknumber(L, i + 2);
+
+	if (count == 4)
+		p->bezierTo(coords[0], coords[1], coords[2], coords[3]);
+	else
+		p->bezierTo(coords[0], coords[1], coords[2], coords[3], coords[4], coords[5]);
+
+	return 0;
+}
+
+int w_Path_arc(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+	float x = (float) luaL_checknumber(L, 2);
+	float y = (float) luaL_checknumber(L, 3);
+	float radius = (float) luaL_checknumber(L, 4);
+	float angle1 = (float) luaL_checknumber(L, 5);
+	float angle2 = (float) luaL_checknumber(L, 6);
+
+	if (lua_isnoneornil(L, 7))
+		p->arc(x, y, radius, angle1, angle2);
+	else
+	{
+		int points = (int) luaL_checkinteger(L, 7);
+		p->arc(x, y, radius, angle1, angle2, points);
+	}
+
+	return 0;
+}
+
+int w_Path_close(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+	p->close();
+	return 0;
+}
+
+int w_Path_clear(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+	p->clear();
+	return 0;
+}
+
+int w_Path_setDrawMode(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+
+	Graphics::DrawMode mode;
+	const char *str = luaL_checkstring(L, 2);
+	if (!Graphics::getConstant(str, mode))
+		return luax_enumerror(L, "draw mode", Graphics::getConstants(mode), str);
+
+	p->setDrawMode(mode);
+	return 0;
+}
+
+int w_Path_getDrawMode(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+	const char *str;
+	if (!Graphics::getConstant(p->getDrawMode(), str))
+		return luaL_error(L, "Unknown draw mode");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_Path_setFillRule(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+
+	Path::FillRule rule;
+	const char *str = luaL_checkstring(L, 2);
+	if (!Path::getConstant(str, rule))
+		return luax_enumerror(L, "fill rule", Path::getConstants(rule), str);
+
+	p->setFillRule(rule);
+	return 0;
+}
+
+int w_Path_getFillRule(lua_State *L)
+{
+	Path *p = luax_checkpath(L, 1);
+	const char *str;
+	if (!Path::getConstant(p->getFillRule(), str))
+		return luaL_error(L, "Unknown fill rule");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+static const luaL_Reg w_Path_functions[] =
+{
+	{ "moveTo", w_Path_moveTo },
+	{ "lineTo", w_Path_lineTo },
+	{ "bezierTo", w_Path_bezierTo },
+	{ "arc", w_Path_arc },
+	{ "close", w_Path_close },
+	{ "clear", w_Path_clear },
+	{ "setDrawMode", w_Path_setDrawMode },
+	{ "getDrawMode", w_Path_getDrawMode },
+	{ "setFillRule", w_Path_setFillRule },
+	{ "getFillRule", w_Path_getFillRule },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_path(lua_State *L)
+{
+	return luax_register_type(L, &Path::type, w_Path_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -108,6 +108,48 @@ int w_SpriteBatch_set(lua_State *L)
 	return 0;
 }
 
+static int w_SpriteBatch_addMany_or_setMany(lua_State *L, SpriteBatch *t, int startidx, int index)
+{
+	Data *data = luax_checktype<Data>(L, startidx);
+
+	Quad *quad = nullptr;
+	if (!lua_isnoneornil(L, startidx + 1))
+		quad = luax_checktype<Quad>(L, startidx + 1);
+	else
+		quad = t->getTexture()->getQuad();
+
+	const size_t spritesize = sizeof(float) * SpriteBatch::PACKED_TRANSFORM_COMPONENTS;
+
+	if (data->getSize() == 0 || data->getSize() % spritesize != 0)
+		return luaL_error(L, "Data size must be a multiple of %d bytes (%d floats per sprite).", (int) spritesize, SpriteBatch::PACKED_TRANSFORM_COMPONENTS);
+
+	int count = (int) (data->getSize() / spritesize);
+
+	luax_catchexcept(L, [&]() { index = t->addMany(quad, (const float *) data->getData(), count, index); });
+
+	return index;
+}
+
+int w_SpriteBatch_addMany(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+
+	int index = w_SpriteBatch_addMany_or_setMany(L, t, 2, -1);
+	lua_pushinteger(L, index + 1);
+
+	return 1;
+}
+
+int w_SpriteBatch_setMany(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	w_SpriteBatch_addMany_or_setMany(L, t, 3, index);
+
+	return 0;
+}
+
 int w_SpriteBatch_addLayer(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -233,6 +275,13 @@ int w_SpriteBatch_getBufferSize(lua_State *L)
 	return 1;
 }
 
+int w_SpriteBatch_isInstanced(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isInstanced());
+	return 1;
+}
+
 int w_SpriteBatch_attachAttribute(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -277,6 +326,8 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 {
 	{ "add", w_SpriteBatch_add },
 	{ "set", w_SpriteBatch_set },
+	{ "addMany", w_SpriteBatch_addMany },
+	{ "setMany", w_SpriteBatch_setMany },
 	{ "addLayer", w_SpriteBatch_addLayer },
 	{ "setLayer", w_SpriteBatch_setLayer },
 	{ "clear", w_SpriteBatch_clear },
@@ -287,6 +338,7 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 	{ "getColor", w_SpriteBatch_getColor },
 	{ "getCount", w_SpriteBatch_getCount },
 	{ "getBufferSize", w_SpriteBatch_getBufferSize },
+	{ "isInstanced", w_SpriteBatch_isInstanced },
 	{ "attachAttribute", w_SpriteBatch_attachAttribute },
 	{ "setDrawRange", w_SpriteBatch_setDrawRange },
 	{ "getDrawRange", w_SpriteBatch_getDrawRange },
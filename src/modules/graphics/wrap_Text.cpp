@@ -138,6 +138,86 @@ int w_Text_addf(lua_State *L)
 	return 1;
 }
 
+int w_Text_setAt(lua_State *L)
+{
+	Text *t = luax_checktext(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	std::vector<Font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	if (luax_istype(L, 4, math::Transform::type))
+	{
+		math::Transform *tf = luax_totype<math::Transform>(L, 4);
+		luax_catchexcept(L, [&](){ t->setAt(index, text, tf->getMatrix()); });
+	}
+	else
+	{
+		float x  = (float) luaL_optnumber(L, 4, 0.0);
+		float y  = (float) luaL_optnumber(L, 5, 0.0);
+		float a  = (float) luaL_optnumber(L, 6, 0.0);
+		float sx = (float) luaL_optnumber(L, 7, 1.0);
+		float sy = (float) luaL_optnumber(L, 8, sx);
+		float ox = (float) luaL_optnumber(L, 9, 0.0);
+		float oy = (float) luaL_optnumber(L, 10, 0.0);
+		float kx = (float) luaL_optnumber(L, 11, 0.0);
+		float ky = (float) luaL_optnumber(L, 12, 0.0);
+
+		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
+		luax_catchexcept(L, [&](){ t->setAt(index, text, m); });
+	}
+
+	return 0;
+}
+
+int w_Text_setfAt(lua_State *L)
+{
+	Text *t = luax_checktext(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	std::vector<Font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	float wrap = (float) luaL_checknumber(L, 4);
+
+	Font::AlignMode align = Font::ALIGN_MAX_ENUM;
+	const char *alignstr = luaL_checkstring(L, 5);
+
+	if (!Font::getConstant(alignstr, align))
+		return luax_enumerror(L, "align mode", Font::getConstants(align), alignstr);
+
+	if (luax_istype(L, 6, math::Transform::type))
+	{
+		math::Transform *tf = luax_totype<math::Transform>(L, 6);
+		luax_catchexcept(L, [&](){ t->setfAt(index, text, wrap, align, tf->getMatrix()); });
+	}
+	else
+	{
+		float x  = (float) luaL_optnumber(L, 6, 0.0);
+		float y  = (float) luaL_optnumber(L, 7, 0.0);
+		float a  = (float) luaL_optnumber(L, 8, 0.0);
+		float sx = (float) luaL_optnumber(L, 9, 1.0);
+		float sy = (float) luaL_optnumber(L, 10, sx);
+		float ox = (float) luaL_optnumber(L, 11, 0.0);
+		float oy = (float) luaL_optnumber(L, 12, 0.0);
+		float kx = (float) luaL_optnumber(L, 13, 0.0);
+		float ky = (float) luaL_optnumber(L, 14, 0.0);
+
+		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
+		luax_catchexcept(L, [&](){ t->setfAt(index, text, wrap, align, m); });
+	}
+
+	return 0;
+}
+
+int w_Text_remove(lua_State *L)
+{
+	Text *t = luax_checktext(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&](){ t->remove(index); });
+	return 0;
+}
+
 int w_Text_clear(lua_State *L)
 {
 	Text *t = luax_checktext(L, 1);
@@ -192,6 +272,9 @@ static const luaL_Reg w_Text_functions[] =
 	{ "setf", w_Text_setf },
 	{ "add", w_Text_add },
 	{ "addf", w_Text_addf },
+	{ "setAt", w_Text_setAt },
+	{ "setfAt", w_Text_setfAt },
+	{ "remove", w_Text_remove },
 	{ "clear", w_Text_clear },
 	{ "setFont", w_Text_setFont },
 	{ "getFont", w_Text_getFont },
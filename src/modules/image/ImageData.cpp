@@ -21,6 +21,20 @@
 #include "ImageData.h"
 #include "Image.h"
 #include "filesystem/Filesystem.h"
+#include "math/MathModule.h"
+#include "common/math.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 using love::thread::Lock;
 
@@ -241,6 +255,321 @@ love::filesystem::FileData *ImageData::encode(FormatHandler::EncodedFormat encod
 	return filedata;
 }
 
+// Weights for downsampling by 2. Destination pixel i uses source pixels
+// 2*i + first onward.
+struct MipmapKernel
+{
+	int first;
+	std::vector<float> weights;
+};
+
+static float besselI0(float x)
+{
+	float sum = 1.0f;
+	float term = 1.0f;
+
+	for (int i = 1; i < 32; i++)
+	{
+		float t = x / (2.0f * i);
+		term *= t * t;
+		sum += term;
+
+		if (term < sum * 1e-7f)
+			break;
+	}
+
+	return sum;
+}
+
+static float sinc(float x)
+{
+	if (fabsf(x) < 1e-6f)
+		return 1.0f;
+
+	x *= (float) LOVE_M_PI;
+	return sinf(x) / x;
+}
+
+static MipmapKernel getMipmapKernel(ImageData::MipmapFilter filter)
+{
+	MipmapKernel kernel;
+
+	if (filter == ImageData::MIPMAP_FILTER_KAISER)
+	{
+		// A Kaiser-windowed sinc with a radius of 3 destination pixels. It
+		// keeps more detail than a box filter, at the cost of slight ringing.
+		const float width = 3.0f;
+		const float alpha = 4.0f;
+
+		kernel.first = -5;
+
+		float sum = 0.0f;
+		for (int i = kernel.first; i <= 6; i++)
+		{
+			// Distance from the destination pixel's center, in destination
+			// pixels.
+			float x = (i - 0.5f) * 0.5f;
+			float t = x / width;
+			float w = sinc(x) * besselI0(alpha * sqrtf(1.0f - t * t)) / besselI0(alpha);
+
+			kernel.weights.push_back(w);
+			sum += w;
+		}
+
+		for (float &w : kernel.weights)
+			w /= sum;
+	}
+	else
+	{
+		kernel.first = 0;
+		kernel.weights = {0.5f, 0.5f};
+	}
+
+	return kernel;
+}
+
+// Gets the source pixel offsets of each tap for every destination pixel along
+// one axis. Taps outside the source are clamped to its edge.
+static void getMipmapTapOffsets(const MipmapKernel &kernel, int srcsize, int dstsize, size_t stride, std::vector<size_t> &offsets)
+{
+	int taps = (int) kernel.weights.size();
+	offsets.resize(dstsize * taps);
+
+	for (int d = 0; d < dstsize; d++)
+	{
+		for (int i = 0; i < taps; i++)
+		{
+			int s = std::min(std::max(2 * d + kernel.first + i, 0), srcsize - 1);
+			offsets[d * taps + i] = s * stride;
+		}
+	}
+}
+
+// Writes the weighted sum of RGBA float pixels to dst.
+static inline void filterMipmapPixel(const float *src, const size_t *offsets, const float *weights, int taps, float *dst)
+{
+#if defined(LOVE_SIMD_SSE)
+
+	__m128 sum = _mm_setzero_ps();
+
+	for (int i = 0; i < taps; i++)
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + offsets[i]), _mm_set1_ps(weights[i])));
+
+	_mm_storeu_ps(dst, sum);
+
+#elif defined(LOVE_SIMD_NEON)
+
+	float32x4_t sum = vdupq_n_f32(0.0f);
+
+	for (int i = 0; i < taps; i++)
+		sum = vmlaq_n_f32(sum, vld1q_f32(src + offsets[i]), weights[i]);
+
+	vst1q_f32(dst, sum);
+
+#else
+
+	float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+	for (int i = 0; i < taps; i++)
+	{
+		const float *p = src + offsets[i];
+		for (int c = 0; c < 4; c++)
+			sum[c] += p[c] * weights[i];
+	}
+
+	for (int c = 0; c < 4; c++)
+		dst[c] = sum[c];
+
+#endif
+}
+
+struct SRGBToLinearTable
+{
+	float values[256];
+
+	SRGBToLinearTable()
+	{
+		for (int i = 0; i < 256; i++)
+			values[i] = love::math::gammaToLinear(i / 255.0f);
+	}
+};
+
+static const float *getSRGBToLinearTable()
+{
+	// Mipmaps can be generated from multiple threads at once, so this relies
+	// on static initialization being thread-safe.
+	static SRGBToLinearTable table;
+	return table.values;
+}
+
+static void readMipmapRow(const uint8 *src, PixelFormat format, int w, bool srgb, float *dst)
+{
+	if (format == PIXELFORMAT_RGBA8)
+	{
+		const float *table = getSRGBToLinearTable();
+
+		for (int i = 0; i < w * 4; i++)
+		{
+			if (srgb && (i % 4) != 3)
+				dst[i] = table[src[i]];
+			else
+				dst[i] = src[i] / 255.0f;
+		}
+	}
+	else if (format == PIXELFORMAT_RGBA16)
+	{
+		const uint16 *s = (const uint16 *) src;
+
+		for (int i = 0; i < w * 4; i++)
+		{
+			dst[i] = s[i] / 65535.0f;
+			if (srgb && (i % 4) != 3)
+				dst[i] = love::math::gammaToLinear(dst[i]);
+		}
+	}
+	else if (format == PIXELFORMAT_RGBA16F)
+	{
+		const half *s = (const half *) src;
+
+		for (int i = 0; i < w * 4; i++)
+			dst[i] = halfToFloat(s[i]);
+	}
+	else if (format == PIXELFORMAT_RGBA32F)
+		memcpy(dst, src, w * 4 * sizeof(float));
+}
+
+static void writeMipmapRow(const float *src, PixelFormat format, int w, bool srgb, uint8 *dst)
+{
+	if (format == PIXELFORMAT_RGBA8)
+	{
+		for (int i = 0; i < w * 4; i++)
+		{
+			float v = std::min(std::max(src[i], 0.0f), 1.0f);
+			if (srgb && (i % 4) != 3)
+				v = love::math::linearToGamma(v);
+
+			dst[i] = (uint8) (v * 255.0f + 0.5f);
+		}
+	}
+	else if (format == PIXELFORMAT_RGBA16)
+	{
+		uint16 *d = (uint16 *) dst;
+
+		for (int i = 0; i < w * 4; i++)
+		{
+			float v = std::min(std::max(src[i], 0.0f), 1.0f);
+			if (srgb && (i % 4) != 3)
+				v = love::math::linearToGamma(v);
+
+			d[i] = (uint16) (v * 65535.0f + 0.5f);
+		}
+	}
+	else if (format == PIXELFORMAT_RGBA16F)
+	{
+		half *d = (half *) dst;
+
+		for (int i = 0; i < w * 4; i++)
+			d[i] = floatToHalf(src[i]);
+	}
+	else if (format == PIXELFORMAT_RGBA32F)
+		memcpy(dst, src, w * 4 * sizeof(float));
+}
+
+std::vector<StrongRef<ImageData>> ImageData::generateMipmaps(MipmapFilter filter, bool linear) const
+{
+	MipmapKernel kernel = getMipmapKernel(filter);
+	int taps = (int) kernel.weights.size();
+
+	bool srgb = !linear && (format == PIXELFORMAT_RGBA8 || format == PIXELFORMAT_RGBA16);
+	size_t pixelsize = getPixelSize();
+
+	std::vector<StrongRef<ImageData>> mipmaps;
+
+	// The previous level in linear RGBA floats. The first level is read
+	// straight from this ImageData a row at a time instead, so a float copy of
+	// the whole thing is never needed.
+	std::vector<float> src;
+	std::vector<float> dst;
+	std::vector<float> row(width * 4);
+
+	// Horizontally filtered source rows. Each destination row uses a window
+	// of consecutive source rows, so a ring buffer with one slot per tap
+	// filters each source row only once.
+	std::vector<float> hrows;
+	std::vector<int> hrowsource;
+
+	std::vector<size_t> hoffsets;
+	std::vector<size_t> voffsets;
+	std::vector<size_t> rowoffsets(taps);
+
+	int sw = width;
+	int sh = height;
+
+	Lock lock(mutex);
+
+	while (sw > 1 || sh > 1)
+	{
+		int dw = std::max(sw / 2, 1);
+		int dh = std::max(sh / 2, 1);
+
+		getMipmapTapOffsets(kernel, sw, dw, 4, hoffsets);
+		getMipmapTapOffsets(kernel, sh, dh, 1, voffsets);
+
+		dst.resize(dw * dh * 4);
+		hrows.resize(taps * dw * 4);
+		hrowsource.assign(taps, -1);
+
+		for (int dy = 0; dy < dh; dy++)
+		{
+			for (int i = 0; i < taps; i++)
+			{
+				int sy = (int) voffsets[dy * taps + i];
+				int slot = sy % taps;
+
+				if (hrowsource[slot] != sy)
+				{
+					const float *srcrow = nullptr;
+
+					if (mipmaps.empty())
+					{
+						readMipmapRow(data + sy * width * pixelsize, format, width, srgb, row.data());
+						srcrow = row.data();
+					}
+					else
+						srcrow = src.data() + sy * sw * 4;
+
+					float *hrow = hrows.data() + slot * dw * 4;
+
+					for (int dx = 0; dx < dw; dx++)
+						filterMipmapPixel(srcrow, &hoffsets[dx * taps], kernel.weights.data(), taps, hrow + dx * 4);
+
+					hrowsource[slot] = sy;
+				}
+
+				rowoffsets[i] = slot * dw * 4;
+			}
+
+			float *dstrow = dst.data() + dy * dw * 4;
+
+			for (int dx = 0; dx < dw; dx++)
+				filterMipmapPixel(hrows.data() + dx * 4, rowoffsets.data(), kernel.weights.data(), taps, dstrow + dx * 4);
+		}
+
+		StrongRef<ImageData> mipmap(new ImageData(dw, dh, format), Acquire::NORETAIN);
+
+		for (int y = 0; y < dh; y++)
+			writeMipmapRow(dst.data() + y * dw * 4, format, dw, srgb, mipmap->data + y * dw * pixelsize);
+
+		mipmaps.push_back(mipmap);
+
+		std::swap(src, dst);
+		sw = dw;
+		sh = dh;
+	}
+
+	return mipmaps;
+}
+
 size_t ImageData::getSize() const
 {
 	return size_t(getWidth() * getHeight()) * getPixelSize();
@@ -507,6 +836,21 @@ std::vector<std::string> ImageData::getConstants(FormatHandler::EncodedFormat)
 	return encodedFormats.getNames();
 }
 
+bool ImageData::getConstant(const char *in, MipmapFilter &out)
+{
+	return mipmapFilters.find(in, out);
+}
+
+bool ImageData::getConstant(MipmapFilter in, const char *&out)
+{
+	return mipmapFilters.find(in, out);
+}
+
+std::vector<std::string> ImageData::getConstants(MipmapFilter)
+{
+	return mipmapFilters.getNames();
+}
+
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry ImageData::encodedFormatEntries[] =
 {
 	{"tga", FormatHandler::ENCODED_TGA},
@@ -515,5 +859,13 @@ StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry
 
 StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> ImageData::encodedFormats(ImageData::encodedFormatEntries, sizeof(ImageData::encodedFormatEntries));
 
+StringMap<ImageData::MipmapFilter, ImageData::MIPMAP_FILTER_MAX_ENUM>::Entry ImageData::mipmapFilterEntries[] =
+{
+	{"box", MIPMAP_FILTER_BOX},
+	{"kaiser", MIPMAP_FILTER_KAISER},
+};
+
+StringMap<ImageData::MipmapFilter, ImageData::MIPMAP_FILTER_MAX_ENUM> ImageData::mipmapFilters(ImageData::mipmapFilterEntries, sizeof(ImageData::mipmapFilterEntries));
+
 } // image
 } // love
@@ -55,6 +55,13 @@ public:
 
 	static love::Type type;
 
+	enum MipmapFilter
+	{
+		MIPMAP_FILTER_BOX,
+		MIPMAP_FILTER_KAISER,
+		MIPMAP_FILTER_MAX_ENUM
+	};
+
 	ImageData(Data *data);
 	ImageData(int width, int height, PixelFormat format = PIXELFORMAT_RGBA8);
 	ImageData(int width, int height, PixelFormat format, void *data, bool own);
@@ -103,6 +110,17 @@ public:
 	 **/
 	love::filesystem::FileData *encode(FormatHandler::EncodedFormat format, const char *filename, bool writefile) const;
 
+	/**
+	 * Generates the mipmap levels below this ImageData, down to 1x1. Each
+	 * level is filtered from the previous one in floating point.
+	 * @param filter The filter used to downsample each level.
+	 * @param linear Whether the color channels of RGBA8 and RGBA16 data are
+	 *        already linear. If false they're treated as sRGB, and converted
+	 *        to linear before filtering and back to sRGB afterward.
+	 * @return The mipmap levels, from largest to smallest.
+	 **/
+	std::vector<StrongRef<ImageData>> generateMipmaps(MipmapFilter filter, bool linear) const;
+
 	love::thread::Mutex *getMutex() const;
 
 	// Implements ImageDataBase.
@@ -119,6 +137,10 @@ public:
 	static bool getConstant(FormatHandler::EncodedFormat in, const char *&out);
 	static std::vector<std::string> getConstants(FormatHandler::EncodedFormat);
 
+	static bool getConstant(const char *in, MipmapFilter &out);
+	static bool getConstant(MipmapFilter in, const char *&out);
+	static std::vector<std::string> getConstants(MipmapFilter);
+
 private:
 
 	union Row
@@ -163,6 +185,9 @@ private:
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM>::Entry encodedFormatEntries[];
 	static StringMap<FormatHandler::EncodedFormat, FormatHandler::ENCODED_MAX_ENUM> encodedFormats;
 
+	static StringMap<MipmapFilter, MIPMAP_FILTER_MAX_ENUM>::Entry mipmapFilterEntries[];
+	static StringMap<MipmapFilter, MIPMAP_FILTER_MAX_ENUM> mipmapFilters;
+
 }; // ImageData
 
 } // image
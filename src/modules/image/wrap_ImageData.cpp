@@ -283,6 +283,39 @@ int w_ImageData_encode(lua_State *L)
 	return 1;
 }
 
+int w_ImageData_generateMipmaps(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1);
+
+	ImageData::MipmapFilter filter = ImageData::MIPMAP_FILTER_BOX;
+	if (!lua_isnoneornil(L, 2))
+	{
+		const char *str = luaL_checkstring(L, 2);
+		if (!ImageData::getConstant(str, filter))
+			return luax_enumerror(L, "mipmap filter", ImageData::getConstants(filter), str);
+	}
+
+	bool linear = luax_optboolean(L, 3, false);
+
+	std::vector<StrongRef<ImageData>> mipmaps;
+	luax_catchexcept(L, [&](){ mipmaps = t->generateMipmaps(filter, linear); });
+
+	// The base level comes first, so the table can be passed straight to
+	// love.graphics.newImage.
+	lua_createtable(L, (int) mipmaps.size() + 1, 0);
+
+	luax_pushtype(L, t);
+	lua_rawseti(L, -2, 1);
+
+	for (int i = 0; i < (int) mipmaps.size(); i++)
+	{
+		luax_pushtype(L, mipmaps[i].get());
+		lua_rawseti(L, -2, i + 2);
+	}
+
+	return 1;
+}
+
 int w_ImageData__performAtomic(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -344,6 +377,7 @@ static const luaL_Reg w_ImageData_functions[] =
 	{ "setPixel", w_ImageData_setPixel },
 	{ "paste", w_ImageData_paste },
 	{ "encode", w_ImageData_encode },
+	{ "generateMipmaps", w_ImageData_generateMipmaps },
 
 	// Used in the Lua wrapper code.
 	{ "_mapPixelUnsafe", w_ImageData__mapPixelUnsafe },
@@ -310,6 +310,14 @@ static int w__setGammaCorrect(lua_State *L)
 	return 0;
 }
 
+static int w__setShaderCacheEnabled(lua_State *L)
+{
+#ifdef LOVE_ENABLE_GRAPHICS
+	love::graphics::setShaderCacheEnabled((bool) lua_toboolean(L, 1));
+#endif
+	return 0;
+}
+
 static int w__setAudioMixWithSystem(lua_State *L)
 {
 	bool success = false;
@@ -380,6 +388,9 @@ int luaopen_love(lua_State *L)
 	lua_pushcfunction(L, w__setGammaCorrect);
 	lua_setfield(L, -2, "_setGammaCorrect");
 
+	lua_pushcfunction(L, w__setShaderCacheEnabled);
+	lua_setfield(L, -2, "_setShaderCacheEnabled");
+
 	// Exposed here because we need to be able to call it before the audio
 	// module is initialized.
 	lua_pushcfunction(L, w__setAudioMixWithSystem);
@@ -28,56 +28,513 @@
 
 // STL
 #include <cmath>
-#include <list>
+#include <algorithm>
+#include <set>
+#include <limits>
 #include <iostream>
 
 // C
 #include <time.h>
 
-using std::list;
 using love::Vector2;
 
 namespace
 {
 
-// check if an angle is oriented counter clockwise
-inline bool is_oriented_ccw(const Vector2 &a, const Vector2 &b, const Vector2 &c)
+/**
+ * Triangulates polygons with holes in O(n log n): a sweep line from top to
+ * bottom adds diagonals that split the polygon into y-monotone pieces, which
+ * are then triangulated in linear time. See chapter 3 of "Computational
+ * Geometry: Algorithms and Applications" by de Berg et al.
+ *
+ * Contours are made counter-clockwise (holes clockwise), so the interior is
+ * always to the left of an edge. Edge i goes from vertex i to next[i].
+ **/
+class MonotoneTriangulator
+{
+public:
+
+	MonotoneTriangulator(const std::vector<Vector2> &vertices, const std::vector<size_t> &holes);
+
+	void triangulate(std::vector<love::uint32> &indices);
+
+private:
+
+	enum VertexType
+	{
+		VERTEX_START,
+		VERTEX_END,
+		VERTEX_SPLIT,
+		VERTEX_MERGE,
+		VERTEX_REGULAR,
+	};
+
+	// Orders edges in the sweep status from left to right at the sweep line.
+	struct EdgeLess
+	{
+		const MonotoneTriangulator *t;
+		bool operator () (size_t a, size_t b) const;
+	};
+
+	typedef std::set<size_t, EdgeLess> Status;
+
+	// Stands for the current sweep vertex in status lookups.
+	static const size_t SWEEP_POINT = (size_t) -1;
+
+	bool isAbove(size_t a, size_t b) const;
+	double getXAtSweep(size_t edge) const;
+	double getDescentSlope(size_t edge) const;
+
+	void addContour(size_t start, size_t end, bool hole);
+	void addDiagonal(size_t a, size_t b);
+	size_t findLeftEdge(Status &status);
+
+	void findMonotonePieces();
+	void triangulateMonotone(std::vector<size_t> &piece, std::vector<love::uint32> &indices);
+
+	const std::vector<Vector2> &v;
+
+	std::vector<size_t> next;
+	std::vector<size_t> prev;
+
+	// Vertices that are part of a contour, sorted from top to bottom.
+	std::vector<size_t> sorted;
+
+	// Neighbors of each vertex through polygon edges and diagonals.
+	std::vector<std::vector<size_t>> neighbors;
+
+	int contourCount;
+
+	size_t sweepVertex;
+};
+
+const size_t MonotoneTriangulator::SWEEP_POINT;
+
+MonotoneTriangulator::MonotoneTriangulator(const std::vector<Vector2> &vertices, const std::vector<size_t> &holes)
+	: v(vertices)
+	, next(vertices.size(), SWEEP_POINT)
+	, prev(vertices.size(), SWEEP_POINT)
+	, neighbors(vertices.size())
+	, contourCount(0)
+	, sweepVertex(0)
 {
-	// return det(b-a, c-a) >= 0
-	return ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) >= 0;
+	size_t outline_end = holes.empty() ? vertices.size() : holes[0];
+	addContour(0, outline_end, false);
+
+	if (contourCount == 0)
+		throw love::Exception("Not a polygon");
+
+	for (size_t i = 0; i < holes.size(); i++)
+	{
+		size_t end = i + 1 < holes.size() ? holes[i + 1] : vertices.size();
+		if (holes[i] > end || end > vertices.size())
+			throw love::Exception("Invalid hole index: %d", (int) holes[i] + 1);
+
+		addContour(holes[i], end, true);
+	}
+
+	std::sort(sorted.begin(), sorted.end(), [this](size_t a, size_t b)
+	{
+		return isAbove(a, b);
+	});
 }
 
-// check if a and b are on the same side of the line c->d
-bool on_same_side(const Vector2 &a, const Vector2 &b, const Vector2 &c, const Vector2 &d)
+void MonotoneTriangulator::addContour(size_t start, size_t end, bool hole)
 {
-	float px = d.x - c.x, py = d.y - c.y;
-	// return det(p, a-c) * det(p, b-c) >= 0
-	float l = px * (a.y - c.y) - py * (a.x - c.x);
-	float m = px * (b.y - c.y) - py * (b.x - c.x);
-	return l * m >= 0;
+	// Skip repeated vertices, they would make zero-length edges.
+	std::vector<size_t> contour;
+	for (size_t i = start; i < end; i++)
+	{
+		if (contour.empty() || v[i] != v[contour.back()])
+			contour.push_back(i);
+	}
+
+	while (contour.size() > 1 && v[contour.back()] == v[contour.front()])
+		contour.pop_back();
+
+	if (contour.size() < 3)
+		return;
+
+	double area = 0.0;
+	for (size_t i = 0; i < contour.size(); i++)
+	{
+		const Vector2 &a = v[contour[i]];
+		const Vector2 &b = v[contour[(i + 1) % contour.size()]];
+		area += (double) a.x * b.y - (double) b.x * a.y;
+	}
+
+	if (hole == (area > 0.0))
+		std::reverse(contour.begin(), contour.end());
+
+	for (size_t i = 0; i < contour.size(); i++)
+	{
+		size_t a = contour[i];
+		size_t b = contour[(i + 1) % contour.size()];
+		next[a] = b;
+		prev[b] = a;
+		neighbors[a].push_back(b);
+		neighbors[b].push_back(a);
+		sorted.push_back(a);
+	}
+
+	contourCount++;
+}
+
+bool MonotoneTriangulator::isAbove(size_t a, size_t b) const
+{
+	if (v[a].y != v[b].y)
+		return v[a].y > v[b].y;
+	if (v[a].x != v[b].x)
+		return v[a].x < v[b].x;
+	return a < b;
+}
+
+double MonotoneTriangulator::getXAtSweep(size_t edge) const
+{
+	const Vector2 &s = v[sweepVertex];
+	const Vector2 &p = v[edge];
+	const Vector2 &q = v[next[edge]];
+
+	// Horizontal edges only contain the sweep line at their endpoints.
+	if (p.y == q.y)
+		return std::min(std::max(s.x, std::min(p.x, q.x)), std::max(p.x, q.x));
+
+	if (s.y == p.y)
+		return p.x;
+	if (s.y == q.y)
+		return q.x;
+
+	return p.x + ((double) s.y - p.y) * ((double) q.x - p.x) / ((double) q.y - p.y);
+}
+
+double MonotoneTriangulator::getDescentSlope(size_t edge) const
+{
+	size_t upper = edge;
+	size_t lower = next[edge];
+	if (isAbove(lower, upper))
+		std::swap(upper, lower);
+
+	// Horizontal edges go to the right, since vertices with the same y are
+	// ordered from left to right.
+	if (v[upper].y == v[lower].y)
+		return std::numeric_limits<double>::infinity();
+
+	return ((double) v[lower].x - v[upper].x) / ((double) v[upper].y - v[lower].y);
 }
 
-// checks is p is contained in the triangle abc
-inline bool point_in_triangle(const Vector2 &p, const Vector2 &a, const Vector2 &b, const Vector2 &c)
+bool MonotoneTriangulator::EdgeLess::operator () (size_t a, size_t b) const
 {
-	return on_same_side(p,a, b,c) && on_same_side(p,b, a,c) && on_same_side(p,c, a,b);
+	if (a == b)
+		return false;
+
+	if (a == SWEEP_POINT)
+		return (double) t->v[t->sweepVertex].x <= t->getXAtSweep(b);
+	if (b == SWEEP_POINT)
+		return t->getXAtSweep(a) < (double) t->v[t->sweepVertex].x;
+
+	double xa = t->getXAtSweep(a);
+	double xb = t->getXAtSweep(b);
+	if (xa != xb)
+		return xa < xb;
+
+	// Edges which meet at the sweep line are ordered by where they go.
+	double sa = t->getDescentSlope(a);
+	double sb = t->getDescentSlope(b);
+	if (sa != sb)
+		return sa < sb;
+
+	return a < b;
+}
+
+void MonotoneTriangulator::addDiagonal(size_t a, size_t b)
+{
+	neighbors[a].push_back(b);
+	neighbors[b].push_back(a);
+}
+
+size_t MonotoneTriangulator::findLeftEdge(Status &status)
+{
+	auto it = status.lower_bound(SWEEP_POINT);
+	if (it == status.begin())
+		throw love::Exception("Cannot triangulate polygon.");
+
+	return *(--it);
+}
+
+void MonotoneTriangulator::findMonotonePieces()
+{
+	Status status(EdgeLess {this});
+	std::vector<Status::iterator> statusedges(v.size(), status.end());
+	std::vector<size_t> helper(v.size(), SWEEP_POINT);
+	std::vector<VertexType> types(v.size(), VERTEX_REGULAR);
+
+	auto removeEdge = [&](size_t edge)
+	{
+		if (statusedges[edge] == status.end())
+			throw love::Exception("Cannot triangulate polygon.");
+
+		status.erase(statusedges[edge]);
+		statusedges[edge] = status.end();
+	};
+
+	auto insertEdge = [&](size_t edge, size_t helpervertex)
+	{
+		statusedges[edge] = status.insert(edge).first;
+		helper[edge] = helpervertex;
+	};
+
+	auto connectMergeHelper = [&](size_t vertex, size_t edge)
+	{
+		if (helper[edge] != SWEEP_POINT && types[helper[edge]] == VERTEX_MERGE)
+			addDiagonal(vertex, helper[edge]);
+	};
+
+	for (size_t i : sorted)
+	{
+		sweepVertex = i;
+
+		size_t p = prev[i];
+		size_t n = next[i];
+
+		bool prevabove = isAbove(p, i);
+		bool nextabove = isAbove(n, i);
+
+		const Vector2 &a = v[p];
+		const Vector2 &b = v[i];
+		const Vector2 &c = v[n];
+		double turn = ((double) b.x - a.x) * ((double) c.y - b.y) - ((double) b.y - a.y) * ((double) c.x - b.x);
+		bool convex = turn >= 0.0;
+
+		if (!prevabove && !nextabove)
+			types[i] = convex ? VERTEX_START : VERTEX_SPLIT;
+		else if (prevabove && nextabove)
+			types[i] = convex ? VERTEX_END : VERTEX_MERGE;
+		else
+			types[i] = VERTEX_REGULAR;
+
+		switch (types[i])
+		{
+		case VERTEX_START:
+			insertEdge(i, i);
+			break;
+		case VERTEX_END:
+			connectMergeHelper(i, p);
+			removeEdge(p);
+			break;
+		case VERTEX_SPLIT:
+		{
+			size_t left = findLeftEdge(status);
+			addDiagonal(i, helper[left]);
+			helper[left] = i;
+			insertEdge(i, i);
+			break;
+		}
+		case VERTEX_MERGE:
+		{
+			connectMergeHelper(i, p);
+			removeEdge(p);
+			size_t left = findLeftEdge(status);
+			connectMergeHelper(i, left);
+			helper[left] = i;
+			break;
+		}
+		case VERTEX_REGULAR:
+			if (prevabove)
+			{
+				// The interior is to the right of this vertex.
+				connectMergeHelper(i, p);
+				removeEdge(p);
+				insertEdge(i, i);
+			}
+			else
+			{
+				size_t left = findLeftEdge(status);
+				connectMergeHelper(i, left);
+				helper[left] = i;
+			}
+			break;
+		}
+	}
 }
 
-// checks if any vertex in `vertices' is in the triangle abc.
-bool any_point_in_triangle(const std::list<const Vector2 *> &vertices, const Vector2 &a, const Vector2 &b, const Vector2 &c)
+void MonotoneTriangulator::triangulateMonotone(std::vector<size_t> &piece, std::vector<love::uint32> &indices)
 {
-	for (const Vector2 *p : vertices)
+	auto addTriangle = [&](size_t a, size_t b, size_t c)
+	{
+		// Keep every triangle counter-clockwise.
+		double area = ((double) v[b].x - v[a].x) * ((double) v[c].y - v[a].y) - ((double) v[b].y - v[a].y) * ((double) v[c].x - v[a].x);
+		if (area < 0.0)
+			std::swap(b, c);
+
+		indices.push_back((love::uint32) a);
+		indices.push_back((love::uint32) b);
+		indices.push_back((love::uint32) c);
+	};
+
+	size_t count = piece.size();
+
+	if (count == 3)
+	{
+		addTriangle(piece[0], piece[1], piece[2]);
+		return;
+	}
+
+	// The piece is counter-clockwise, so the vertices following the top one
+	// form the left chain, down to the bottom vertex.
+	size_t top = 0;
+	size_t bottom = 0;
+	for (size_t i = 1; i < count; i++)
+	{
+		if (isAbove(piece[i], piece[top]))
+			top = i;
+		if (isAbove(piece[bottom], piece[i]))
+			bottom = i;
+	}
+
+	std::vector<std::pair<size_t, bool>> chain;
+	chain.reserve(count);
+
+	for (size_t i = top; i != bottom; i = (i + 1) % count)
+		chain.push_back(std::make_pair(piece[i], true));
+
+	for (size_t i = bottom; i != top; i = (i + 1) % count)
+		chain.push_back(std::make_pair(piece[i], false));
+
+	// Both chains are already sorted, so sorting the piece is a merge.
+	std::vector<std::pair<size_t, bool>> u(count);
+	size_t leftcount = (bottom + count - top) % count;
+	std::merge(chain.begin(), chain.begin() + leftcount, chain.rbegin(), chain.rend() - leftcount, u.begin(),
+		[this](const std::pair<size_t, bool> &a, const std::pair<size_t, bool> &b)
+	{
+		return isAbove(a.first, b.first);
+	});
+
+	std::vector<std::pair<size_t, bool>> stack;
+	stack.reserve(count);
+	stack.push_back(u[0]);
+	stack.push_back(u[1]);
+
+	for (size_t j = 2; j + 1 < count; j++)
 	{
-		if ((p != &a) && (p != &b) && (p != &c) && point_in_triangle(*p, a,b,c)) // oh god...
-			return true;
+		if (u[j].second != stack.back().second)
+		{
+			for (size_t k = 0; k + 1 < stack.size(); k++)
+				addTriangle(u[j].first, stack[k].first, stack[k + 1].first);
+
+			stack.clear();
+			stack.push_back(u[j - 1]);
+			stack.push_back(u[j]);
+		}
+		else
+		{
+			std::pair<size_t, bool> last = stack.back();
+			stack.pop_back();
+
+			while (!stack.empty())
+			{
+				const Vector2 &s = v[stack.back().first];
+				const Vector2 &l = v[last.first];
+				const Vector2 &c = v[u[j].first];
+				double turn = ((double) l.x - s.x) * ((double) c.y - l.y) - ((double) l.y - s.y) * ((double) c.x - l.x);
+
+				// The diagonal is inside if the chain turns towards the interior.
+				if (u[j].second ? turn <= 0.0 : turn >= 0.0)
+					break;
+
+				addTriangle(u[j].first, last.first, stack.back().first);
+				last = stack.back();
+				stack.pop_back();
+			}
+
+			stack.push_back(last);
+			stack.push_back(u[j]);
+		}
 	}
 
-	return false;
+	for (size_t k = 0; k + 1 < stack.size(); k++)
+		addTriangle(u[count - 1].first, stack[k].first, stack[k + 1].first);
 }
 
-inline bool is_ear(const Vector2 &a, const Vector2 &b, const Vector2 &c, const std::list<const Vector2 *> &vertices)
+void MonotoneTriangulator::triangulate(std::vector<love::uint32> &indices)
 {
-	return is_oriented_ccw(a,b,c) && !any_point_in_triangle(vertices, a,b,c);
+	findMonotonePieces();
+
+	// Sort the neighbors of each vertex by angle, so the pieces can be found
+	// by always taking the next edge clockwise from the incoming one.
+	std::vector<std::vector<bool>> visited(v.size());
+	std::vector<std::pair<double, size_t>> angles;
+	size_t halfedges = 0;
+
+	for (size_t i : sorted)
+	{
+		std::vector<size_t> &n = neighbors[i];
+		const Vector2 &center = v[i];
+
+		angles.clear();
+		for (size_t k : n)
+			angles.push_back(std::make_pair(atan2(v[k].y - center.y, v[k].x - center.x), k));
+
+		std::sort(angles.begin(), angles.end());
+		angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+
+		n.clear();
+		for (const auto &angle : angles)
+			n.push_back(angle.second);
+
+		// Edges going against the contour would walk around the outside.
+		visited[i].assign(n.size(), false);
+		for (size_t k = 0; k < n.size(); k++)
+		{
+			if (n[k] == prev[i])
+				visited[i][k] = true;
+			else
+				halfedges++;
+		}
+	}
+
+	size_t expected = sorted.size() + 2 * (contourCount - 1) - 2;
+	indices.reserve(indices.size() + expected * 3);
+
+	size_t firstindex = indices.size();
+	std::vector<size_t> piece;
+
+	for (size_t i : sorted)
+	{
+		for (size_t k = 0; k < neighbors[i].size(); k++)
+		{
+			if (visited[i][k])
+				continue;
+
+			piece.clear();
+
+			size_t from = i;
+			size_t edge = k;
+
+			while (!visited[from][edge])
+			{
+				visited[from][edge] = true;
+				piece.push_back(from);
+
+				if (piece.size() > halfedges)
+					throw love::Exception("Cannot triangulate polygon.");
+
+				size_t to = neighbors[from][edge];
+				const std::vector<size_t> &n = neighbors[to];
+
+				size_t back = std::find(n.begin(), n.end(), from) - n.begin();
+				edge = (back + n.size() - 1) % n.size();
+				from = to;
+			}
+
+			if (piece.size() < 3 || from != i || edge != k)
+				throw love::Exception("Cannot triangulate polygon.");
+
+			triangulateMonotone(piece, indices);
+		}
+	}
+
+	if (indices.size() - firstindex != expected * 3)
+		throw love::Exception("Cannot triangulate polygon.");
 }
 
 } // anonymous namespace
@@ -87,6 +544,15 @@ namespace love
 namespace math
 {
 
+void triangulate(const std::vector<love::Vector2> &vertices, const std::vector<size_t> &holes, std::vector<uint32> &indices)
+{
+	if (vertices.size() < 3)
+		throw love::Exception("Not a polygon");
+
+	MonotoneTriangulator triangulator(vertices, holes);
+	triangulator.triangulate(indices);
+}
+
 std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
 {
 	if (polygon.size() < 3)
@@ -94,60 +560,14 @@ std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
 	else if (polygon.size() == 3)
 		return std::vector<Triangle>(1, Triangle(polygon[0], polygon[1], polygon[2]));
 
-	// collect list of connections and record leftmost item to check if the polygon
-	// has the expected winding
-	std::vector<size_t> next_idx(polygon.size()), prev_idx(polygon.size());
-	size_t idx_lm = 0;
-	for (size_t i = 0; i < polygon.size(); ++i)
-	{
-		const love::Vector2 &lm = polygon[idx_lm], &p = polygon[i];
-		if (p.x < lm.x || (p.x == lm.x && p.y < lm.y))
-			idx_lm = i;
-		next_idx[i] = i+1;
-		prev_idx[i] = i-1;
-	}
-	next_idx[next_idx.size()-1] = 0;
-	prev_idx[0] = prev_idx.size()-1;
+	std::vector<uint32> indices;
+	triangulate(polygon, std::vector<size_t>(), indices);
 
-	// check if the polygon has the expected winding and reverse polygon if needed
-	if (!is_oriented_ccw(polygon[prev_idx[idx_lm]], polygon[idx_lm], polygon[next_idx[idx_lm]]))
-		next_idx.swap(prev_idx);
-
-	// collect list of concave polygons
-	std::list<const love::Vector2 *> concave_vertices;
-	for (size_t i = 0; i < polygon.size(); ++i)
-	{
-		if (!is_oriented_ccw(polygon[prev_idx[i]], polygon[i], polygon[next_idx[i]]))
-			concave_vertices.push_back(&polygon[i]);
-	}
-
-	// triangulation according to kong
 	std::vector<Triangle> triangles;
-	size_t n_vertices = polygon.size();
-	size_t current = 1, skipped = 0, next, prev;
-	while (n_vertices > 3)
-	{
-		next = next_idx[current];
-		prev = prev_idx[current];
-		const Vector2 &a = polygon[prev], &b = polygon[current], &c = polygon[next];
-		if (is_ear(a,b,c, concave_vertices))
-		{
-			triangles.push_back(Triangle(a,b,c));
-			next_idx[prev] = next;
-			prev_idx[next] = prev;
-			concave_vertices.remove(&b);
-			--n_vertices;
-			skipped = 0;
-		}
-		else if (++skipped > n_vertices)
-		{
-			throw love::Exception("Cannot triangulate polygon.");
-		}
-		current = next;
-	}
-	next = next_idx[current];
-	prev = prev_idx[current];
-	triangles.push_back(Triangle(polygon[prev], polygon[current], polygon[next]));
+	triangles.reserve(indices.size() / 3);
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		triangles.push_back(Triangle(polygon[indices[i]], polygon[indices[i + 1]], polygon[indices[i + 2]]));
 
 	return triangles;
 }
@@ -60,6 +60,16 @@ struct Triangle
  **/
 std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon);
 
+/**
+ * Triangulate a polygon with holes.
+ *
+ * @param vertices The vertices of the polygon's outline, followed by the
+ *        vertices of each hole. Outlines must not intersect.
+ * @param holes The index of the first vertex of each hole, in increasing order.
+ * @param[out] indices Three vertex indices per triangle are appended to this.
+ **/
+void triangulate(const std::vector<love::Vector2> &vertices, const std::vector<size_t> &holes, std::vector<uint32> &indices);
+
 /**
  * Checks whether a polygon is convex.
  *
@@ -152,21 +152,33 @@ int w_newTransform(lua_State *L)
 int w_triangulate(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
+	std::vector<size_t> holes;
+
 	if (lua_istable(L, 1))
 	{
-		int top = (int) luax_objlen(L, 1);
-		vertices.reserve(top / 2);
-		for (int i = 1; i <= top; i += 2)
+		// Any tables after the polygon are holes in it.
+		int args = std::max(lua_gettop(L), 1);
+		for (int arg = 1; arg <= args; arg++)
 		{
-			lua_rawgeti(L, 1, i);
-			lua_rawgeti(L, 1, i+1);
+			luaL_checktype(L, arg, LUA_TTABLE);
 
-			Vector2 v;
-			v.x = (float) luaL_checknumber(L, -2);
-			v.y = (float) luaL_checknumber(L, -1);
-			vertices.push_back(v);
+			if (arg > 1)
+				holes.push_back(vertices.size());
 
-			lua_pop(L, 2);
+			int top = (int) luax_objlen(L, arg);
+			vertices.reserve(vertices.size() + top / 2);
+			for (int i = 1; i <= top; i += 2)
+			{
+				lua_rawgeti(L, arg, i);
+				lua_rawgeti(L, arg, i+1);
+
+				Vector2 v;
+				v.x = (float) luaL_checknumber(L, -2);
+				v.y = (float) luaL_checknumber(L, -1);
+				vertices.push_back(v);
+
+				lua_pop(L, 2);
+			}
 		}
 	}
 	else
@@ -190,8 +202,17 @@ int w_triangulate(lua_State *L)
 	luax_catchexcept(L, [&]() {
 		if (vertices.size() == 3)
 			triangles.push_back(Triangle(vertices[0], vertices[1], vertices[2]));
-		else
+		else if (holes.empty())
 			triangles = triangulate(vertices);
+		else
+		{
+			std::vector<uint32> indices;
+			triangulate(vertices, holes, indices);
+
+			triangles.reserve(indices.size() / 3);
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+				triangles.push_back(Triangle(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]));
+		}
 	});
 
 	lua_createtable(L, (int) triangles.size(), 0);
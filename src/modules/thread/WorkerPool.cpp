@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "WorkerPool.h"
+
+// C++
+#include <algorithm>
+#include <thread>
+
+namespace love
+{
+namespace thread
+{
+
+WorkerPool::Worker::Worker(WorkerPool *pool)
+	: pool(pool)
+{
+	threadName = "WorkerPool";
+}
+
+void WorkerPool::Worker::threadFunction()
+{
+	Lock lock(pool->mutex);
+
+	while (true)
+	{
+		bool hasrange = pool->func != nullptr && pool->nextStart < pool->count;
+
+		while (!pool->stopping && !hasrange && pool->tasks.empty())
+		{
+			pool->workCond->wait(pool->mutex);
+			hasrange = pool->func != nullptr && pool->nextStart < pool->count;
+		}
+
+		if (pool->stopping)
+			return;
+
+		// Loops are waited on by another thread, so they come first.
+		if (hasrange)
+			pool->runRanges();
+		else
+		{
+			Task task = std::move(pool->tasks.front());
+			pool->tasks.pop_front();
+
+			pool->runningTasks++;
+
+			pool->mutex->unlock();
+			task();
+			pool->mutex->lock();
+
+			if (--pool->runningTasks == 0 && pool->tasks.empty())
+				pool->doneCond->broadcast();
+		}
+	}
+}
+
+WorkerPool::WorkerPool(int numthreads)
+	: runningTasks(0)
+	, func(nullptr)
+	, count(0)
+	, grainSize(1)
+	, nextStart(0)
+	, rangesRemaining(0)
+	, stopping(false)
+{
+	if (numthreads < 0)
+		numthreads = std::max((int) std::thread::hardware_concurrency() - 1, 0);
+
+	for (int i = 0; i < numthreads; i++)
+	{
+		Worker *worker = new Worker(this);
+
+		if (!worker->start())
+		{
+			delete worker;
+			break;
+		}
+
+		workers.push_back(worker);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		Lock lock(mutex);
+		stopping = true;
+		workCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+}
+
+int WorkerPool::getWorkerCount() const
+{
+	return (int) workers.size();
+}
+
+void WorkerPool::parallelFor(int count, int grainsize, const RangeFunction &func)
+{
+	if (count <= 0)
+		return;
+
+	grainsize = std::max(grainsize, 1);
+
+	// Not worth waking up other threads for.
+	if (workers.empty() || count <= grainsize)
+	{
+		func(0, count);
+		return;
+	}
+
+	Lock looplock(loopMutex);
+	Lock lock(mutex);
+
+	this->func = &func;
+	this->count = count;
+	this->grainSize = grainsize;
+	nextStart = 0;
+	rangesRemaining = (count + grainsize - 1) / grainsize;
+
+	workCond->broadcast();
+
+	runRanges();
+
+	while (rangesRemaining > 0)
+		doneCond->wait(mutex);
+
+	this->func = nullptr;
+}
+
+void WorkerPool::submit(const Task &task)
+{
+	if (workers.empty())
+	{
+		task();
+		return;
+	}
+
+	Lock lock(mutex);
+
+	tasks.push_back(task);
+	workCond->signal();
+}
+
+void WorkerPool::waitForTasks()
+{
+	Lock lock(mutex);
+
+	while (!tasks.empty() || runningTasks > 0)
+		doneCond->wait(mutex);
+}
+
+void WorkerPool::runRanges()
+{
+	const RangeFunction *f = func;
+
+	while (f != nullptr && nextStart < count)
+	{
+		int start = nextStart;
+		int end = std::min(start + grainSize, count);
+		nextStart = end;
+
+		mutex->unlock();
+		(*f)(start, end);
+		mutex->lock();
+
+		if (--rangesRemaining == 0)
+			doneCond->broadcast();
+	}
+}
+
+} // thread
+} // love
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2006-2019 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_WORKER_POOL_H
+#define LOVE_THREAD_WORKER_POOL_H
+
+// LOVE
+#include "threads.h"
+
+// C++
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A fixed set of worker threads which split data-parallel loops between
+ * them. The thread which starts a loop also processes part of it. Workers
+ * which aren't needed for a loop run queued background tasks.
+ **/
+class WorkerPool
+{
+public:
+
+	typedef std::function<void(int start, int end)> RangeFunction;
+	typedef std::function<void()> Task;
+
+	/**
+	 * @param numthreads The number of worker threads to create, or -1 to use
+	 * one fewer than the number of logical CPU cores.
+	 **/
+	WorkerPool(int numthreads = -1);
+	~WorkerPool();
+
+	int getWorkerCount() const;
+
+	/**
+	 * Calls func on consecutive sub-ranges of [0, count), each at most
+	 * grainsize elements long. Sub-ranges may run concurrently, so func must
+	 * only touch data belonging to its own range, and must not throw.
+	 * Returns once every sub-range has been processed.
+	 **/
+	void parallelFor(int count, int grainsize, const RangeFunction &func);
+
+	/**
+	 * Queues a function to be called on a worker thread, without waiting for
+	 * it. Tasks start in the order they were submitted, and must not throw.
+	 * If there are no worker threads the function is called right away.
+	 * Tasks which haven't started when the pool is destroyed never run.
+	 **/
+	void submit(const Task &task);
+
+	/**
+	 * Blocks until every submitted task has finished running.
+	 **/
+	void waitForTasks();
+
+private:
+
+	class Worker : public Threadable
+	{
+	public:
+
+		Worker(WorkerPool *pool);
+		virtual ~Worker() {}
+
+		// Implements Threadable.
+		void threadFunction() override;
+
+	private:
+
+		WorkerPool *pool;
+	};
+
+	// Runs sub-ranges of the current loop until none are left. The mutex
+	// must be locked by the caller, and is still locked on return.
+	void runRanges();
+
+	std::vector<Worker *> workers;
+
+	// Serializes parallelFor calls from different threads.
+	MutexRef loopMutex;
+
+	MutexRef mutex;
+	ConditionalRef workCond;
+	ConditionalRef doneCond;
+
+	std::deque<Task> tasks;
+	int runningTasks;
+
+	const RangeFunction *func;
+	int count;
+	int grainSize;
+	int nextStart;
+	int rangesRemaining;
+
+	bool stopping;
+
+}; // WorkerPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_WORKER_POOL_H
@@ -431,6 +431,7 @@ function love.init()
 		externalstorage = false, -- Only relevant for Android.
 		accelerometerjoystick = true, -- Only relevant for Android / iOS.
 		gammacorrect = false,
+		shadercache = false,
 	}
 
 	-- Console hack, part 1.
@@ -468,6 +469,10 @@ function love.init()
 		love._setGammaCorrect(c.gammacorrect)
 	end
 
+	if love._setShaderCacheEnabled then
+		love._setShaderCacheEnabled(c.shadercache)
+	end
+
 	if love._setAudioMixWithSystem and c.audio then
 		love._setAudioMixWithSystem(c.audio.mixwithsystem)
 	end